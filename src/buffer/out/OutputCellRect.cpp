@@ -15,65 +15,50 @@ OutputCellRect::OutputCellRect() noexcept :
 
 // Routine Description:
 // - Constructs an in-memory region for holding a copy of output buffer cell data.
-// - NOTE: This creatively skips the constructors for every cell. You must fill
-//   every single cell in this rectangle before iterating/reading for it to be valid.
-// - NOTE: This is designed for perf-sensitive paths ONLY. Take care.
+// - Every cell starts out as whitespace with the given attributes.
 // Arguments:
 // - rows - Rows in the rectangle (height)
 // - cols - Columns in the rectangle (width)
-OutputCellRect::OutputCellRect(const til::CoordType rows, const til::CoordType cols) :
+// - fillAttributes - The attributes of the initial whitespace
+OutputCellRect::OutputCellRect(const til::CoordType rows, const til::CoordType cols, const TextAttribute& fillAttributes) :
     _rows(rows),
     _cols(cols)
 {
-    _storage.resize(gsl::narrow<size_t>(rows * cols));
-}
+    const auto height = gsl::narrow<size_t>(rows);
+    const auto width = gsl::narrow<uint16_t>(cols);
+    // ROW stores 1 more char offset than it's wide (the past-the-end offset).
+    const auto offsetsStride = ::base::strict_cast<size_t>(width) + 1u;
 
-// Routine Description:
-// - Gets a read/write span over a single row inside the rectangle.
-// Arguments:
-// - row - The Y position or row index in the buffer.
-// Return Value:
-// - Read/write span of OutputCells
-gsl::span<OutputCell> OutputCellRect::GetRow(const til::CoordType row)
-{
-    return gsl::span<OutputCell>(_FindRowOffset(row), _cols);
-}
-
-// Routine Description:
-// - Gets a read-only iterator view over a single row of the rectangle.
-// Arguments:
-// - row - The Y position or row index in the buffer.
-// Return Value:
-// - Read-only iterator of OutputCells
-OutputCellIterator OutputCellRect::GetRowIter(const til::CoordType row) const
-{
-    const gsl::span<const OutputCell> view(_FindRowOffset(row), _cols);
+    _chars = std::make_unique_for_overwrite<wchar_t[]>(height * width);
+    _charOffsets = std::make_unique_for_overwrite<uint16_t[]>(height * offsetsStride);
+    _storage.reserve(height);
 
-    return OutputCellIterator(view);
+    for (size_t i = 0; i < height; ++i)
+    {
+        _storage.emplace_back(_chars.get() + i * width, _charOffsets.get() + i * offsetsStride, width, fillAttributes);
+    }
 }
 
 // Routine Description:
-// - Internal helper to find the pointer to the specific row offset in the giant
-//   contiguous block of memory allocated for this rectangle.
+// - Gets a single row inside the rectangle.
 // Arguments:
 // - row - The Y position or row index in the buffer.
 // Return Value:
-// - Pointer to the location in the rectangle that represents the start of the requested row.
-OutputCell* OutputCellRect::_FindRowOffset(const til::CoordType row)
+// - The row.
+ROW& OutputCellRect::GetRow(const til::CoordType row)
 {
-    return &_storage.at(gsl::narrow_cast<size_t>(row * _cols));
+    return _storage.at(gsl::narrow_cast<size_t>(row));
 }
 
 // Routine Description:
-// - Internal helper to find the pointer to the specific row offset in the giant
-//   contiguous block of memory allocated for this rectangle.
+// - Gets a single row inside the rectangle.
 // Arguments:
 // - row - The Y position or row index in the buffer.
 // Return Value:
-// - Pointer to the location in the rectangle that represents the start of the requested row.
-const OutputCell* OutputCellRect::_FindRowOffset(const til::CoordType row) const
+// - The row.
+const ROW& OutputCellRect::GetRow(const til::CoordType row) const
 {
-    return &_storage.at(gsl::narrow_cast<size_t>(row * _cols));
+    return _storage.at(gsl::narrow_cast<size_t>(row));
 }
 
 // Routine Description:
@@ -8,6 +8,8 @@ Module Name:
 Abstract:
 - Designed to hold a rectangular area of OutputCells where the column/row count is known ahead of time.
 - This is done for performance reasons (one big heap allocation block with appropriate views instead of tiny allocations.)
+- Each row of the rectangle is a ROW, using the same packed layout of chars, char offsets and attribute runs that
+  the TextBuffer uses. This allows copying rows in and out of the TextBuffer in bulk via ROW::CopyTextFrom().
 - NOTE: For cases where the internal buffer will not change during your call, use Iterators and Views to completely
         avoid any copy or allocate at all. Only use this when a copy of your content or the buffer is needed.
 
@@ -16,33 +18,32 @@ Author:
 
 Revision History:
 - Based on work from OutputCell.hpp/cpp by Austin Diviness (AustDi)
+- Rows are stored as ROWs instead of one OutputCell per cell.
 
 --*/
 
 #pragma once
 
-#include "DbcsAttribute.hpp"
-#include "TextAttribute.hpp"
-#include "OutputCell.hpp"
-#include "OutputCellIterator.hpp"
+#include "Row.hpp"
 
 class OutputCellRect final
 {
 public:
     OutputCellRect() noexcept;
-    OutputCellRect(const til::CoordType rows, const til::CoordType cols);
+    OutputCellRect(const til::CoordType rows, const til::CoordType cols, const TextAttribute& fillAttributes);
 
-    gsl::span<OutputCell> GetRow(const til::CoordType row);
-    OutputCellIterator GetRowIter(const til::CoordType row) const;
+    ROW& GetRow(const til::CoordType row);
+    const ROW& GetRow(const til::CoordType row) const;
 
     til::CoordType Height() const noexcept;
     til::CoordType Width() const noexcept;
 
 private:
-    std::vector<OutputCell> _storage;
-
-    OutputCell* _FindRowOffset(const til::CoordType row);
-    const OutputCell* _FindRowOffset(const til::CoordType row) const;
+    // The backing stores for the chars and char offsets of all rows, in the same layout TextBuffer uses.
+    // A row only allocates memory on its own if it holds more characters than it's wide.
+    std::unique_ptr<wchar_t[]> _chars;
+    std::unique_ptr<uint16_t[]> _charOffsets;
+    std::vector<ROW> _storage;
 
     til::CoordType _cols;
     til::CoordType _rows;
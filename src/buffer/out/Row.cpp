@@ -5,6 +5,8 @@
 #include "Row.hpp"
 
 #include "textBuffer.hpp"
+#include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/Utf16Parser.hpp"
 
 // The STL is missing a std::iota_n analogue for std::iota, so I made my own.
 template<typename OutIt, typename Diff, typename T>
@@ -92,10 +94,12 @@ void swap(ROW& lhs, ROW& rhs) noexcept
     std::swap(lhs._chars, rhs._chars);
     std::swap(lhs._charOffsets, rhs._charOffsets);
     std::swap(lhs._attr, rhs._attr);
+    std::swap(lhs._compressed, rhs._compressed);
     std::swap(lhs._columnCount, rhs._columnCount);
     std::swap(lhs._lineRendition, rhs._lineRendition);
     std::swap(lhs._wrapForced, rhs._wrapForced);
     std::swap(lhs._doubleBytePadded, rhs._doubleBytePadded);
+    std::swap(lhs._revision, rhs._revision);
 }
 
 void ROW::SetWrapForced(const bool wrap) noexcept
@@ -128,6 +132,16 @@ LineRendition ROW::GetLineRendition() const noexcept
     return _lineRendition;
 }
 
+void ROW::SetRevision(const uint64_t revision) noexcept
+{
+    _revision = revision;
+}
+
+uint64_t ROW::GetRevision() const noexcept
+{
+    return _revision;
+}
+
 // Routine Description:
 // - Sets all properties of the ROW to default values
 // Arguments:
@@ -229,6 +243,191 @@ void ROW::TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& a
     _attr.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
 }
 
+// A compressed row is stored as a single blob, laid out like this:
+//   CompressedRowHeader
+//   uint16_t charOffsets[columnCount] (only if CompressedRowFlags::HasCharOffsets is set)
+//   char/wchar_t text[charCount] (char if CompressedRowFlags::Ascii is set)
+// The header only covers the columns up to the last one that isn't a plain space.
+// The remaining columns of the row are implied to be spaces, 1 char per column.
+namespace
+{
+    enum CompressedRowFlags : uint16_t
+    {
+        Ascii = 0x1,
+        HasCharOffsets = 0x2,
+    };
+
+    struct CompressedRowHeader
+    {
+        uint16_t columnCount;
+        uint16_t charCount;
+        uint16_t flags;
+    };
+}
+
+bool ROW::IsCompressed() const noexcept
+{
+    return _compressed != nullptr;
+}
+
+// Routine Description:
+// - Packs the contents of this row into a compact blob and releases its chars and charOffsets
+//   buffers. Until Expand() is called, only the attributes and row flags remain accessible.
+// - Trailing whitespace is elided, _charOffsets are omitted if every glyph is 1 column and
+//   1 char wide, and text that's pure ASCII is stored as 1 byte per char.
+// Return Value:
+// - The _charsBuffer this row was using, which the caller may now reuse,
+//   or nullptr if the row was already compressed or never had a buffer.
+wchar_t* ROW::Compress()
+{
+    if (!_charsBuffer)
+    {
+        return nullptr;
+    }
+
+    // Strip off trailing columns that contain nothing but a plain, 1 char wide space.
+    uint16_t columnCount = _columnCount;
+    for (; columnCount != 0; --columnCount)
+    {
+        const auto col = columnCount - 1u;
+        const auto off = _uncheckedCharOffset(col);
+        if (_uncheckedIsTrailer(col) || _uncheckedCharOffset(col + 1) != off + 1 || _uncheckedChar(off) != L' ')
+        {
+            break;
+        }
+    }
+
+    const auto charCount = _uncheckedCharOffset(columnCount);
+    const std::span chars{ _chars.data(), charCount };
+
+    auto hasCharOffsets = charCount != columnCount;
+    for (uint16_t i = 0; !hasCharOffsets && i < columnCount; ++i)
+    {
+        hasCharOffsets = til::at(_charOffsets, i) != i;
+    }
+
+    const auto ascii = std::all_of(chars.begin(), chars.end(), [](wchar_t ch) noexcept { return ch < 0x80; });
+
+    const auto charOffsetsBytes = hasCharOffsets ? columnCount * sizeof(uint16_t) : 0u;
+    const auto textBytes = charCount * (ascii ? sizeof(char) : sizeof(wchar_t));
+    auto compressed = std::make_unique_for_overwrite<std::byte[]>(sizeof(CompressedRowHeader) + charOffsetsBytes + textBytes);
+
+    CompressedRowHeader header{};
+    header.columnCount = columnCount;
+    header.charCount = charCount;
+    header.flags = gsl::narrow_cast<uint16_t>((ascii ? Ascii : 0) | (hasCharOffsets ? HasCharOffsets : 0));
+
+    auto dst = compressed.get();
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    memcpy(dst, _charOffsets.data(), charOffsetsBytes);
+    dst += charOffsetsBytes;
+    if (ascii)
+    {
+        std::transform(chars.begin(), chars.end(), dst, [](wchar_t ch) noexcept { return static_cast<std::byte>(ch); });
+    }
+    else
+    {
+        memcpy(dst, chars.data(), textBytes);
+    }
+
+    _compressed = std::move(compressed);
+    _charsHeap.reset();
+    _chars = {};
+    _charOffsets = {};
+    return std::exchange(_charsBuffer, nullptr);
+}
+
+// Routine Description:
+// - Restores the contents of a row that was compressed with Compress().
+// Arguments:
+// - charsBuffer - a new backing buffer to use for _charsBuffer
+// - charOffsetsBuffer - a new backing buffer to use for _charOffsets
+void ROW::Expand(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer)
+{
+    if (!_compressed)
+    {
+        return;
+    }
+
+    _decompressInto(*this, charsBuffer, charOffsetsBuffer);
+    _compressed.reset();
+}
+
+// Routine Description:
+// - Turns the target into an uncompressed copy of this compressed row, leaving this row as it is.
+// Arguments:
+// - target - the row to copy into
+// - charsBuffer - a buffer of at least size() characters to use for the target's _charsBuffer
+// - charOffsetsBuffer - a buffer of at least size() + 1 items to use for the target's _charOffsets
+void ROW::ExpandInto(ROW& target, wchar_t* charsBuffer, uint16_t* charOffsetsBuffer) const
+{
+    THROW_HR_IF(E_UNEXPECTED, !_compressed || &target == this);
+
+    target._attr = _attr;
+    target._columnCount = _columnCount;
+    target._compressed.reset();
+    target._lineRendition = _lineRendition;
+    target._wrapForced = _wrapForced;
+    target._doubleBytePadded = _doubleBytePadded;
+    target._revision = _revision;
+    _decompressInto(target, charsBuffer, charOffsetsBuffer);
+}
+
+// Routine Description:
+// - Decodes the _compressed blob of this row into the given buffers and makes them the target's
+//   _chars and _charOffsets. The target's _columnCount must be equal to this row's.
+void ROW::_decompressInto(ROW& target, wchar_t* charsBuffer, uint16_t* charOffsetsBuffer) const
+{
+    CompressedRowHeader header;
+    auto src = _compressed.get();
+    memcpy(&header, src, sizeof(header));
+    src += sizeof(header);
+
+    // The elided trailing whitespace is 1 char per column.
+    const uint16_t trailingWhitespace = _columnCount - header.columnCount;
+    const uint16_t charCount = header.charCount + trailingWhitespace;
+
+    std::unique_ptr<wchar_t[]> charsHeap;
+    std::span chars{ charsBuffer, _columnCount };
+    const std::span charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(_columnCount) + 1u };
+    if (charCount > _columnCount)
+    {
+        charsHeap = std::make_unique_for_overwrite<wchar_t[]>(charCount);
+        chars = { charsHeap.get(), charCount };
+    }
+
+    if (header.flags & HasCharOffsets)
+    {
+        const auto charOffsetsBytes = header.columnCount * sizeof(uint16_t);
+        memcpy(charOffsets.data(), src, charOffsetsBytes);
+        src += charOffsetsBytes;
+    }
+    else
+    {
+        iota_n(charOffsets.begin(), header.columnCount, uint16_t{ 0 });
+    }
+    // Just like in Resize(), this also fills in the past-the-end offset.
+    iota_n(charOffsets.begin() + header.columnCount, trailingWhitespace + 1u, header.charCount);
+
+    auto it = chars.begin();
+    if (header.flags & Ascii)
+    {
+        it = std::transform(src, src + header.charCount, it, [](std::byte ch) noexcept { return static_cast<wchar_t>(ch); });
+    }
+    else
+    {
+        memcpy(chars.data(), src, header.charCount * sizeof(wchar_t));
+        it += header.charCount;
+    }
+    std::fill_n(it, trailingWhitespace, L' ');
+
+    target._charsBuffer = charsBuffer;
+    target._charsHeap = std::move(charsHeap);
+    target._chars = chars;
+    target._charOffsets = charOffsets;
+}
+
 // Routine Description:
 // - clears char data in column in row
 // Arguments:
@@ -458,6 +657,379 @@ void ROW::ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, co
     }
 }
 
+// Routine Description:
+// - Replaces the columns [columnBegin, columnBegin + chars.size()) with one character each, regardless of its width.
+// - This is the bulk counterpart to calling ReplaceCharacters(column, 1, ...) for every character in chars,
+//   for text that's already aligned to columns, like the CHAR_INFOs of WriteConsoleOutputW.
+// Arguments:
+// - columnBegin - The first column to replace
+// - chars - The characters to write. Anything that doesn't fit into the row is ignored.
+void ROW::ReplaceColumns(til::CoordType columnBegin, std::wstring_view chars)
+{
+    const auto colBeg = _clampedUint16(columnBegin);
+    if (colBeg >= _columnCount || chars.empty())
+    {
+        return;
+    }
+
+    chars = chars.substr(0, _columnCount - colBeg);
+    const auto colEnd = gsl::narrow_cast<uint16_t>(colBeg + chars.size());
+
+    // This function works just like ReplaceCharacters(), but for an entire run of 1 column wide glyphs.
+    // See the algorithm explanation over there for more information about the extended range.
+
+    // Extend range downwards (leading whitespace)
+    uint16_t colExtBeg = colBeg;
+    // Safety: colExtBeg is [0, _columnCount), because colBeg is.
+    const uint16_t chExtBeg = _uncheckedCharOffset(colExtBeg);
+    // Safety: colExtBeg remains [0, _columnCount) due to colExtBeg != 0.
+    for (; colExtBeg != 0 && _uncheckedIsTrailer(colExtBeg); --colExtBeg)
+    {
+    }
+
+    // Extend range upwards (trailing whitespace)
+    uint16_t colExtEnd = colEnd;
+    // Safety: colExtEnd cannot be incremented past _columnCount, because the last
+    // _charOffset at index _columnCount will never get the CharOffsetsTrailer flag.
+    for (; _uncheckedIsTrailer(colExtEnd); ++colExtEnd)
+    {
+    }
+    // Safety: After the previous loop colExtEnd is [0, _columnCount].
+    const uint16_t chExtEnd = _uncheckedCharOffset(colExtEnd);
+
+    const uint16_t leadingSpaces = colBeg - colExtBeg;
+    const uint16_t trailingSpaces = colExtEnd - colEnd;
+    const size_t chExtEndNew = chars.size() + leadingSpaces + trailingSpaces + chExtBeg;
+
+    if (chExtEndNew != chExtEnd)
+    {
+        _resizeChars(colExtEnd, chExtBeg, chExtEnd, chExtEndNew);
+    }
+
+    // Add leading/trailing whitespace and copy chars
+    {
+        auto it = _chars.begin() + chExtBeg;
+        it = fill_n_small(it, leadingSpaces, L' ');
+        it = std::copy_n(chars.begin(), chars.size(), it);
+        it = fill_n_small(it, trailingSpaces, L' ');
+    }
+    // Every column in [colExtBeg, colExtEnd) now holds exactly 1 character.
+    {
+        auto chPos = chExtBeg;
+        iota_n_mut(_charOffsets.begin() + colExtBeg, colExtEnd - colExtBeg, chPos);
+    }
+}
+
+// Routine Description:
+// - Writes as much of state.text into this row as fits into [state.columnBegin, state.columnLimit).
+// - Unlike WriteCells() this doesn't iterate through the text one OutputCellView at a time.
+//   Instead the glyph widths are measured in a single pass and the text is then copied in bulk,
+//   which makes this the preferred function for printing long runs of text.
+// Arguments:
+// - state - The text to write and the columns to write it to. See RowWriteState.
+void ROW::ReplaceText(RowWriteState& state)
+{
+    const auto colBeg = _clampedColumnInclusive(state.columnBegin);
+    const auto colLimit = _clampedColumnInclusive(state.columnLimit);
+
+    state.columnEnd = colBeg;
+    state.columnBeginDirty = colBeg;
+    state.columnEndDirty = colBeg;
+
+    if (colBeg >= colLimit || state.text.empty())
+    {
+        return;
+    }
+
+    // This function works just like ReplaceCharacters(), but for an entire run of glyphs.
+    // See the algorithm explanation over there for more information about the extended range.
+
+    // Extend range downwards (leading whitespace)
+    uint16_t colExtBeg = colBeg;
+    // Safety: colExtBeg is [0, _columnCount], because colBeg is.
+    const uint16_t chExtBeg = _uncheckedCharOffset(colExtBeg);
+    // Safety: colExtBeg remains [0, _columnCount] due to colExtBeg != 0.
+    for (; colExtBeg != 0 && _uncheckedIsTrailer(colExtBeg); --colExtBeg)
+    {
+    }
+
+    const uint16_t leadingSpaces = colBeg - colExtBeg;
+    const auto text = state.text;
+    size_t ch = 0;
+    uint16_t colEnd = colBeg;
+    uint16_t chPos = chExtBeg + leadingSpaces;
+    auto paddingRequired = false;
+    auto replacementRequired = false;
+
+    // Measure the glyphs in `text` and fill in their char offsets in a single pass. This only overwrites the
+    // offsets in the range [colBeg, colEnd), which the code below doesn't depend on, so this is safe to do early.
+    {
+        // Fast path: ASCII is always exactly 1 column and 1 wchar_t wide.
+        // The offsets for such a run are thus just a simple sequence of ascending numbers.
+        const auto asciiLimit = std::min<size_t>(text.size(), colLimit - colBeg);
+        for (; ch < asciiLimit && til::at(text, ch) < 0x80; ++ch)
+        {
+        }
+        iota_n_mut(_charOffsets.begin() + colBeg, ch, chPos);
+        colEnd = gsl::narrow_cast<uint16_t>(colEnd + ch);
+
+        // Slow path: Everything else gets measured one codepoint at a time, just like OutputCellIterator does.
+        while (ch < text.size() && colEnd < colLimit)
+        {
+            const auto wch = til::at(text, ch);
+            std::wstring_view glyph{ &til::at(text, ch), 1 };
+
+            if (Utf16Parser::IsLeadingSurrogate(wch) && ch + 1 < text.size() && Utf16Parser::IsTrailingSurrogate(til::at(text, ch + 1)))
+            {
+                glyph = text.substr(ch, 2);
+            }
+            else if (Utf16Parser::IsLeadingSurrogate(wch) || Utf16Parser::IsTrailingSurrogate(wch))
+            {
+                // Unpaired surrogates are replaced with U+FFFD further below, just like Utf16Parser::ParseNext() does.
+                glyph = { &UNICODE_REPLACEMENT, 1 };
+                replacementRequired = true;
+            }
+
+            const uint16_t glyphWidth = IsGlyphFullWidth(glyph) ? 2 : 1;
+
+            if (colEnd + glyphWidth > colLimit)
+            {
+                // A wide glyph doesn't fit into the last column. Just like WriteCells() we pad that column with
+                // whitespace and leave the glyph in state.text, so that the caller can write it into the next row.
+                paddingRequired = true;
+                break;
+            }
+
+            til::at(_charOffsets, colEnd) = chPos;
+            if (glyphWidth == 2)
+            {
+                til::at(_charOffsets, colEnd + 1) = gsl::narrow_cast<uint16_t>(chPos | CharOffsetsTrailer);
+            }
+
+            ch += glyph.size();
+            colEnd += glyphWidth;
+            chPos = gsl::narrow_cast<uint16_t>(chPos + glyph.size());
+        }
+    }
+
+    // Safety: colEnd is [colBeg, colLimit) if paddingRequired is true and thus colWrittenEnd is [0, _columnCount].
+    const uint16_t colWrittenEnd = paddingRequired ? colEnd + 1 : colEnd;
+
+    // Extend range upwards (trailing whitespace)
+    uint16_t colExtEnd = colWrittenEnd;
+    // Safety: colExtEnd cannot be incremented past _columnCount, because the last
+    // _charOffset at index _columnCount will never get the CharOffsetsTrailer flag.
+    for (; _uncheckedIsTrailer(colExtEnd); ++colExtEnd)
+    {
+    }
+    // Safety: After the previous loop colExtEnd is [0, _columnCount].
+    const uint16_t chExtEnd = _uncheckedCharOffset(colExtEnd);
+
+    // The padding column (if any) counts as trailing whitespace.
+    const uint16_t trailingSpaces = colExtEnd - colEnd;
+    const size_t chExtEndNew = ::base::strict_cast<size_t>(chPos) + trailingSpaces;
+
+    if (chExtEndNew != chExtEnd)
+    {
+        _resizeChars(colExtEnd, chExtBeg, chExtEnd, chExtEndNew);
+    }
+
+    // Add leading/trailing whitespace and copy chars
+    {
+        auto it = _chars.begin() + chExtBeg;
+        it = fill_n_small(it, leadingSpaces, L' ');
+        const auto textBeg = it;
+        it = std::copy_n(text.begin(), ch, it);
+        it = fill_n_small(it, trailingSpaces, L' ');
+
+        if (replacementRequired)
+        {
+            // This is the only place where we'd need to know about surrogate pairs. Since unpaired
+            // surrogates are rare, we keep the copy above simple and fix them up afterwards.
+            auto prevLeading = false;
+            for (auto p = textBeg; p != textBeg + ch; ++p)
+            {
+                const auto lead = Utf16Parser::IsLeadingSurrogate(*p);
+                const auto trail = Utf16Parser::IsTrailingSurrogate(*p);
+                const auto nextTrail = p + 1 != textBeg + ch && Utf16Parser::IsTrailingSurrogate(p[1]);
+
+                if ((lead && !nextTrail) || (trail && !prevLeading))
+                {
+                    *p = UNICODE_REPLACEMENT;
+                }
+
+                prevLeading = lead && nextTrail;
+            }
+        }
+    }
+    // Update char offsets with leading/trailing whitespace.
+    // The offsets for the text itself were already written during measurement.
+    {
+        iota_n(_charOffsets.begin() + colExtBeg, leadingSpaces, chExtBeg);
+        iota_n_mut(_charOffsets.begin() + colEnd, trailingSpaces, chPos);
+    }
+
+    if (paddingRequired)
+    {
+        SetDoubleBytePadded(true);
+    }
+
+    state.text = text.substr(ch);
+    state.columnEnd = colWrittenEnd;
+    state.columnBeginDirty = colExtBeg;
+    state.columnEndDirty = colExtEnd;
+}
+
+// Routine Description:
+// - Copies as many glyphs from [state.sourceColumnBegin, state.sourceColumnLimit) of state.source
+//   into [state.columnBegin, state.columnLimit) of this row as fit, together with their attributes.
+// - This is the bulk counterpart to copying the source one GlyphAt()/ReplaceCharacters() at a time:
+//   The text of the entire range is copied in one go and the char offsets are rebased onto this row.
+//   The source and this row must not be the same.
+// Arguments:
+// - state - The source range and the columns to copy it to. See RowCopyTextFromState.
+void ROW::CopyTextFrom(RowCopyTextFromState& state)
+{
+    const auto& source = state.source;
+    const auto colBeg = _clampedColumnInclusive(state.columnBegin);
+    const auto colLimit = _clampedColumnInclusive(state.columnLimit);
+    auto srcBeg = source._clampedColumnInclusive(state.sourceColumnBegin);
+    const auto srcLimit = source._clampedColumnInclusive(state.sourceColumnLimit);
+
+    // The trailing half of a wide glyph can't be copied on its own.
+    // Safety: srcBeg remains [0, source._columnCount], because srcLimit is.
+    for (; srcBeg < srcLimit && source._uncheckedIsTrailer(srcBeg); ++srcBeg)
+    {
+    }
+
+    state.columnEnd = colBeg;
+    state.columnBeginDirty = colBeg;
+    state.columnEndDirty = colBeg;
+    state.sourceColumnEnd = srcBeg;
+
+    if (colBeg >= colLimit || srcBeg >= srcLimit)
+    {
+        return;
+    }
+
+    // Copy as many columns as fit, but don't cut a wide glyph in half. If the wide glyph didn't fit because we ran
+    // out of space in this row, we pad the last column with whitespace just like ReplaceText() does.
+    const uint16_t srcAvailable = srcLimit - srcBeg;
+    const uint16_t colAvailable = colLimit - colBeg;
+    auto srcEnd = gsl::narrow_cast<uint16_t>(srcBeg + std::min(srcAvailable, colAvailable));
+    auto paddingRequired = false;
+    // Safety: srcEnd is (srcBeg, source._columnCount] and a trailer is always preceded by its leading half.
+    if (source._uncheckedIsTrailer(srcEnd))
+    {
+        --srcEnd;
+        paddingRequired = colAvailable < srcAvailable;
+    }
+
+    // This function works just like ReplaceText(), but with text and offsets that have already been measured.
+    // See the algorithm explanation in ReplaceCharacters() for more information about the extended range.
+
+    // Extend range downwards (leading whitespace)
+    uint16_t colExtBeg = colBeg;
+    // Safety: colExtBeg is [0, _columnCount], because colBeg is.
+    const uint16_t chExtBeg = _uncheckedCharOffset(colExtBeg);
+    // Safety: colExtBeg remains [0, _columnCount] due to colExtBeg != 0.
+    for (; colExtBeg != 0 && _uncheckedIsTrailer(colExtBeg); --colExtBeg)
+    {
+    }
+
+    const uint16_t leadingSpaces = colBeg - colExtBeg;
+    const uint16_t srcChBeg = source._uncheckedCharOffset(srcBeg);
+    const uint16_t srcChEnd = source._uncheckedCharOffset(srcEnd);
+    const uint16_t colEnd = colBeg + (srcEnd - srcBeg);
+    const uint16_t chBeg = chExtBeg + leadingSpaces;
+    const auto chPos = gsl::narrow_cast<uint16_t>(chBeg + (srcChEnd - srcChBeg));
+
+    // Rebase the source's char offsets onto this row. This only overwrites the offsets in the range
+    // [colBeg, colEnd), which the code below doesn't depend on, so this is safe to do early.
+    {
+        auto src = source._charOffsets.begin() + srcBeg;
+        const auto srcEndIt = source._charOffsets.begin() + srcEnd;
+        auto it = _charOffsets.begin() + colBeg;
+        for (; src != srcEndIt; ++src, ++it)
+        {
+            const auto offset = *src;
+            *it = gsl::narrow_cast<uint16_t>(((offset & CharOffsetsMask) - srcChBeg + chBeg) | (offset & CharOffsetsTrailer));
+        }
+    }
+
+    // Safety: colEnd is [colBeg, colLimit) if paddingRequired is true and thus colWrittenEnd is [0, _columnCount].
+    const uint16_t colWrittenEnd = paddingRequired ? colEnd + 1 : colEnd;
+
+    // Extend range upwards (trailing whitespace)
+    uint16_t colExtEnd = colWrittenEnd;
+    // Safety: colExtEnd cannot be incremented past _columnCount, because the last
+    // _charOffset at index _columnCount will never get the CharOffsetsTrailer flag.
+    for (; _uncheckedIsTrailer(colExtEnd); ++colExtEnd)
+    {
+    }
+    // Safety: After the previous loop colExtEnd is [0, _columnCount].
+    const uint16_t chExtEnd = _uncheckedCharOffset(colExtEnd);
+
+    // The padding column (if any) counts as trailing whitespace.
+    const uint16_t trailingSpaces = colExtEnd - colEnd;
+    const size_t chExtEndNew = ::base::strict_cast<size_t>(chPos) + trailingSpaces;
+
+    if (chExtEndNew != chExtEnd)
+    {
+        _resizeChars(colExtEnd, chExtBeg, chExtEnd, chExtEndNew);
+    }
+
+    // Add leading/trailing whitespace and copy chars
+    {
+        auto it = _chars.begin() + chExtBeg;
+        it = fill_n_small(it, leadingSpaces, L' ');
+        it = std::copy(source._chars.begin() + srcChBeg, source._chars.begin() + srcChEnd, it);
+        it = fill_n_small(it, trailingSpaces, L' ');
+    }
+    // Update char offsets with leading/trailing whitespace.
+    // The offsets for the text itself were already written above.
+    {
+        iota_n(_charOffsets.begin() + colExtBeg, leadingSpaces, chExtBeg);
+        iota_n(_charOffsets.begin() + colEnd, trailingSpaces, chPos);
+    }
+
+    CopyAttributesFrom(source, srcBeg, colBeg, colEnd);
+
+    if (paddingRequired)
+    {
+        SetDoubleBytePadded(true);
+    }
+
+    state.columnEnd = colWrittenEnd;
+    state.columnBeginDirty = colExtBeg;
+    state.columnEndDirty = colExtEnd;
+    state.sourceColumnEnd = srcEnd;
+}
+
+// Routine Description:
+// - Copies the attributes of the source columns starting at sourceColumnBegin into [columnBegin, columnEnd).
+//   The attributes are copied run by run, instead of one column at a time.
+// Arguments:
+// - source - The row to copy the attributes from
+// - sourceColumnBegin - The first column in the source row to copy
+// - columnBegin - The first column in this row to copy to
+// - columnEnd - The first column in this row which should not be written to anymore
+void ROW::CopyAttributesFrom(const ROW& source, const til::CoordType sourceColumnBegin, const til::CoordType columnBegin, const til::CoordType columnEnd)
+{
+    const auto srcBeg = source._clampedColumnInclusive(sourceColumnBegin);
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(columnEnd);
+
+    if (colBeg >= colEnd || srcBeg >= source._columnCount)
+    {
+        return;
+    }
+
+    const auto count = std::min<uint16_t>(colEnd - colBeg, source._columnCount - srcBeg);
+    const auto runs = source._attr.slice(srcBeg, srcBeg + count);
+    _attr.replace(colBeg, colBeg + count, runs.runs());
+}
+
 // This function represents the slow path of ReplaceCharacters(),
 // as it reallocates the backing buffer and shifts the char offsets.
 // The parameters are difficult to explain, but their names are identical to
@@ -500,6 +1072,27 @@ const til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() const noexce
     return _attr;
 }
 
+// Routine Description:
+// - Returns a read-only view of the text, glyph boundaries and attributes of the columns [columnBegin, columnEnd).
+// Arguments:
+// - columnBegin - The first column of the slice
+// - columnEnd - The first column past the end of the slice
+// Return Value:
+// - The slice. See RowSlice.
+RowSlice ROW::GetSlice(const til::CoordType columnBegin, const til::CoordType columnEnd) const
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = std::max(colBeg, _clampedColumnInclusive(columnEnd));
+
+    RowSlice slice;
+    slice._chars = _chars.data();
+    slice._charOffsets = { _charOffsets.data() + colBeg, _charOffsets.data() + _charOffsets.size() };
+    slice._attr = _attr.slice(colBeg, colEnd);
+    slice._columnBegin = colBeg;
+    slice._columnEnd = colEnd;
+    return slice;
+}
+
 TextAttribute ROW::GetAttrByColumn(const til::CoordType column) const
 {
     return _attr.at(_clampedUint16(column));
@@ -624,6 +1217,43 @@ std::wstring_view ROW::GetText() const noexcept
     return { _chars.data(), _charSize() };
 }
 
+// Returns the column of the glyph that the given offset into GetText() belongs to.
+// If the glyph is wide, this returns its leading (left) column.
+til::CoordType ROW::GetLeadingColumnAtCharOffset(const ptrdiff_t offset) const noexcept
+{
+    const auto off = gsl::narrow_cast<uint16_t>(std::clamp<ptrdiff_t>(offset, 0, _charSize()));
+    const auto beg = _charOffsets.begin();
+    const auto end = beg + _columnCount;
+
+    // _charOffsets is sorted once the CharOffsetsTrailer flag is masked out. The column
+    // before the first one that starts past `off` contains it. Since the trailers of a wide
+    // glyph share the offset of its leading column, we then have to step back over them.
+    const auto it = std::upper_bound(beg, end, off, [](const uint16_t value, const uint16_t element) noexcept {
+        return value < (element & CharOffsetsMask);
+    });
+    auto col = gsl::narrow_cast<size_t>(std::max<ptrdiff_t>(0, it - beg - 1));
+    // Safety: col is [0, _columnCount).
+    while (col > 0 && _uncheckedIsTrailer(col))
+    {
+        --col;
+    }
+
+    return gsl::narrow_cast<til::CoordType>(col);
+}
+
+// Same as GetLeadingColumnAtCharOffset(), but returns the trailing (right) column of wide glyphs.
+til::CoordType ROW::GetTrailingColumnAtCharOffset(const ptrdiff_t offset) const noexcept
+{
+    auto col = gsl::narrow_cast<size_t>(GetLeadingColumnAtCharOffset(offset));
+    // Safety: col cannot be incremented past _columnCount - 1, because the last
+    // _charOffset at index _columnCount will never get the CharOffsetsTrailer flag.
+    while (_uncheckedIsTrailer(col + 1))
+    {
+        ++col;
+    }
+    return gsl::narrow_cast<til::CoordType>(col);
+}
+
 DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept
 {
     const auto col = _clampedColumn(column);
@@ -685,3 +1315,61 @@ bool ROW::_uncheckedIsTrailer(size_t col) const noexcept
 {
     return WI_IsFlagSet(til::at(_charOffsets, col), CharOffsetsTrailer);
 }
+
+til::CoordType RowSlice::ColumnBegin() const noexcept
+{
+    return _columnBegin;
+}
+
+til::CoordType RowSlice::ColumnEnd() const noexcept
+{
+    return _columnEnd;
+}
+
+// Returns the text of all glyphs that begin within the slice, plus the wide glyph
+// whose trailing half the slice begins with (if any). It's a view into the ROW's storage.
+std::wstring_view RowSlice::Text() const noexcept
+{
+    const auto end = gsl::narrow_cast<size_t>(_columnEnd - _columnBegin);
+    auto col = end;
+    // Safety: The last char offset of a ROW (its past-the-end offset) is never a trailer.
+    while (WI_IsFlagSet(til::at(_charOffsets, col), ROW::CharOffsetsTrailer))
+    {
+        ++col;
+    }
+    const auto beg = til::at(_charOffsets, 0) & ROW::CharOffsetsMask;
+    return { _chars + beg, _chars + (til::at(_charOffsets, col) & ROW::CharOffsetsMask) };
+}
+
+// The attribute runs of the slice. The first run starts at ColumnBegin().
+const til::small_rle<TextAttribute, uint16_t, 1>& RowSlice::Attributes() const noexcept
+{
+    return _attr;
+}
+
+// Returns true if the given column (absolute, within [ColumnBegin(), ColumnEnd())) is the trailing half of a wide glyph.
+bool RowSlice::IsTrailer(const til::CoordType column) const noexcept
+{
+    return WI_IsFlagSet(til::at(_charOffsets, gsl::narrow_cast<size_t>(column - _columnBegin)), ROW::CharOffsetsTrailer);
+}
+
+// Routine Description:
+// - Returns the glyph at the given column, just like ROW::GlyphAt().
+// Arguments:
+// - column - The column (absolute, within [ColumnBegin(), ColumnEnd())) to get the glyph of
+// - columns - Receives the number of columns from the given one to the end of the glyph.
+//   For the leading half of a wide glyph that's 2, for its trailing half 1.
+// Return Value:
+// - The glyph's text.
+std::wstring_view RowSlice::GlyphAt(const til::CoordType column, til::CoordType& columns) const noexcept
+{
+    const auto beg = gsl::narrow_cast<size_t>(column - _columnBegin);
+    auto end = beg;
+    // Safety: The last char offset of a ROW (its past-the-end offset) is never a trailer.
+    while (WI_IsFlagSet(til::at(_charOffsets, ++end), ROW::CharOffsetsTrailer))
+    {
+    }
+
+    columns = gsl::narrow_cast<til::CoordType>(end - beg);
+    return { _chars + (til::at(_charOffsets, beg) & ROW::CharOffsetsMask), _chars + (til::at(_charOffsets, end) & ROW::CharOffsetsMask) };
+}
@@ -37,6 +37,77 @@ enum class DelimiterClass
     RegularChar
 };
 
+struct RowWriteState
+{
+    // The text you want to write into the given ROW. When ReplaceText() returns,
+    // this is updated to remove all text from the beginning that was successfully written.
+    std::wstring_view text; // IN/OUT
+    // The column at which to start writing.
+    til::CoordType columnBegin = 0; // IN
+    // The first column which should not be written to anymore.
+    til::CoordType columnLimit = 0; // IN
+
+    // The column 1 past the last glyph that was successfully written into the row. If you need to call
+    // ReplaceAttributes() to color the glyphs written by ReplaceText(), use columnBegin and columnEnd.
+    til::CoordType columnEnd = 0; // OUT
+    // The first column that got modified by this write operation. In case that the first glyph we write overwrites
+    // the trailing half of a wide glyph, this value will be 1 less than columnBegin, since we had to clear it.
+    til::CoordType columnBeginDirty = 0; // OUT
+    // This is 1 past the last column that was modified and will be 1 past columnEnd if we overwrote
+    // the leading half of a wide glyph and had to fill the trailing half with whitespace.
+    til::CoordType columnEndDirty = 0; // OUT
+};
+
+struct RowCopyTextFromState
+{
+    // The row to copy from.
+    const ROW& source; // IN
+    // The column at which to start writing.
+    til::CoordType columnBegin = 0; // IN
+    // The first column which should not be written to anymore.
+    til::CoordType columnLimit = 0; // IN
+    // The column in the source row at which to start copying.
+    til::CoordType sourceColumnBegin = 0; // IN
+    // The first column in the source row which should not be copied anymore.
+    til::CoordType sourceColumnLimit = 0; // IN
+
+    // Just like RowWriteState::columnEnd this is 1 past the last glyph that was copied into the row,
+    // including the padding column in case a wide glyph didn't fit into the last column.
+    til::CoordType columnEnd = 0; // OUT
+    // See RowWriteState::columnBeginDirty.
+    til::CoordType columnBeginDirty = 0; // OUT
+    // See RowWriteState::columnEndDirty.
+    til::CoordType columnEndDirty = 0; // OUT
+    // The first column in the source row that wasn't copied. If it's less than sourceColumnLimit,
+    // the caller should continue copying from there into the next row.
+    til::CoordType sourceColumnEnd = 0; // OUT
+};
+
+// A read-only view of the columns [ColumnBegin(), ColumnEnd()) of a ROW, returned by ROW::GetSlice().
+// It hands renderers the text, glyph boundaries and attribute runs of a row in a single call,
+// instead of them having to construct an OutputCellView for every single column.
+// It refers to the ROW's storage and is thus only valid until the ROW is modified.
+class RowSlice
+{
+public:
+    til::CoordType ColumnBegin() const noexcept;
+    til::CoordType ColumnEnd() const noexcept;
+    std::wstring_view Text() const noexcept;
+    const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
+    bool IsTrailer(til::CoordType column) const noexcept;
+    std::wstring_view GlyphAt(til::CoordType column, til::CoordType& columns) const noexcept;
+
+private:
+    friend class ROW;
+
+    // The ROW's chars and the char offsets of the columns [_columnBegin, row width], including the past-the-end offset.
+    const wchar_t* _chars = nullptr;
+    std::span<const uint16_t> _charOffsets;
+    til::small_rle<TextAttribute, uint16_t, 1> _attr;
+    til::CoordType _columnBegin = 0;
+    til::CoordType _columnEnd = 0;
+};
+
 class ROW final
 {
 public:
@@ -57,18 +128,29 @@ public:
     bool WasDoubleBytePadded() const noexcept;
     void SetLineRendition(const LineRendition lineRendition) noexcept;
     LineRendition GetLineRendition() const noexcept;
+    void SetRevision(uint64_t revision) noexcept;
+    uint64_t GetRevision() const noexcept;
 
     void Reset(const TextAttribute& attr);
     void Resize(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute);
     void TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth);
+    bool IsCompressed() const noexcept;
+    wchar_t* Compress();
+    void Expand(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer);
+    void ExpandInto(ROW& target, wchar_t* charsBuffer, uint16_t* charOffsetsBuffer) const;
 
     void ClearCell(til::CoordType column);
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
     bool SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
+    void ReplaceColumns(til::CoordType columnBegin, std::wstring_view chars);
+    void ReplaceText(RowWriteState& state);
+    void CopyTextFrom(RowCopyTextFromState& state);
+    void CopyAttributesFrom(const ROW& source, til::CoordType sourceColumnBegin, til::CoordType columnBegin, til::CoordType columnEnd);
 
     const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
+    RowSlice GetSlice(til::CoordType columnBegin, til::CoordType columnEnd) const;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
     std::vector<uint16_t> GetHyperlinks() const;
     uint16_t size() const noexcept;
@@ -78,11 +160,15 @@ public:
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
+    til::CoordType GetLeadingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
+    til::CoordType GetTrailingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
 
     auto AttrBegin() const noexcept { return _attr.begin(); }
     auto AttrEnd() const noexcept { return _attr.end(); }
 
+    friend class RowSlice;
+
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
     friend class RowTests;
@@ -108,6 +194,7 @@ private:
     bool _uncheckedIsTrailer(size_t col) const noexcept;
 
     void _init() noexcept;
+    void _decompressInto(ROW& target, wchar_t* charsBuffer, uint16_t* charOffsetsBuffer) const;
     void _resizeChars(uint16_t colExtEnd, uint16_t chExtBeg, uint16_t chExtEnd, size_t chExtEndNew);
 
     // These fields are a bit "wasteful", but it makes all this a bit more robust against
@@ -155,12 +242,19 @@ private:
     til::small_rle<TextAttribute, uint16_t, 1> _attr;
     // The width of the row in visual columns.
     uint16_t _columnCount = 0;
+    // Rows that scrolled far out of view get compressed by TextBuffer: Their _chars and
+    // _charOffsets are packed into this blob and the row gives up its _charsBuffer.
+    // _attr and all other members stay as they are. See ROW::Compress().
+    std::unique_ptr<std::byte[]> _compressed;
     // Stores double-width/height (DECSWL/DECDWL/DECDHL) attributes.
     LineRendition _lineRendition = LineRendition::SingleWidth;
     // Occurs when the user runs out of text in a given row and we're forced to wrap the cursor to the next line
     bool _wrapForced = false;
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
     bool _doubleBytePadded = false;
+    // TextBuffer stamps rows with a unique revision whenever they're handed out for writing.
+    // This allows it to tell whether a row changed since it was last looked at.
+    uint64_t _revision = 0;
 };
 
 #ifdef UNIT_TESTING
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "UrlScanner.hpp"
+
+namespace
+{
+    enum CharClass : uint8_t
+    {
+        // \w
+        Word = 0x1,
+        // [-A-Za-z0-9+&@#/%?=~_|$!:,.;]
+        UrlBody = 0x2,
+        // [A-Za-z0-9+&@#/%=~_|$]
+        UrlEnd = 0x4,
+    };
+
+    constexpr auto charClasses = []() {
+        std::array<uint8_t, 128> classes{};
+        const auto set = [&](std::string_view chars, uint8_t cls) {
+            for (const auto ch : chars)
+            {
+                classes[static_cast<size_t>(ch)] |= cls;
+            }
+        };
+        for (auto ch = 'a'; ch <= 'z'; ++ch)
+        {
+            classes[static_cast<size_t>(ch)] = Word | UrlBody | UrlEnd;
+            classes[static_cast<size_t>(ch - 'a' + 'A')] = Word | UrlBody | UrlEnd;
+        }
+        for (auto ch = '0'; ch <= '9'; ++ch)
+        {
+            classes[static_cast<size_t>(ch)] = Word | UrlBody | UrlEnd;
+        }
+        set("_", Word);
+        set("+&@#/%=~_|$", UrlBody | UrlEnd);
+        set("-?!:,.;", UrlBody);
+        return classes;
+    }();
+
+    constexpr bool isClass(const wchar_t ch, const CharClass cls) noexcept
+    {
+        return ch < charClasses.size() && (til::at(charClasses, ch) & cls) != 0;
+    }
+}
+
+// Routine Description:
+// - Finds the next URL in the given text. The search for "://" is vectorized by the STL and
+//   everything else only looks at the few characters around it. The URL scheme has to be
+//   preceded by a word boundary, and the URL is the longest run of UrlBody characters
+//   after the "://" that ends in a UrlEnd character, just like Pattern describes.
+// Arguments:
+// - text - the text to search
+// - offset - the index at which the search starts. URLs that begin before it are ignored.
+// Return Value:
+// - The [begin, end) range of the URL within text, or nullopt if there's none.
+std::optional<std::pair<size_t, size_t>> UrlScanner::Find(const std::wstring_view text, size_t offset) noexcept
+{
+    static constexpr std::array<std::wstring_view, 4> schemes{ L"https", L"http", L"ftp", L"file" };
+
+    for (;;)
+    {
+        const auto separator = text.find(L"://", offset);
+        if (separator == std::wstring_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        for (const auto scheme : schemes)
+        {
+            if (separator - offset < scheme.size())
+            {
+                continue;
+            }
+
+            const auto begin = separator - scheme.size();
+            if (text.substr(begin, scheme.size()) != scheme || (begin != 0 && isClass(til::at(text, begin - 1), Word)))
+            {
+                continue;
+            }
+
+            auto end = begin;
+            for (auto i = separator + 3; i < text.size() && isClass(til::at(text, i), UrlBody); ++i)
+            {
+                if (isClass(til::at(text, i), UrlEnd))
+                {
+                    end = i + 1;
+                }
+            }
+            if (end != begin)
+            {
+                return std::pair{ begin, end };
+            }
+
+            // The schemes are mutually exclusive, since they all end right before the separator.
+            break;
+        }
+
+        offset = separator + 1;
+    }
+}
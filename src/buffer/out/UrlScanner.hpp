@@ -0,0 +1,24 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- UrlScanner.hpp
+
+Abstract:
+- A hand-rolled matcher for the URL pattern that's used for hyperlink detection.
+- It finds exactly the same matches as UrlScanner::Pattern would with std::wregex,
+  but without the overhead of a backtracking regex engine. TextBuffer uses it in
+  place of std::wregex whenever that pattern is registered.
+--*/
+
+#pragma once
+
+class UrlScanner final
+{
+public:
+    static constexpr std::wstring_view Pattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
+
+    // Returns the [begin, end) range of the first URL in text that begins at or after offset.
+    static std::optional<std::pair<size_t, size_t>> Find(std::wstring_view text, size_t offset) noexcept;
+};
@@ -6,32 +6,91 @@
 #include "search.h"
 
 #include "textBuffer.hpp"
-#include "../types/inc/Utf16Parser.hpp"
-#include "../types/inc/GlyphWidth.hpp"
 
 using namespace Microsoft::Console::Types;
 
+namespace
+{
+    // A Boyer-Moore-Horspool searcher for UTF-16 text. The bad character table is indexed by the
+    // low byte of each character, so characters that share it also share their shift. That makes
+    // the shifts a little conservative, but keeps the table small and cheap to build.
+    class Horspool
+    {
+    public:
+        explicit Horspool(const std::wstring_view needle) noexcept :
+            _needle{ needle }
+        {
+            const auto last = needle.size() - 1;
+            _skip.fill(needle.size());
+            for (size_t i = 0; i < last; ++i)
+            {
+                til::at(_skip, needle[i] & 0xff) = last - i;
+            }
+        }
+
+        // Returns the offset of the first match in haystack at or after pos, or npos.
+        size_t Find(const std::wstring_view haystack, size_t pos) const noexcept
+        {
+            const auto size = _needle.size();
+            if (size == 1)
+            {
+                // This boils down to wmemchr(), which is vectorized.
+                return haystack.find(_needle.front(), pos);
+            }
+
+            const auto last = _needle.back();
+            while (pos + size <= haystack.size())
+            {
+                const auto ch = til::at(haystack, pos + size - 1);
+                if (ch == last && wmemcmp(haystack.data() + pos, _needle.data(), size - 1) == 0)
+                {
+                    return pos;
+                }
+                pos += til::at(_skip, ch & 0xff);
+            }
+            return std::wstring_view::npos;
+        }
+
+    private:
+        std::wstring_view _needle;
+        std::array<size_t, 256> _skip{};
+    };
+
+    // Lowercases the text in place, the same way that towlower() does, but with a fast path for ASCII.
+    // This never changes the length of the text, so offsets into it remain valid for the original.
+    void foldCase(const std::span<wchar_t> text) noexcept
+    {
+        for (auto& ch : text)
+        {
+            if (ch >= 0x80)
+            {
+                ch = ::towlower(ch);
+            }
+            else if (ch >= L'A' && ch <= L'Z')
+            {
+                ch = static_cast<wchar_t>(ch | 0x20);
+            }
+        }
+    }
+}
+
 // Routine Description:
 // - Constructs a Search object.
 // - Make a Search object then call .FindNext() to locate items.
 // - Once you've found something, you can perform actions like .Select() or .Color()
 // Arguments:
-// - textBuffer - The screen text buffer to search through (the "haystack")
 // - uiaData - The IUiaData type reference, it is for providing selection methods
 // - str - The search term you want to find (the "needle")
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
+// - mode - Whether str is plain text or a regular expression
 Search::Search(IUiaData& uiaData,
                const std::wstring_view str,
                const Direction direction,
-               const Sensitivity sensitivity) :
-    _direction(direction),
-    _sensitivity(sensitivity),
-    _needle(s_CreateNeedleFromString(str)),
-    _uiaData(uiaData),
-    _coordAnchor(s_GetInitialAnchor(uiaData, direction))
+               const Sensitivity sensitivity,
+               const Mode mode) :
+    Search(uiaData, str, direction, sensitivity, s_GetInitialAnchor(uiaData, direction), mode)
 {
-    _coordNext = _coordAnchor;
 }
 
 // Routine Description:
@@ -39,28 +98,31 @@ Search::Search(IUiaData& uiaData,
 // - Make a Search object then call .FindNext() to locate items.
 // - Once you've found something, you can perform actions like .Select() or .Color()
 // Arguments:
-// - textBuffer - The screen text buffer to search through (the "haystack")
 // - uiaData - The IUiaData type reference, it is for providing selection methods
 // - str - The search term you want to find (the "needle")
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
 // - anchor - starting search location in screenInfo
+// - mode - Whether str is plain text or a regular expression
 Search::Search(IUiaData& uiaData,
                const std::wstring_view str,
                const Direction direction,
                const Sensitivity sensitivity,
-               const til::point anchor) :
+               const til::point anchor,
+               const Mode mode) :
+    _coordAnchor(anchor),
+    _needle(str),
     _direction(direction),
     _sensitivity(sensitivity),
-    _needle(s_CreateNeedleFromString(str)),
-    _coordAnchor(anchor),
+    _mode(mode),
     _uiaData(uiaData)
 {
-    _coordNext = _coordAnchor;
 }
 
 // Routine Description
 // - Locates the next instance of the search term within the screen buffer.
+// - The entire buffer is searched the first time this is called. After that
+//   this only steps through the results, starting at the anchor.
 // Arguments:
 // - <none> - Uses internal state from constructor
 // Return Value:
@@ -68,28 +130,23 @@ Search::Search(IUiaData& uiaData,
 // - NOTE: You can FindNext() again after False to go around the buffer again.
 bool Search::FindNext()
 {
-    if (_reachedEnd)
+    _FindAllIfNeeded();
+
+    const auto count = _results.size();
+    if (_visitedResults == count)
     {
-        _reachedEnd = false;
+        _visitedResults = 0;
         return false;
     }
 
-    do
-    {
-        if (_FindNeedleInHaystackAt(_coordNext, _coordSelStart, _coordSelEnd))
-        {
-            _UpdateNextPosition();
-            _reachedEnd = _coordNext == _coordAnchor;
-            return true;
-        }
-        else
-        {
-            _UpdateNextPosition();
-        }
-
-    } while (_coordNext != _coordAnchor);
-
-    return false;
+    const auto index = _direction == Direction::Forward ?
+                           (_firstResult + _visitedResults) % count :
+                           (_firstResult + count - _visitedResults) % count;
+    const auto& result = til::at(_results, index);
+    _coordSelStart = result.start;
+    _coordSelEnd = result.end;
+    ++_visitedResults;
+    return true;
 }
 
 // Routine Description:
@@ -117,6 +174,28 @@ void Search::Color(const TextAttribute attr) const
     }
 }
 
+// Routine Description:
+// - Applies the supplied TextAttribute to every instance of the search term in the buffer.
+// Arguments:
+// - attr - The attribute to apply to the results
+void Search::ColorAll(const TextAttribute attr)
+{
+    for (const auto& result : GetResults())
+    {
+        _uiaData.ColorSelection(result.start, result.end, attr);
+    }
+}
+
+// Routine Description:
+// - Gets every instance of the search term in the buffer, for instance to highlight all of them.
+// Return Value:
+// - The start and (inclusive) end of each result, in buffer order.
+const std::vector<til::point_span>& Search::GetResults()
+{
+    _FindAllIfNeeded();
+    return _results;
+}
+
 // Routine Description:
 // - gets start and end position of text sound by search. only guaranteed to have valid data if FindNext has
 // been called and returned true.
@@ -176,169 +255,151 @@ til::point Search::s_GetInitialAnchor(const IUiaData& uiaData, const Direction d
 }
 
 // Routine Description:
-// - Attempts to compare the search term (the needle) to the screen buffer (the haystack)
-//   at the given coordinate position of the screen buffer.
-// - Performs one comparison. Call again with new positions to check other spots.
-// Arguments:
-// - pos - The position in the haystack (screen buffer) to compare
-// - start - If we found it, this is filled with the coordinate of the first character of the needle.
-// - end - If we found it, this is filled with the coordinate of the last character of the needle.
-// Return Value:
-// - True if we found it. False if not.
-bool Search::_FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const
+// - Finds every instance of the search term in the buffer, unless that already happened,
+//   and figures out which of them FindNext() should return first given the anchor.
+void Search::_FindAllIfNeeded()
 {
-    start = {};
-    end = {};
-
-    auto bufferPos = pos;
-
-    for (const auto& needleCell : _needle)
+    if (_searched)
     {
-        // Haystack is the buffer. Needle is the string we were given.
-        const auto hayIter = _uiaData.GetTextBuffer().GetTextDataAt(bufferPos);
-        const auto hayChars = *hayIter;
-        const auto needleChars = std::wstring_view(needleCell.data(), needleCell.size());
-
-        // If we didn't match at any point of the needle, return false.
-        if (!_CompareChars(hayChars, needleChars))
-        {
-            return false;
-        }
-
-        _IncrementCoord(bufferPos);
+        return;
     }
 
-    _DecrementCoord(bufferPos);
+    _results = s_FindAll(_uiaData.GetTextBuffer(), _needle, _sensitivity, _mode, _uiaData.GetTextBufferEndPosition());
+    _searched = true;
 
-    // If we made it the whole way through the needle, then it was in the haystack.
-    // Fill out the span that we found the result at and return true.
-    start = pos;
-    end = bufferPos;
-
-    return true;
-}
-
-// Routine Description:
-// - Provides an abstraction for comparing two spans of text.
-// - Internally handles case sensitivity based on object construction.
-// Arguments:
-// - one - String view representing the first string of text
-// - two - String view representing the second string of text
-// Return Value:
-// - True if they are the same. False otherwise.
-bool Search::_CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept
-{
-    if (one.size() != two.size())
-    {
-        return false;
-    }
-
-    for (size_t i = 0; i < one.size(); i++)
+    if (_results.empty())
     {
-        if (_ApplySensitivity(one.at(i)) != _ApplySensitivity(two.at(i)))
-        {
-            return false;
-        }
+        return;
     }
 
-    return true;
-}
-
-// Routine Description:
-// - Provides an abstraction for conditionally applying case sensitivity
-//   based on object construction
-// Arguments:
-// - wch - Character to adjust if necessary
-// Return Value:
-// - Adjusted value (or not).
-wchar_t Search::_ApplySensitivity(const wchar_t wch) const noexcept
-{
-    if (_sensitivity == Sensitivity::CaseInsensitive)
+    if (_direction == Direction::Forward)
     {
-        return ::towlower(wch);
+        // The first result at or after the anchor, or the very first one if there's none.
+        const auto it = std::find_if(_results.begin(), _results.end(), [&](const auto& r) { return r.start >= _coordAnchor; });
+        _firstResult = it == _results.end() ? 0 : gsl::narrow_cast<size_t>(it - _results.begin());
     }
     else
     {
-        return wch;
+        // The last result at or before the anchor, or the very last one if there's none.
+        const auto it = std::find_if(_results.rbegin(), _results.rend(), [&](const auto& r) { return r.start <= _coordAnchor; });
+        _firstResult = _results.size() - 1 - (it == _results.rend() ? 0 : gsl::narrow_cast<size_t>(it - _results.rbegin()));
     }
 }
 
 // Routine Description:
-// - Helper to increment a coordinate in respect to the associated screen buffer
-// Arguments
-// - coord - Updated by function to increment one position (will wrap X and Y direction)
-void Search::_IncrementCoord(til::point& coord) const noexcept
-{
-    _uiaData.GetTextBuffer().GetSize().IncrementInBoundsCircular(coord);
-}
-
-// Routine Description:
-// - Helper to decrement a coordinate in respect to the associated screen buffer
-// Arguments
-// - coord - Updated by function to decrement one position (will wrap X and Y direction)
-void Search::_DecrementCoord(til::point& coord) const noexcept
-{
-    _uiaData.GetTextBuffer().GetSize().DecrementInBoundsCircular(coord);
-}
-
-// Routine Description:
-// - Helper to update the coordinate position to the next point to be searched
+// - Finds every instance of the search term in the given buffer in a single pass.
+// - Rows that wrap into each other are searched as a single line of text, which
+//   means that matches may span multiple rows, but only if they were wrapped.
+// - Plain text is searched for with Boyer-Moore-Horspool. If the search is case
+//   insensitive, the text of each line gets case folded in bulk beforehand.
+// Arguments:
+// - textBuffer - The text buffer to search through (the "haystack")
+// - str - The search term you want to find (the "needle")
+// - sensitivity - Whether or not you care about case
+// - mode - Whether str is plain text or a regular expression
+// - limit - Matches must start at or before this position, usually the end of the text in the buffer
 // Return Value:
-// - True if we haven't reached the end of the buffer. False otherwise.
-void Search::_UpdateNextPosition()
+// - The start and (inclusive) end of each match, in buffer order.
+std::vector<til::point_span> Search::s_FindAll(const TextBuffer& textBuffer,
+                                               const std::wstring_view str,
+                                               const Sensitivity sensitivity,
+                                               const Mode mode,
+                                               const til::point limit)
 {
-    if (_direction == Direction::Forward)
+    std::vector<til::point_span> results;
+    if (str.empty())
     {
-        _IncrementCoord(_coordNext);
+        return results;
     }
-    else if (_direction == Direction::Backward)
+
+    const auto caseInsensitive = sensitivity == Sensitivity::CaseInsensitive;
+
+    std::optional<std::wregex> regex;
+    std::wstring needle{ str };
+    if (mode == Mode::RegularExpression)
     {
-        _DecrementCoord(_coordNext);
+        const auto flags = caseInsensitive ? std::regex_constants::ECMAScript | std::regex_constants::icase : std::regex_constants::ECMAScript;
+        regex.emplace(str.data(), str.size(), flags);
     }
-    else
+    else if (caseInsensitive)
     {
-        THROW_HR(E_NOTIMPL);
+        foldCase(needle);
     }
+    const Horspool horspool{ needle };
 
-    // To reduce wrap-around time, if the next position is larger than
-    // the end position of the written text
-    // We put the next position to:
-    // Forward: (0, 0)
-    // Backward: the position of the end of the text buffer
-    const auto bufferEndPosition = _uiaData.GetTextBufferEndPosition();
+    // text is the line that is being searched and rowOffsets[i] the offset
+    // in text at which its i-th row starts. The extra item at the end is its length.
+    std::wstring text;
+    std::vector<size_t> rowOffsets;
 
-    if (_coordNext.Y > bufferEndPosition.Y ||
-        (_coordNext.Y == bufferEndPosition.Y && _coordNext.X > bufferEndPosition.X))
+    const auto lastRow = std::min(limit.y, textBuffer.TotalRowCount() - 1);
+    for (til::CoordType row = 0; row <= lastRow;)
     {
-        if (_direction == Direction::Forward)
+        const auto firstRow = row;
+
+        text.clear();
+        rowOffsets.clear();
+        for (;;)
         {
-            _coordNext = {};
+            const auto& r = textBuffer.GetRowByOffset(row);
+            rowOffsets.emplace_back(text.size());
+            text.append(r.GetText());
+            ++row;
+            if (!r.WasWrapForced() || row >= textBuffer.TotalRowCount())
+            {
+                break;
+            }
         }
-        else
+        rowOffsets.emplace_back(text.size());
+
+        const auto toPoint = [&](const size_t offset, const bool trailing) {
+            const auto it = std::upper_bound(rowOffsets.begin(), rowOffsets.end() - 1, offset) - 1;
+            const auto y = firstRow + gsl::narrow_cast<til::CoordType>(it - rowOffsets.begin());
+            const auto& r = textBuffer.GetRowByOffset(y);
+            const auto off = gsl::narrow_cast<ptrdiff_t>(offset - *it);
+            return til::point{ trailing ? r.GetTrailingColumnAtCharOffset(off) : r.GetLeadingColumnAtCharOffset(off), y };
+        };
+        // Returns false once the remaining matches in the line start past the limit.
+        const auto addMatch = [&](const size_t begin, const size_t end) {
+            const auto start = toPoint(begin, false);
+            if (start > limit)
+            {
+                return false;
+            }
+            results.emplace_back(til::point_span{ start, toPoint(end - 1, true) });
+            return true;
+        };
+
+        if (regex)
         {
-            _coordNext = bufferEndPosition;
+            const auto beg = text.data();
+            const auto end = beg + text.size();
+            for (auto it = std::wcregex_iterator{ beg, end, *regex }; it != std::wcregex_iterator{}; ++it)
+            {
+                const auto position = gsl::narrow_cast<size_t>(it->position());
+                const auto length = gsl::narrow_cast<size_t>(it->length());
+                if (length && !addMatch(position, position + length))
+                {
+                    break;
+                }
+            }
         }
-    }
-}
-
-// Routine Description:
-// - Creates a "needle" of the correct format for comparison to the screen buffer text data
-//   that we can use for our search
-// Arguments:
-// - wstr - String that will be our search term
-// Return Value:
-// - Structured text data for comparison to screen buffer text data.
-std::vector<std::vector<wchar_t>> Search::s_CreateNeedleFromString(const std::wstring_view wstr)
-{
-    const auto charData = Utf16Parser::Parse(wstr);
-    std::vector<std::vector<wchar_t>> cells;
-    for (const auto chars : charData)
-    {
-        if (IsGlyphFullWidth(std::wstring_view{ chars.data(), chars.size() }))
+        else
         {
-            cells.emplace_back(chars);
+            if (caseInsensitive)
+            {
+                foldCase(text);
+            }
+            // Matches may overlap, just like they used to when the buffer was searched cell by cell.
+            for (auto pos = horspool.Find(text, 0); pos != std::wstring_view::npos; pos = horspool.Find(text, pos + 1))
+            {
+                if (!addMatch(pos, pos + needle.size()))
+                {
+                    break;
+                }
+            }
         }
-        cells.emplace_back(chars);
     }
-    return cells;
+
+    return results;
 }
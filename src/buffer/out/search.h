@@ -40,45 +40,59 @@ public:
         CaseSensitive
     };
 
+    enum class Mode
+    {
+        PlainText,
+        RegularExpression
+    };
+
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring_view str,
            const Direction dir,
-           const Sensitivity sensitivity);
+           const Sensitivity sensitivity,
+           const Mode mode = Mode::PlainText);
 
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring_view str,
            const Direction dir,
            const Sensitivity sensitivity,
-           const til::point anchor);
+           const til::point anchor,
+           const Mode mode = Mode::PlainText);
 
     bool FindNext();
     void Select() const;
     void Color(const TextAttribute attr) const;
+    void ColorAll(const TextAttribute attr);
 
+    const std::vector<til::point_span>& GetResults();
     std::pair<til::point, til::point> GetFoundLocation() const noexcept;
 
-private:
-    wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
-    bool _FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const;
-    bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept;
-    void _UpdateNextPosition();
+    static std::vector<til::point_span> s_FindAll(const TextBuffer& textBuffer,
+                                                  const std::wstring_view str,
+                                                  const Sensitivity sensitivity,
+                                                  const Mode mode,
+                                                  const til::point limit);
 
-    void _IncrementCoord(til::point& coord) const noexcept;
-    void _DecrementCoord(til::point& coord) const noexcept;
+private:
+    void _FindAllIfNeeded();
 
     static til::point s_GetInitialAnchor(const Microsoft::Console::Types::IUiaData& uiaData, const Direction dir);
 
-    static std::vector<std::vector<wchar_t>> s_CreateNeedleFromString(const std::wstring_view wstr);
+    // Every match in the buffer in buffer order, with inclusive ends.
+    // They're found all at once, the first time they're needed.
+    std::vector<til::point_span> _results;
+    bool _searched = false;
+    size_t _firstResult = 0; // index of the first result FindNext() returns
+    size_t _visitedResults = 0; // number of results FindNext() returned since it last returned false
 
-    bool _reachedEnd = false;
-    til::point _coordNext;
     til::point _coordSelStart;
     til::point _coordSelEnd;
 
     const til::point _coordAnchor;
-    const std::vector<std::vector<wchar_t>> _needle;
+    const std::wstring _needle;
     const Direction _direction;
     const Sensitivity _sensitivity;
+    const Mode _mode;
     Microsoft::Console::Types::IUiaData& _uiaData;
 
 #ifdef UNIT_TESTING
@@ -7,80 +7,11 @@
 
 #include <til/hash.h>
 
+#include "UrlScanner.hpp"
+
 #include "../renderer/base/renderer.hpp"
 #include "../types/inc/utils.hpp"
 #include "../types/inc/convert.hpp"
-#include "../../types/inc/Utf16Parser.hpp"
-#include "../../types/inc/GlyphWidth.hpp"
-
-namespace
-{
-    struct BufferAllocator
-    {
-        BufferAllocator(til::size sz)
-        {
-            const auto w = gsl::narrow<uint16_t>(sz.width);
-            const auto h = gsl::narrow<uint16_t>(sz.height);
-
-            const auto charsBytes = w * sizeof(wchar_t);
-            // The ROW::_indices array stores 1 more item than the buffer is wide.
-            // That extra column stores the past-the-end _chars pointer.
-            const auto indicesBytes = w * sizeof(uint16_t) + sizeof(uint16_t);
-            const auto rowStride = charsBytes + indicesBytes;
-            // 65535*65535 cells would result in a charsAreaSize of 8GiB.
-            // --> Use uint64_t so that we can safely do our calculations even on x86.
-            const auto allocSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(rowStride) * ::base::strict_cast<uint64_t>(h));
-
-            _buffer = wil::unique_virtualalloc_ptr<std::byte>{ static_cast<std::byte*>(VirtualAlloc(nullptr, allocSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)) };
-            THROW_IF_NULL_ALLOC(_buffer);
-
-            _data = std::span{ _buffer.get(), allocSize }.begin();
-            _rowStride = rowStride;
-            _indicesOffset = charsBytes;
-            _width = w;
-            _height = h;
-        }
-
-        BufferAllocator& operator++() noexcept
-        {
-            _data += _rowStride;
-            return *this;
-        }
-
-        wchar_t* chars() const noexcept
-        {
-            return til::bit_cast<wchar_t*>(&*_data);
-        }
-
-        uint16_t* indices() const noexcept
-        {
-            return til::bit_cast<uint16_t*>(&*(_data + _indicesOffset));
-        }
-
-        uint16_t width() const noexcept
-        {
-            return _width;
-        }
-
-        uint16_t height() const noexcept
-        {
-            return _height;
-        }
-
-        wil::unique_virtualalloc_ptr<std::byte>&& take() noexcept
-        {
-            return std::move(_buffer);
-        }
-
-    private:
-        wil::unique_virtualalloc_ptr<std::byte> _buffer;
-        std::span<std::byte>::iterator _data;
-        size_t _rowStride;
-        size_t _indicesOffset;
-        uint16_t _width;
-        uint16_t _height;
-    };
-}
 
 using namespace Microsoft::Console;
 using namespace Microsoft::Console::Types;
@@ -105,19 +36,15 @@ TextBuffer::TextBuffer(const til::size screenBufferSize,
                        Microsoft::Console::Render::Renderer& renderer) :
     _renderer{ renderer },
     _currentAttributes{ defaultAttributes },
+    _initialAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
     _isActiveBuffer{ isActiveBuffer }
 {
-    BufferAllocator allocator{ screenBufferSize };
-
-    _storage.reserve(allocator.height());
-    for (til::CoordType i = 0; i < screenBufferSize.Y; ++i, ++allocator)
-    {
-        _storage.emplace_back(allocator.chars(), allocator.indices(), allocator.width(), _currentAttributes);
-    }
-
-    _charBuffer = allocator.take();
+    // The rows start out uncommitted and get their memory the first time they're used.
+    _ReserveBuffer(screenBufferSize);
+    _storage.resize(gsl::narrow_cast<size_t>(screenBufferSize.height));
     _UpdateSize();
+    _UpdateBlankRow();
 }
 
 // Routine Description:
@@ -154,7 +81,18 @@ const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const noexcept
 {
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     const auto offsetIndex = gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size();
-    return til::at(_storage, offsetIndex);
+    const auto& row = til::at(_storage, offsetIndex);
+    // Rows that were never written to aren't committed yet. Reading them mustn't change that.
+    if (!row.size())
+    {
+        return _blankRow;
+    }
+    // The same goes for compressed rows. Readers get a decoded copy and the row stays compressed.
+    if (row.IsCompressed()) [[unlikely]]
+    {
+        return _GetDecodedRow(row);
+    }
+    return row;
 }
 
 // Routine Description:
@@ -165,10 +103,266 @@ const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const noexcept
 // Return Value:
 // - reference to the requested row. Asserts if out of bounds.
 ROW& TextBuffer::GetRowByOffset(const til::CoordType index) noexcept
+{
+    try
+    {
+        return _GetRowForWriting(index);
+    }
+    catch (...)
+    {
+        // We failed to commit memory for the row. Losing whatever the caller
+        // meant to write into it is better than taking down the process.
+        LOG_CAUGHT_EXCEPTION();
+        _discardRow.Reset(_initialAttributes);
+        return _discardRow;
+    }
+}
+
+// Routine Description:
+// - Same as the non-const GetRowByOffset(), but throws if the row can't be committed.
+//   Our own write functions use this, so that their callers can handle the failure.
+// Arguments:
+// - Number of rows down from the first row of the buffer.
+// Return Value:
+// - reference to the requested row.
+ROW& TextBuffer::_GetRowForWriting(const til::CoordType index)
 {
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     const auto offsetIndex = gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size();
-    return til::at(_storage, offsetIndex);
+    auto& row = til::at(_storage, offsetIndex);
+    // The caller might write to the row, so it needs to be committed (or expanded) now.
+    if (!row.size() || row.IsCompressed()) [[unlikely]]
+    {
+        // A compressed row is likely still cold. This ensures that the next CompressColdRows() compresses it again.
+        if (row.IsCompressed())
+        {
+            _coldRows = std::min(_coldRows, index);
+        }
+        _CommitRow(row, _initialAttributes);
+    }
+    // UpdatePatterns() uses the revision to notice that the row may have been modified.
+    row.SetRevision(++_lastRowRevision);
+    return row;
+}
+
+// Routine Description:
+// - Reserves (but doesn't commit) the address space for the chars and charOffsets of all rows
+//   and makes it the current backing store. Rows get a slice of it assigned by _CommitRow().
+// Arguments:
+// - size - the size of the buffer. The width must be at least 1, because uncommitted rows are
+//   told apart from committed ones by their size() being 0.
+// Return Value:
+// - The previous backing store. Keep it alive until all rows were moved out of it.
+wil::unique_virtualalloc_ptr<std::byte> TextBuffer::_ReserveBuffer(const til::size size)
+{
+    THROW_HR_IF(E_INVALIDARG, size.width <= 0 || size.height <= 0);
+
+    const auto w = gsl::narrow<uint16_t>(size.width);
+    const auto h = gsl::narrow<uint16_t>(size.height);
+
+    const auto charsBytes = w * sizeof(wchar_t);
+    // The ROW::_indices array stores 1 more item than the buffer is wide.
+    // That extra column stores the past-the-end _chars pointer.
+    const auto indicesBytes = w * sizeof(uint16_t) + sizeof(uint16_t);
+    const auto rowStride = charsBytes + indicesBytes;
+    // 65535*65535 cells would result in a charsAreaSize of 8GiB.
+    // --> Use uint64_t so that we can safely do our calculations even on x86.
+    const auto allocSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(rowStride) * ::base::strict_cast<uint64_t>(h));
+
+    wil::unique_virtualalloc_ptr<std::byte> buffer{ static_cast<std::byte*>(VirtualAlloc(nullptr, allocSize, MEM_RESERVE, PAGE_READWRITE)) };
+    THROW_IF_NULL_ALLOC(buffer);
+
+    _bufferRowStride = rowStride;
+    _bufferOffsetCharOffsets = charsBytes;
+    _bufferSize = allocSize;
+    _bufferCommitted = 0;
+    _commitWatermark = 0;
+    _freeRowSlices.clear();
+    _width = w;
+    return std::exchange(_charBuffer, std::move(buffer));
+}
+
+// Routine Description:
+// - Assigns an unused slice of the backing store to the given row. Slices given up by
+//   compressed rows are reused first. Otherwise the next slice gets committed.
+//   The memory is committed a page at a time, so that idle buffers only use as much
+//   memory as the rows that were actually written to.
+// Arguments:
+// - row - either an uncommitted (default constructed) row, which is initialized as a blank
+//   row, a compressed row, which gets expanded, or a committed row from a previous
+//   backing store, whose contents get moved over.
+// - fillAttributes - the attributes for the blank row, or any columns added by the move
+// Note: throws if the memory can't be committed
+void TextBuffer::_CommitRow(ROW& row, const TextAttribute& fillAttributes)
+{
+    static constexpr size_t pageSize = 4096;
+
+    size_t slice = 0;
+    if (!_freeRowSlices.empty())
+    {
+        slice = _freeRowSlices.back();
+        _freeRowSlices.pop_back();
+    }
+    else
+    {
+        slice = _commitWatermark++;
+
+        const auto rowEnd = (slice + 1) * _bufferRowStride;
+        if (rowEnd > _bufferCommitted)
+        {
+            const auto commitEnd = std::min((rowEnd + pageSize - 1) & ~(pageSize - 1), _bufferSize);
+            THROW_IF_NULL_ALLOC(VirtualAlloc(_charBuffer.get() + _bufferCommitted, commitEnd - _bufferCommitted, MEM_COMMIT, PAGE_READWRITE));
+            _bufferCommitted = commitEnd;
+        }
+    }
+
+    const auto data = _charBuffer.get() + slice * _bufferRowStride;
+    const auto chars = til::bit_cast<wchar_t*>(data);
+    const auto charOffsets = til::bit_cast<uint16_t*>(data + _bufferOffsetCharOffsets);
+
+    if (row.IsCompressed())
+    {
+        if (row.size() == _width)
+        {
+            row.Expand(chars, charOffsets);
+        }
+        else
+        {
+            // The row was compressed before the buffer got resized. Expand it into
+            // a temporary buffer of its old width, so that it can be resized.
+            const auto oldChars = std::make_unique_for_overwrite<wchar_t[]>(row.size());
+            const auto oldCharOffsets = std::make_unique_for_overwrite<uint16_t[]>(row.size() + 1u);
+            row.Expand(oldChars.get(), oldCharOffsets.get());
+            row.Resize(chars, charOffsets, _width, fillAttributes);
+        }
+    }
+    else if (row.size())
+    {
+        row.Resize(chars, charOffsets, _width, fillAttributes);
+    }
+    else
+    {
+        row = ROW{ chars, charOffsets, _width, fillAttributes };
+    }
+}
+
+// Routine Description:
+// - Compresses the given row if it's committed, making its slice of the backing store
+//   available to _CommitRow(). It gets expanded again once GetRowByOffset() hands it to a writer.
+// - Nobody may hold a reference to the row, which is why this is only called by CompressColdRows().
+// Arguments:
+// - index - the offset of the row from the first row of the buffer. Ignored if negative.
+void TextBuffer::_CompressColdRow(const til::CoordType index) noexcept
+{
+    if (index < 0)
+    {
+        return;
+    }
+
+    auto& row = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size());
+    if (!row.size() || row.IsCompressed())
+    {
+        return;
+    }
+
+    // Failing to compress a row only means that it keeps using more memory than necessary.
+    try
+    {
+        const auto chars = til::bit_cast<std::byte*>(row.Compress());
+        _freeRowSlices.emplace_back(gsl::narrow_cast<size_t>(chars - _charBuffer.get()) / _bufferRowStride);
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Turns all rows back into uncommitted ones and decommits the backing store.
+void TextBuffer::_DecommitRows() noexcept
+{
+    for (auto& row : _storage)
+    {
+        row = ROW{};
+    }
+
+    if (_bufferCommitted)
+    {
+        LOG_IF_WIN32_BOOL_FALSE(VirtualFree(_charBuffer.get(), _bufferCommitted, MEM_DECOMMIT));
+    }
+
+    _bufferCommitted = 0;
+    _commitWatermark = 0;
+    _freeRowSlices.clear();
+    _coldRows = 0;
+}
+
+// Routine Description:
+// - Returns an uncompressed copy of the given compressed row, decoded into one of the _decodedRows.
+//   The copy remains valid until as many other compressed rows were read, or until the buffer changes.
+// Arguments:
+// - row - a compressed row of this buffer
+// Return Value:
+// - The decoded copy, or a blank row if we failed to decode it.
+const ROW& TextBuffer::_GetDecodedRow(const ROW& row) const noexcept
+{
+    // A compressed row only changes after it was handed out for writing, which updates its revision.
+    for (const auto& decoded : _decodedRows)
+    {
+        if (decoded.source == &row && decoded.revision == row.GetRevision())
+        {
+            return decoded.row;
+        }
+    }
+
+    auto& decoded = til::at(_decodedRows, _nextDecodedRow);
+    _nextDecodedRow = (_nextDecodedRow + 1) % _decodedRows.size();
+    decoded.source = nullptr;
+
+    try
+    {
+        if (decoded.width != row.size())
+        {
+            decoded.chars = std::make_unique_for_overwrite<wchar_t[]>(row.size());
+            decoded.charOffsets = std::make_unique_for_overwrite<uint16_t[]>(row.size() + 1u);
+            decoded.width = row.size();
+        }
+
+        row.ExpandInto(decoded.row, decoded.chars.get(), decoded.charOffsets.get());
+        decoded.source = &row;
+        decoded.revision = row.GetRevision();
+        return decoded.row;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return _blankRow;
+    }
+}
+
+// Routine Description:
+// - The const GetRowByOffset() returns this row in place of rows that weren't committed yet,
+//   so it needs to be updated whenever the width or the _initialAttributes change.
+//   The same goes for the _discardRow, which the non-const one returns if committing fails.
+// - Any copies of compressed rows it handed out are discarded as well, as the rows they were
+//   decoded from might have changed width without being written to.
+void TextBuffer::_UpdateBlankRow()
+{
+    _blankRowChars = std::make_unique<wchar_t[]>(_width);
+    _blankRowCharOffsets = std::make_unique<uint16_t[]>(_width + 1u);
+    _blankRow = ROW{ _blankRowChars.get(), _blankRowCharOffsets.get(), _width, _initialAttributes };
+    _discardRowChars = std::make_unique<wchar_t[]>(_width);
+    _discardRowCharOffsets = std::make_unique<uint16_t[]>(_width + 1u);
+    _discardRow = ROW{ _discardRowChars.get(), _discardRowCharOffsets.get(), _width, _initialAttributes };
+
+    for (auto& decoded : _decodedRows)
+    {
+        decoded.source = nullptr;
+    }
+}
+
+// Routine Description:
+// - Returns the number of bytes of the backing store that are currently committed.
+size_t TextBuffer::GetCommittedBytes() const noexcept
+{
+    return _bufferCommitted;
 }
 
 // Routine Description:
@@ -445,7 +639,7 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     }
 
     //  Get the row and write the cells
-    auto& row = GetRowByOffset(target.Y);
+    auto& row = _GetRowForWriting(target.Y);
     const auto newIt = row.WriteCells(givenIt, target.X, wrap, limitRight);
 
     // Take the cell distance written and notify that it needs to be repainted.
@@ -456,6 +650,27 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Writes a run of text into a single row of the buffer. This is the bulk counterpart
+//   to Write(OutputCellIterator) and is meant for printing long runs of text.
+// - It's up to the caller to continue in the next row if state.text hasn't been fully consumed.
+// Arguments:
+// - row - The row to write the text to
+// - attributes - The attributes to apply to the written glyphs
+// - state - The text to write and the columns to write it to. See RowWriteState.
+void TextBuffer::Write(const til::CoordType row, const TextAttribute& attributes, RowWriteState& state)
+{
+    auto& r = _GetRowForWriting(row);
+
+    r.ReplaceText(state);
+    r.ReplaceAttributes(state.columnBegin, state.columnEnd, attributes);
+
+    if (state.columnEndDirty > state.columnBeginDirty)
+    {
+        TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, row, state.columnEndDirty, row + 1 }));
+    }
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -479,7 +694,7 @@ bool TextBuffer::InsertCharacter(const std::wstring_view chars,
         const auto iCol = GetCursor().GetPosition().X; // column logical and array positions are equal.
 
         // Get the row associated with the given logical position
-        auto& Row = GetRowByOffset(iRow);
+        auto& Row = _GetRowForWriting(iRow);
 
         // Store character and double byte data
         try
@@ -644,6 +859,12 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         // the current background color, but with no meta attributes set.
         fillAttributes.SetStandardErase();
     }
+    // The old "first row" is about to get cleared anyways. If it's still compressed
+    // there's no point in expanding it first, so just turn it into an uncommitted row.
+    if (auto& firstRow = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow)); firstRow.IsCompressed())
+    {
+        firstRow = ROW{};
+    }
     GetRowByOffset(0).Reset(fillAttributes);
     {
         // Now proceed to increment.
@@ -655,10 +876,78 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         {
             _firstRow = 0;
         }
+
+        // The absolute row numbers used by UpdatePatterns() wrap around long before they could overflow.
+        static constexpr til::CoordType scrolledOffRowsLimit = 1 << 30;
+        if (++_scrolledOffRows == scrolledOffRowsLimit)
+        {
+            _scrolledOffRows = 0;
+            _patternCache.clear();
+        }
     }
+    // The rows moved up by one, including those that were already compressed. Our callers only
+    // hold on to rows near the cursor, which makes this a safe point to compress
+    // the row that's now ColdRowDistance above the cursor.
+    _coldRows = std::max(_coldRows - 1, 0);
+    CompressColdRows();
     return true;
 }
 
+// Routine Description:
+// - Compresses all rows that are at least ColdRowDistance rows above the cursor. The viewport
+//   follows the cursor, which makes it unlikely that they're needed again soon.
+// - Compressing a row releases its chars, so this may only be called at a point where nobody
+//   holds a reference to any of the rows, like after a chunk of output was written.
+void TextBuffer::CompressColdRows() noexcept
+{
+    const auto coldEnd = std::min(_cursor.GetPosition().Y - ColdRowDistance + 1, TotalRowCount());
+    for (; _coldRows < coldEnd; ++_coldRows)
+    {
+        _CompressColdRow(_coldRows);
+    }
+}
+
+// Routine Description:
+// - Discards the scrollback: All rows of the circular buffer except
+//   for [top, top + height), which get moved to the top of the buffer.
+// - The discarded rows get decommitted and turn into blank rows with the given attributes.
+// Arguments:
+// - top - the first row to keep
+// - height - the number of rows to keep
+// - fillAttributes - the attributes of the discarded rows once they get used again
+void TextBuffer::ClearScrollback(const til::CoordType top, const til::CoordType height, const TextAttribute& fillAttributes)
+{
+    const auto totalRows = TotalRowCount();
+    const auto keepBeg = std::clamp(top, 0, totalRows);
+    const auto keepCount = gsl::narrow_cast<size_t>(std::clamp(height, 0, totalRows - keepBeg));
+
+    // Rotate the rows we keep to the front, which puts them at the top of the buffer.
+    std::rotate(_storage.begin(), _storage.begin() + (_firstRow + keepBeg) % totalRows, _storage.end());
+    _SetFirstRowIndex(0);
+    _coldRows = 0;
+
+    // Move the rows we keep into a new backing store. The old one gets released once we return,
+    // which decommits the discarded rows in one go, no matter how many there were.
+    const auto oldBuffer = _ReserveBuffer(GetSize().Dimensions());
+    _initialAttributes = fillAttributes;
+
+    const auto rows = std::span{ _storage };
+    for (auto& row : rows.first(keepCount))
+    {
+        if (row.size())
+        {
+            _CommitRow(row, fillAttributes);
+        }
+    }
+    for (auto& row : rows.subspan(keepCount))
+    {
+        row = ROW{};
+    }
+
+    _UpdateBlankRow();
+    _patternCache.clear();
+}
+
 //Routine Description:
 // - Retrieves the position of the last non-space character in the given
 //   viewport
@@ -747,7 +1036,7 @@ const Viewport TextBuffer::GetSize() const noexcept
 
 void TextBuffer::_UpdateSize()
 {
-    _size = Viewport::FromDimensions({ _storage.at(0).size(), gsl::narrow<til::CoordType>(_storage.size()) });
+    _size = Viewport::FromDimensions({ _width, gsl::narrow<til::CoordType>(_storage.size()) });
 }
 
 void TextBuffer::_SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept
@@ -850,6 +1139,9 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         // - end
         std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
     }
+
+    // Rows that were moved up might now be cold.
+    _coldRows = std::min(_coldRows, std::min(firstRow, firstRow + delta));
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -949,12 +1241,12 @@ til::point TextBuffer::BufferToScreenPosition(const til::point position) const n
 //   and the default current color attributes
 void TextBuffer::Reset()
 {
-    const auto attr = GetCurrentAttributes();
-
-    for (auto& row : _storage)
-    {
-        row.Reset(attr);
-    }
+    // Instead of resetting every single row, we decommit all of them. They get
+    // committed again and initialized with the current attributes once they're used.
+    _DecommitRows();
+    _initialAttributes = GetCurrentAttributes();
+    _UpdateBlankRow();
+    _patternCache.clear();
 }
 
 // Routine Description:
@@ -967,8 +1259,6 @@ void TextBuffer::Reset()
 {
     try
     {
-        BufferAllocator allocator{ newSize };
-
         const auto currentSize = GetSize().Dimensions();
         const auto attributes = GetCurrentAttributes();
 
@@ -982,22 +1272,29 @@ void TextBuffer::Reset()
         // rotate rows until the top row is at index 0
         std::rotate(_storage.begin(), _storage.begin() + TopRowIndex, _storage.end());
         _SetFirstRowIndex(0);
+        _coldRows = 0;
+
+        // Move the rows into a new backing store. The old one gets released once we return.
+        const auto oldBuffer = _ReserveBuffer(newSize);
 
         // realloc in the Y direction
         // remove rows if we're shrinking
-        _storage.resize(allocator.height());
+        _storage.resize(gsl::narrow_cast<size_t>(newSize.height));
 
         // realloc in the X direction
+        // Rows that were never committed don't need to be copied and remain uncommitted.
         for (auto& it : _storage)
         {
-            it.Resize(allocator.chars(), allocator.indices(), allocator.width(), attributes);
-            ++allocator;
+            if (it.size())
+            {
+                _CommitRow(it, attributes);
+            }
         }
 
         // Update the cached size value
         _UpdateSize();
-
-        _charBuffer = allocator.take();
+        _UpdateBlankRow();
+        _patternCache.clear();
     }
     CATCH_RETURN();
 
@@ -1353,7 +1650,13 @@ void TextBuffer::_PruneHyperlinks()
     // If the buffer does not contain the same reference, we can remove that hyperlink from our map
     // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
     // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = GetRowByOffset(0).GetHyperlinks();
+    // Only the attributes of the rows are needed, which compressed rows retain. Reading them
+    // directly avoids committing rows that were never used and expanding compressed ones.
+    const auto rowAttributes = [this](til::CoordType index) -> const ROW& {
+        const auto& row = til::at(_storage, gsl::narrow_cast<size_t>(_firstRow + index) % _storage.size());
+        return row.size() ? row : _blankRow;
+    };
+    const auto hyperlinks = rowAttributes(0).GetHyperlinks();
 
     if (!hyperlinks.empty())
     {
@@ -1369,7 +1672,7 @@ void TextBuffer::_PruneHyperlinks()
         // to see if those references are anywhere else
         for (til::CoordType i = 1; i < total; ++i)
         {
-            const auto nextRowRefs = GetRowByOffset(i).GetHyperlinks();
+            const auto nextRowRefs = rowAttributes(i).GetHyperlinks();
             for (auto id : nextRowRefs)
             {
                 if (firstRowRefs.find(id) != firstRowRefs.end())
@@ -2304,6 +2607,11 @@ void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::w
 //   can have different dimensions than the old buffer. If it does, then this
 //   function will attempt to maintain the logical contents of the old buffer,
 //   by continuing wrapped lines onto the next line in the new buffer.
+// - The whole buffer is reflowed in one go. The visible rows can't be reflowed
+//   ahead of the scrollback, because the row they end up on depends on how
+//   every line above them rewraps. The cursor, the viewport and positionInfo
+//   are all derived from the complete result as well, and the caller swaps in
+//   the new buffer as a whole while it's holding the console lock.
 // Arguments:
 // - oldBuffer - the text buffer to copy the contents FROM
 // - newBuffer - the text buffer to copy the contents TO
@@ -2315,7 +2623,7 @@ void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::w
 //   the new buffer. The rows's new value is placed back into this parameter.
 // Return Value:
 // - S_OK if we successfully copied the contents to the new buffer, otherwise an appropriate HRESULT.
-HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
+HRESULT TextBuffer::Reflow(const TextBuffer& oldBuffer,
                            TextBuffer& newBuffer,
                            const std::optional<Viewport> lastCharacterViewport,
                            std::optional<std::reference_wrapper<PositionInformation>> positionInfo)
@@ -2378,30 +2686,69 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
             }
         }
 
-        // Loop through every character in the current row (up to
-        // the "right" boundary, which is one past the final valid
-        // character)
+        // Copy the current row (up to the "right" boundary, which is one past the final valid
+        // character) into the new buffer, as many glyphs at a time as fit into the new row.
         til::CoordType iOldCol = 0;
         const auto copyRight = iRight;
-        for (; iOldCol < copyRight; iOldCol++)
+        while (iOldCol < copyRight)
         {
-            if (iOldCol == cOldCursorPos.X && iOldRow == cOldCursorPos.Y)
-            {
-                cNewCursorPos = newCursor.GetPosition();
-                fFoundCursorPos = true;
-            }
+            const auto newBufferCursor = newCursor.GetPosition();
 
             try
             {
-                // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
-                const auto glyph = row.GlyphAt(iOldCol);
-                const auto dbcsAttr = row.DbcsAttrAt(iOldCol);
-                const auto textAttr = row.GetAttrByColumn(iOldCol);
+                auto& newRow = newBuffer.GetRowByOffset(newBufferCursor.Y);
+                const auto newWidth = newBuffer.GetLineWidth(newBufferCursor.Y);
+
+                RowCopyTextFromState state{
+                    .source = row,
+                    .columnBegin = newBufferCursor.X,
+                    .columnLimit = newWidth,
+                    .sourceColumnBegin = iOldCol,
+                    .sourceColumnLimit = copyRight,
+                };
+                newRow.CopyTextFrom(state);
+
+                // Within a single copy each old column maps linearly onto a new one. If a wide glyph didn't fit,
+                // the padding column comes right after the copied glyphs and the cursor is placed on it
+                // in case it was on that glyph, just like the old per-character copy did.
+                const auto copiedEnd = newBufferCursor.X + (state.sourceColumnEnd - iOldCol);
+                const auto padded = state.columnEnd > copiedEnd;
+                if (!fFoundCursorPos && iOldRow == cOldCursorPos.Y && cOldCursorPos.X >= iOldCol &&
+                    (cOldCursorPos.X < state.sourceColumnEnd || (padded && cOldCursorPos.X == state.sourceColumnEnd)))
+                {
+                    cNewCursorPos = { newBufferCursor.X + (cOldCursorPos.X - iOldCol), newBufferCursor.Y };
+                    fFoundCursorPos = true;
+                }
 
-                if (!newBuffer.InsertCharacter(glyph, dbcsAttr, textAttr))
+                // Just like InsertCharacter() the last glyph's attributes extend to the end of the row.
+                if (state.sourceColumnEnd > iOldCol)
                 {
-                    hr = E_OUTOFMEMORY;
-                    break;
+                    newRow.SetAttrToEnd(copiedEnd, row.GetAttrByColumn(state.sourceColumnEnd - 1));
+                }
+                else if (newBufferCursor.X == 0)
+                {
+                    // Not even a single glyph fits into an empty row (a wide glyph in a 1 column wide buffer).
+                    // Skip it, since we'd otherwise keep padding rows forever.
+                    state.sourceColumnEnd = iOldCol + 1;
+                    for (; state.sourceColumnEnd < copyRight && row.DbcsAttrAt(state.sourceColumnEnd) == DbcsAttribute::Trailing; ++state.sourceColumnEnd)
+                    {
+                    }
+                }
+                iOldCol = state.sourceColumnEnd;
+
+                // Just like IncrementCursor() we wrap as soon as we've filled the last column.
+                if (state.columnEnd >= newWidth)
+                {
+                    newRow.SetWrapForced(true);
+                    if (!newBuffer.NewlineCursor())
+                    {
+                        hr = E_OUTOFMEMORY;
+                        break;
+                    }
+                }
+                else
+                {
+                    newCursor.SetXPosition(state.columnEnd);
                 }
             }
             CATCH_RETURN();
@@ -2429,22 +2776,17 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         //     move on.
         const auto newRowY = newCursor.GetPosition().Y;
         auto& newRow = newBuffer.GetRowByOffset(newRowY);
-        auto newAttrColumn = newCursor.GetPosition().X;
+        const auto newAttrColumn = newCursor.GetPosition().X;
         const auto newWidth = newBuffer.GetLineWidth(newRowY);
         // Stop when we get to the end of the buffer width, or the new position
         // for inserting an attr would be past the right of the new buffer.
-        for (auto copyAttrCol = iOldCol;
-             copyAttrCol < cOldColsTotal && newAttrColumn < newWidth;
-             copyAttrCol++, newAttrColumn++)
+        const auto copyAttrCount = std::min(cOldColsTotal - iOldCol, newWidth - newAttrColumn);
+        if (copyAttrCount > 0)
         {
             try
             {
-                // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
-                const auto textAttr = row.GetAttrByColumn(copyAttrCol);
-                if (!newRow.SetAttrToEnd(newAttrColumn, textAttr))
-                {
-                    break;
-                }
+                newRow.CopyAttributesFrom(row, iOldCol, newAttrColumn, newAttrColumn + copyAttrCount);
+                newRow.SetAttrToEnd(newAttrColumn + copyAttrCount, row.GetAttrByColumn(iOldCol + copyAttrCount - 1));
             }
             CATCH_LOG(); // Not worth dying over.
         }
@@ -2741,14 +3083,22 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 // Method Description:
 // - Adds a regex pattern we should search for
 // - The searching does not happen here, we only search when asked to by TerminalCore
+// - The pattern is compiled once here. UrlScanner::Pattern is special-cased and matched by UrlScanner.
 // Arguments:
 // - The regex pattern
 // Return value:
 // - An ID that the caller should associate with the given pattern
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
+    Pattern pattern;
+    if (regexString != UrlScanner::Pattern)
+    {
+        pattern.regex.emplace(regexString.data(), regexString.size());
+    }
+
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(_currentPatternId, std::move(pattern));
+    _patternCache.clear();
     return _currentPatternId;
 }
 
@@ -2758,6 +3108,7 @@ void TextBuffer::ClearPatternRecognizers() noexcept
 {
     _idsAndPatterns.clear();
     _currentPatternId = 0;
+    _patternCache.clear();
 }
 
 // Method Description:
@@ -2768,74 +3119,262 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 {
     _idsAndPatterns = OtherBuffer._idsAndPatterns;
     _currentPatternId = OtherBuffer._currentPatternId;
+    _patternCache.clear();
 }
 
 // Method Description:
 // - Finds patterns within the requested region of the text buffer
+// - Lines that wrap into or out of the region are searched in their entirety,
+//   up to PatternChunkHeight rows above the region.
 // Arguments:
 // - The firstRow to start searching from
 // - The lastRow to search
 // Return value:
-// - An interval tree containing the patterns found
+// - An interval tree containing the patterns found, relative to firstRow
 PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::CoordType lastRow) const
 {
     PointTree::interval_vector intervals;
 
-    std::wstring concatAll;
-    const auto rowSize = GetRowByOffset(0).size();
-    concatAll.reserve(gsl::narrow_cast<size_t>(rowSize) * gsl::narrow_cast<size_t>(lastRow - firstRow + 1));
+    const auto last = std::clamp(lastRow, 0, TotalRowCount() - 1);
+    auto row = _GetFirstPatternChunk(firstRow);
 
-    // to deal with text that spans multiple lines, we will first concatenate
-    // all the text into one string and find the patterns in that string
-    for (til::CoordType i = firstRow; i <= lastRow; ++i)
+    while (row <= last)
     {
-        auto& row = GetRowByOffset(i);
-        concatAll += row.GetText();
+        const auto height = _GetPatternChunkHeight(row, false);
+        _FindPatternsInChunk(row, height, -firstRow, intervals);
+        row += height;
     }
 
-    // for each pattern we know of, iterate through the string
-    for (const auto& idAndPattern : _idsAndPatterns)
+    return PointTree{ std::move(intervals) };
+}
+
+// Method Description:
+// - Same as GetPatterns(), but the results are relative to the absolute row 0
+//   (see GetScrolledOffRowCount()) and chunks are only searched again if any of
+//   the rows they span were handed out for writing since the last call. Matches
+//   in chunks outside of the region are forgotten.
+// - This is meant to be called repeatedly for the viewport, as text gets written.
+// Arguments:
+// - The firstRow to start searching from
+// - The lastRow to search
+// Return value:
+// - An interval tree containing the patterns found, keyed by absolute rows
+PointTree TextBuffer::UpdatePatterns(const til::CoordType firstRow, const til::CoordType lastRow)
+{
+    PointTree::interval_vector intervals;
+    decltype(_patternCache) cache;
+    std::vector<uint64_t> revisions;
+
+    const auto last = std::clamp(lastRow, 0, TotalRowCount() - 1);
+    auto row = _GetFirstPatternChunk(firstRow);
+
+    // Read the rows through a const reference, so that we don't mark them as modified.
+    const auto& buffer = *this;
+
+    while (row <= last)
     {
-        std::wregex regexObj{ idAndPattern.second };
+        const auto height = _GetPatternChunkHeight(row, false);
+        const auto absoluteRow = row + _scrolledOffRows;
+        const auto [scanBegin, scanEnd] = _GetPatternScanRange(row, height);
+
+        revisions.clear();
+        for (auto y = scanBegin; y < scanEnd; ++y)
+        {
+            revisions.emplace_back(buffer.GetRowByOffset(y).GetRevision());
+        }
 
-        // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
-        auto words_end = std::wsregex_iterator();
+        PatternCacheLine line;
+        if (auto node = _patternCache.extract(absoluteRow))
+        {
+            line = std::move(node.mapped());
+        }
 
-        til::CoordType lenUpToThis = 0;
-        for (auto i = words_begin; i != words_end; ++i)
+        if (line.revisions != revisions)
         {
-            // record the locations -
-            // when we find a match, the prefix is text that is between this
-            // match and the previous match, so we use the size of the prefix
-            // along with the size of the match to determine the locations
-            til::CoordType prefixSize = 0;
-            for (const auto parsedGlyph : Utf16Parser::Parse(i->prefix().str()))
+            line.revisions = revisions;
+            line.intervals.clear();
+            _FindPatternsInChunk(row, height, _scrolledOffRows, line.intervals);
+        }
+
+        intervals.insert(intervals.end(), line.intervals.begin(), line.intervals.end());
+        cache.emplace(absoluteRow, std::move(line));
+        row += height;
+    }
+
+    _patternCache = std::move(cache);
+    return PointTree{ std::move(intervals) };
+}
+
+// Method Description:
+// - Returns the number of rows that were scrolled out of the buffer by IncrementCircularBuffer().
+//   GetRowByOffset(y) is the absolute row y + GetScrolledOffRowCount(), which is what
+//   UpdatePatterns() uses to key its results, so that they remain valid as the buffer scrolls.
+// - It wraps around to 0 eventually, which invalidates any results keyed by the previous value.
+til::CoordType TextBuffer::GetScrolledOffRowCount() const noexcept
+{
+    return _scrolledOffRows;
+}
+
+// Method Description:
+// - Returns the first chunk that needs to be searched to find all patterns that overlap the given row.
+//   That's the chunk the row is in, or the one above it if the row's line started in there,
+//   because the matches that start in a chunk may extend beyond it.
+til::CoordType TextBuffer::_GetFirstPatternChunk(const til::CoordType firstRow) const noexcept
+{
+    auto row = std::clamp(firstRow, 0, TotalRowCount() - 1);
+    row -= _GetPatternChunkHeight(row, true) - 1;
+    if (row > 0 && GetRowByOffset(row - 1).WasWrapForced())
+    {
+        row -= _GetPatternChunkHeight(row - 1, true);
+    }
+    return row;
+}
+
+// Method Description:
+// - Measures the chunk of a line that is searched for patterns as a whole.
+// Arguments:
+// - row - a row of the chunk
+// - upwards - if true, returns the number of rows from the start of the chunk up to and
+//   including the given row. Otherwise, from the given row to the end of the chunk.
+// Return value:
+// - The number of rows
+til::CoordType TextBuffer::_GetPatternChunkHeight(const til::CoordType row, const bool upwards) const noexcept
+{
+    // A chunk ends after a row that wasn't wrapped, or if the next row is at a multiple of PatternChunkHeight.
+    const auto endsChunk = [&](const til::CoordType y) noexcept {
+        return !GetRowByOffset(y).WasWrapForced() || (y + 1 + _scrolledOffRows) % PatternChunkHeight == 0;
+    };
+
+    til::CoordType height = 1;
+    if (upwards)
+    {
+        for (auto y = row - 1; y >= 0 && !endsChunk(y); --y)
+        {
+            ++height;
+        }
+    }
+    else
+    {
+        for (auto y = row; y + 1 < TotalRowCount() && !endsChunk(y); ++y)
+        {
+            ++height;
+        }
+    }
+    return height;
+}
+
+// Method Description:
+// - Returns the rows that need to be read to find the patterns that start in the given chunk.
+//   If the chunk continues a line, the scan starts at the previous chunk, so that matches
+//   that start in there aren't mistaken for ones that start at the beginning of this chunk.
+//   It always continues until the end of the line, so that matches aren't cut off.
+// Arguments:
+// - row - the first row of the chunk
+// - height - the number of rows in the chunk
+// Return value:
+// - The range of rows [begin, end)
+std::pair<til::CoordType, til::CoordType> TextBuffer::_GetPatternScanRange(const til::CoordType row, const til::CoordType height) const noexcept
+{
+    auto begin = row;
+    if (begin > 0 && GetRowByOffset(begin - 1).WasWrapForced())
+    {
+        begin -= _GetPatternChunkHeight(begin - 1, true);
+    }
+
+    auto end = row + height;
+    while (end < TotalRowCount() && GetRowByOffset(end - 1).WasWrapForced())
+    {
+        ++end;
+    }
+
+    return { begin, end };
+}
+
+// Method Description:
+// - Finds all patterns that start in the given chunk. The matches are mapped back to cells
+//   through the rows, so there's no need to measure the width of the matched text.
+// Arguments:
+// - row - the first row of the chunk
+// - height - the number of rows in the chunk
+// - rowOffset - added to the row of every match
+// - intervals - receives the matches
+void TextBuffer::_FindPatternsInChunk(const til::CoordType row, const til::CoordType height, const til::CoordType rowOffset, PointTree::interval_vector& intervals) const
+{
+    if (_idsAndPatterns.empty())
+    {
+        return;
+    }
+
+    const auto [scanBegin, scanEnd] = _GetPatternScanRange(row, height);
+
+    // cells[i] is the cell that text[i] belongs to. The extra
+    // item at the end is the past-the-end cell of the line.
+    std::wstring text;
+    std::vector<til::point> cells;
+    // Only matches that start in [chunkBegin, chunkEnd) of the text belong to this chunk.
+    size_t chunkBegin = 0;
+    size_t chunkEnd = 0;
+
+    for (auto y = scanBegin; y < scanEnd; ++y)
+    {
+        if (y == row)
+        {
+            chunkBegin = text.size();
+        }
+        if (y == row + height)
+        {
+            chunkEnd = text.size();
+        }
+
+        const auto& r = GetRowByOffset(y);
+        const auto width = r.size();
+        for (til::CoordType x = 0; x < width; ++x)
+        {
+            if (r.DbcsAttrAt(x) != DbcsAttribute::Trailing)
             {
-                const std::wstring_view glyph{ parsedGlyph.data(), parsedGlyph.size() };
-                prefixSize += IsGlyphFullWidth(glyph) ? 2 : 1;
+                const auto glyph = r.GlyphAt(x);
+                text.append(glyph);
+                cells.insert(cells.end(), glyph.size(), til::point{ x, y + rowOffset });
             }
-            const auto start = lenUpToThis + prefixSize;
-            til::CoordType matchSize = 0;
-            for (const auto parsedGlyph : Utf16Parser::Parse(i->str()))
+        }
+    }
+    cells.emplace_back(0, scanEnd + rowOffset);
+    if (row + height == scanEnd)
+    {
+        chunkEnd = text.size();
+    }
+
+    for (const auto& idAndPattern : _idsAndPatterns)
+    {
+        const auto id = idAndPattern.first;
+        const auto& pattern = idAndPattern.second;
+        const auto addMatch = [&](const size_t begin, const size_t end) {
+            if (begin >= chunkBegin)
             {
-                const std::wstring_view glyph{ parsedGlyph.data(), parsedGlyph.size() };
-                matchSize += IsGlyphFullWidth(glyph) ? 2 : 1;
+                intervals.push_back(PointTree::interval(til::at(cells, begin), til::at(cells, end), id));
             }
-            const auto end = start + matchSize;
-            lenUpToThis = end;
-
-            const til::point startCoord{ start % rowSize, start / rowSize };
-            const til::point endCoord{ end % rowSize, end / rowSize };
+        };
 
-            // store the intervals
-            // NOTE: these intervals are relative to the VIEWPORT not the buffer
-            // Keeping these relative to the viewport for now because its the renderer
-            // that actually uses these locations and the renderer works relative to
-            // the viewport
-            intervals.push_back(PointTree::interval(startCoord, endCoord, idAndPattern.first));
+        if (pattern.regex)
+        {
+            const auto beg = text.data();
+            const auto end = beg + text.size();
+            for (auto it = std::wcregex_iterator{ beg, end, *pattern.regex }; it != std::wcregex_iterator{}; ++it)
+            {
+                const auto position = gsl::narrow_cast<size_t>(it->position());
+                if (position >= chunkEnd)
+                {
+                    break;
+                }
+                addMatch(position, position + gsl::narrow_cast<size_t>(it->length()));
+            }
+        }
+        else
+        {
+            for (auto match = UrlScanner::Find(text, 0); match && match->first < chunkEnd; match = UrlScanner::Find(text, match->second))
+            {
+                addMatch(match->first, match->second);
+            }
         }
     }
-    PointTree result(std::move(intervals));
-    return result;
 }
@@ -67,6 +67,10 @@ namespace Microsoft::Console::Render
 class TextBuffer final
 {
 public:
+    // Rows this far above the cursor are considered cold and get
+    // compressed by CompressColdRows() until they're written to again.
+    static constexpr til::CoordType ColdRowDistance = 256;
+
     TextBuffer(const til::size screenBufferSize,
                const TextAttribute defaultAttributes,
                const UINT cursorSize,
@@ -100,6 +104,8 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    void Write(til::CoordType row, const TextAttribute& attributes, RowWriteState& state);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -107,6 +113,11 @@ public:
 
     // Scroll needs access to this to quickly rotate around the buffer.
     bool IncrementCircularBuffer(const bool inVtMode = false);
+    void CompressColdRows() noexcept;
+
+    void ClearScrollback(const til::CoordType top, const til::CoordType height, const TextAttribute& fillAttributes);
+
+    size_t GetCommittedBytes() const noexcept;
 
     til::point GetLastNonSpaceCharacter(std::optional<const Microsoft::Console::Types::Viewport> viewOptional = std::nullopt) const;
 
@@ -205,7 +216,7 @@ public:
         til::CoordType visibleViewportTop{ 0 };
     };
 
-    static HRESULT Reflow(TextBuffer& oldBuffer,
+    static HRESULT Reflow(const TextBuffer& oldBuffer,
                           TextBuffer& newBuffer,
                           const std::optional<Microsoft::Console::Types::Viewport> lastCharacterViewport,
                           std::optional<std::reference_wrapper<PositionInformation>> positionInfo);
@@ -214,8 +225,45 @@ public:
     void ClearPatternRecognizers() noexcept;
     void CopyPatterns(const TextBuffer& OtherBuffer);
     interval_tree::IntervalTree<til::point, size_t> GetPatterns(const til::CoordType firstRow, const til::CoordType lastRow) const;
+    interval_tree::IntervalTree<til::point, size_t> UpdatePatterns(const til::CoordType firstRow, const til::CoordType lastRow);
+    til::CoordType GetScrolledOffRowCount() const noexcept;
 
 private:
+    // Wrapped rows are searched for patterns as a single line. For the sake of performance, long lines
+    // are split into chunks at every multiple of this many absolute rows, which are searched and cached
+    // individually. A match belongs to the chunk it starts in, but may extend beyond its end.
+    static constexpr til::CoordType PatternChunkHeight = 32;
+
+    struct Pattern
+    {
+        // nullopt if the pattern is UrlScanner::Pattern, which is matched by UrlScanner instead.
+        std::optional<std::wregex> regex;
+    };
+
+    struct PatternCacheLine
+    {
+        std::vector<uint64_t> revisions; // ROW::GetRevision() of each row that was scanned for the chunk
+        interval_tree::IntervalTree<til::point, size_t>::interval_vector intervals;
+    };
+
+    // An uncompressed copy of a compressed row, handed out by the const GetRowByOffset().
+    struct DecodedRow
+    {
+        const ROW* source = nullptr;
+        uint64_t revision = 0;
+        uint16_t width = 0;
+        std::unique_ptr<wchar_t[]> chars;
+        std::unique_ptr<uint16_t[]> charOffsets;
+        ROW row;
+    };
+
+    wil::unique_virtualalloc_ptr<std::byte> _ReserveBuffer(const til::size size);
+    ROW& _GetRowForWriting(const til::CoordType index);
+    void _CommitRow(ROW& row, const TextAttribute& fillAttributes);
+    void _CompressColdRow(til::CoordType index) noexcept;
+    const ROW& _GetDecodedRow(const ROW& row) const noexcept;
+    void _DecommitRows() noexcept;
+    void _UpdateBlankRow();
     void _UpdateSize();
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
     til::point _GetPreviousFromCursor() const noexcept;
@@ -232,6 +280,10 @@ private:
     til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
     til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
     void _PruneHyperlinks();
+    til::CoordType _GetFirstPatternChunk(const til::CoordType firstRow) const noexcept;
+    til::CoordType _GetPatternChunkHeight(const til::CoordType row, const bool upwards) const noexcept;
+    std::pair<til::CoordType, til::CoordType> _GetPatternScanRange(const til::CoordType row, const til::CoordType height) const noexcept;
+    void _FindPatternsInChunk(const til::CoordType row, const til::CoordType height, const til::CoordType rowOffset, interval_tree::IntervalTree<til::point, size_t>::interval_vector& intervals) const;
 
     static void _AppendRTFText(std::ostringstream& contentBuilder, const std::wstring_view& text);
 
@@ -241,12 +293,41 @@ private:
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId = 1;
 
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    std::unordered_map<size_t, Pattern> _idsAndPatterns;
     size_t _currentPatternId = 0;
-
+    // The matches of every chunk UpdatePatterns() looked at last time, keyed by the absolute row
+    // (= row offset + _scrolledOffRows) the chunk starts at. Chunks whose scanned rows all still
+    // have the same revision don't need to be searched again.
+    std::unordered_map<til::CoordType, PatternCacheLine> _patternCache;
+    uint64_t _lastRowRevision = 0;
+    til::CoordType _scrolledOffRows = 0;
+
+    // The chars and charOffsets of all rows are stored in _charBuffer, which is only reserved
+    // up front. Rows start out default constructed (uncommitted) and get the next _bufferRowStride
+    // bytes of _charBuffer assigned and committed the first time they're handed out for writing.
     wil::unique_virtualalloc_ptr<std::byte> _charBuffer;
+    size_t _bufferRowStride = 0;
+    size_t _bufferOffsetCharOffsets = 0;
+    size_t _bufferSize = 0;
+    size_t _bufferCommitted = 0;
+    size_t _commitWatermark = 0; // number of row slices that have been handed out
+    std::vector<size_t> _freeRowSlices; // slices given up by compressed rows
     std::vector<ROW> _storage;
+    std::unique_ptr<wchar_t[]> _blankRowChars;
+    std::unique_ptr<uint16_t[]> _blankRowCharOffsets;
+    ROW _blankRow;
+    // The non-const GetRowByOffset() hands out this row if it fails to commit the requested one.
+    std::unique_ptr<wchar_t[]> _discardRowChars;
+    std::unique_ptr<uint16_t[]> _discardRowCharOffsets;
+    ROW _discardRow;
+    // Compressed rows are only expanded in place once they're handed out for writing.
+    // Readers get a copy decoded into one of these, which are reused round-robin.
+    mutable std::array<DecodedRow, 4> _decodedRows;
+    mutable size_t _nextDecodedRow = 0;
+    til::CoordType _coldRows = 0; // rows [0, _coldRows) were already compressed by CompressColdRows()
     TextAttribute _currentAttributes;
+    TextAttribute _initialAttributes; // the attributes uncommitted rows get initialized with
+    uint16_t _width = 0;
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
 
     Cursor _cursor;
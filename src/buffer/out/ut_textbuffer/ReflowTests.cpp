@@ -289,6 +289,35 @@ namespace
                 },
             },
         },
+        TestCase{
+            L"DBCS, cursor on a wide glyph that gets padded onto the next row",
+            {
+                TestBuffer{
+                    { 6, 5 },
+                    {
+                        //--0123456--
+                        { L"ABCDカ", false }, // ABCD KA
+                        { L"      ", false },
+                        { L"      ", false },
+                        { L"      ", false },
+                        { L"      ", false },
+                    },
+                    { 4, 0 } // cursor on KA
+                },
+                TestBuffer{
+                    { 5, 5 }, // reduce width by 1
+                    {
+                        //--012345--
+                        { L"ABCD ", true }, // ABCD [FORCED SPACER]
+                        { L"カ   ", false }, // KA
+                        { L"     ", false },
+                        { L"     ", false },
+                        { L"     ", false },
+                    },
+                    { 4, 0 } // cursor stays on the spacer, where KA would have gone
+                },
+            },
+        },
         TestCase{
             L"SBCS, cursor remains in buffer, with circling, no original wrap",
             {
@@ -841,6 +870,57 @@ class ReflowTests
             _compareTextBufferAgainstTestBuffer(*textBuffer, testBuffer);
         }
     }
+
+    TEST_METHOD(TestReflowAttributes)
+    {
+        const TextAttribute fill{ 0x7 };
+        const TextAttribute a{ 0x1 };
+        const TextAttribute b{ 0x2 };
+        const TextAttribute c{ 0x3 };
+
+        TextBuffer buffer{ { 6, 5 }, fill, 0, false, renderer };
+        {
+            auto& row0 = buffer.GetRowByOffset(0);
+            RowWriteState state{ .text = L"ABCDE", .columnLimit = 6 };
+            row0.ReplaceText(state);
+            row0.ReplaceAttributes(0, 3, a);
+            row0.ReplaceAttributes(3, 5, b);
+            row0.ReplaceAttributes(5, 6, c);
+
+            auto& row1 = buffer.GetRowByOffset(1);
+            row1.ReplaceCharacters(0, 1, L"$");
+            row1.ReplaceAttributes(0, 1, c);
+            row1.ReplaceAttributes(1, 3, a);
+            row1.ReplaceAttributes(3, 6, b);
+        }
+        buffer.GetCursor().SetPosition({ 1, 1 });
+
+        const auto newBuffer = _textBufferByReflowingTextBuffer(buffer, { 4, 5 });
+
+        // The runs are sliced at the new row boundaries, the last glyph's attributes extend to the
+        // end of its row and the colored whitespace to the right of the text is carried over (GH#32).
+        const std::array<std::array<TextAttribute, 4>, 3> expected{ {
+            { a, a, a, b }, // ABCD
+            { b, c, c, c }, // E
+            { c, a, a, b }, // $
+        } };
+
+        for (til::CoordType y = 0; y < 3; ++y)
+        {
+            const auto& row = newBuffer->GetRowByOffset(y);
+            for (til::CoordType x = 0; x < 4; ++x)
+            {
+                VERIFY_ARE_EQUAL(til::at(til::at(expected, y), x), row.GetAttrByColumn(x), NoThrowString().Format(L"[Cell %d, %d]", x, y));
+            }
+        }
+
+        VERIFY_ARE_EQUAL(L"ABCD", newBuffer->GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(L"E   ", newBuffer->GetRowByOffset(1).GetText());
+        VERIFY_ARE_EQUAL(L"$   ", newBuffer->GetRowByOffset(2).GetText());
+        VERIFY_IS_TRUE(newBuffer->GetRowByOffset(0).WasWrapForced());
+        VERIFY_IS_FALSE(newBuffer->GetRowByOffset(1).WasWrapForced());
+        VERIFY_ARE_EQUAL(til::point(1, 2), newBuffer->GetCursor().GetPosition());
+    }
 };
 
 DummyRenderer ReflowTests::renderer{};
@@ -5,6 +5,7 @@
 #include "WexTestClass.h"
 #include "../../inc/consoletaeftemplates.hpp"
 #include "../../../renderer/inc/RenderSettings.hpp"
+#include "../../../types/inc/ColorFix.hpp"
 
 #include "../TextAttribute.hpp"
 
@@ -25,6 +26,7 @@ class TextAttributeTests
     TEST_METHOD(TestReverseDefaultColors);
     TEST_METHOD(TestRoundtripDefaultColors);
     TEST_METHOD(TestIntenseAsBright);
+    TEST_METHOD(TestPerceivableColorCache);
 
     RenderSettings _renderSettings;
     const COLORREF _defaultFg = RGB(1, 2, 3);
@@ -325,3 +327,45 @@ void TextAttributeTests::TestIntenseAsBright()
     // Restore the default IntenseIsBright mode.
     _renderSettings.SetRenderMode(RenderSettings::Mode::IntenseIsBright, true);
 }
+
+void TextAttributeTests::TestPerceivableColorCache()
+{
+    RenderSettings renderSettings;
+    renderSettings.SetRenderMode(RenderSettings::Mode::AlwaysDistinguishableColors, true);
+
+    // A heatmap of nearly indistinguishable foreground/background pairs, most of which need adjustment.
+    std::vector<TextAttribute> attrs;
+    std::vector<std::pair<COLORREF, COLORREF>> expected;
+    for (BYTE i = 0; i < 64; ++i)
+    {
+        const auto fg = RGB(i * 4, 128, 255 - i * 4);
+        const auto bg = RGB(i * 4 + 2, 130, 253 - i * 4);
+
+        TextAttribute attr;
+        attr.SetForeground(fg);
+        attr.SetBackground(bg);
+        attrs.emplace_back(attr);
+
+        const auto adjusted = Feature_AdjustIndistinguishableText::IsEnabled() ? ColorFix::GetPerceivableColor(fg, bg) : fg;
+        expected.emplace_back(adjusted, bg);
+    }
+
+    Log::Comment(L"The first lookup computes the colors, the second one hits the cache");
+    for (auto pass = 0; pass < 2; ++pass)
+    {
+        for (size_t i = 0; i < attrs.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected[i], renderSettings.GetAttributeColors(attrs[i]));
+        }
+    }
+
+    Log::Comment(L"Resolving all attributes at once yields the same colors, whether cached or not");
+    std::vector<std::pair<COLORREF, COLORREF>> actual(attrs.size());
+    renderSettings.GetAttributeColors(attrs, actual);
+    VERIFY_IS_TRUE(expected == actual);
+
+    renderSettings.MakeAdjustedColorArray();
+    std::fill(actual.begin(), actual.end(), std::pair<COLORREF, COLORREF>{});
+    renderSettings.GetAttributeColors(attrs, actual);
+    VERIFY_IS_TRUE(expected == actual);
+}
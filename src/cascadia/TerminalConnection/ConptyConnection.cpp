@@ -617,72 +617,180 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
 
     DWORD ConptyConnection::_OutputThread()
+    try
     {
         // Keep us alive until the output thread terminates; the destructor
         // won't wait for us, and the known exit points _do_.
         auto strongThis{ get_strong() };
 
-        // process the data of the output pipe in a loop
-        while (true)
+        // This thread only reads from the output pipe. Converting and parsing the output happens on a
+        // separate parse thread, so that reading the next chunk overlaps with processing the previous one.
+        // The buffers circulate between both threads: We take a free one, fill it with ReadFile() and
+        // pass it on to the parse thread, which returns it to us as soon as it has converted its contents.
+        const auto buffers = std::make_unique<char[]>(OutputChunkSize * OutputChunkCount);
+        auto [chunkProducer, chunkConsumer] = til::spsc::channel<OutputChunk>(OutputChunkCount);
+        auto [freeProducer, freeConsumer] = til::spsc::channel<char*>(OutputChunkCount);
+
+        for (size_t i = 0; i < OutputChunkCount; ++i)
         {
-            DWORD read{};
+            freeProducer.emplace(buffers.get() + i * OutputChunkSize);
+        }
 
-            const auto readFail{ !ReadFile(_outPipe.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), &read, nullptr) };
+        std::thread parseThread{ &ConptyConnection::_ParseThread, this, std::move(chunkConsumer), std::move(freeProducer) };
+        LOG_IF_FAILED(SetThreadDescription(parseThread.native_handle(), L"ConptyConnection Parse Thread"));
 
-            // When we call CancelSynchronousIo() in Close() this is the branch that's taken and gets us out of here.
-            if (_isStateAtOrBeyond(ConnectionState::Closing))
+        auto hr = S_OK;
+
+        {
+            // Once this producer is destroyed, the parse thread will flush any remaining output and exit.
+            const auto chunks = std::move(chunkProducer);
+
+            // process the data of the output pipe in a loop
+            while (true)
             {
-                return 0;
+                // This blocks while all buffers are in use by the parse thread and
+                // fails if the parse thread exited, in which case we're done as well.
+                const auto buffer = freeConsumer.pop();
+                if (!buffer || _isStateAtOrBeyond(ConnectionState::Closing))
+                {
+                    break;
+                }
+
+                DWORD read{};
+
+                const auto readFail{ !ReadFile(_outPipe.get(), *buffer, gsl::narrow_cast<DWORD>(OutputChunkSize), &read, nullptr) };
+
+                // When we call CancelSynchronousIo() in Close() this is the branch that's taken and gets us out of here.
+                if (_isStateAtOrBeyond(ConnectionState::Closing))
+                {
+                    break;
+                }
+
+                if (readFail) // reading failed (we must check this first, because read will also be 0.)
+                {
+                    const auto lastError = GetLastError();
+                    if (lastError != ERROR_BROKEN_PIPE)
+                    {
+                        hr = HRESULT_FROM_WIN32(lastError);
+                    }
+                    // else the parse thread will convert possible remaining partials to U+FFFD
+                    break;
+                }
+
+                if (read == 0 || !chunks.emplace(OutputChunk{ *buffer, read }))
+                {
+                    break;
+                }
             }
+        }
+
+        // Waiting for the parse thread ensures that anyone waiting for the output thread
+        // (_ClientTerminated() and Close()) knows that all output has been drained.
+        parseThread.join();
+
+        if (FAILED(hr) && !_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            // EXIT POINT
+            _indicateExitWithStatus(hr); // print a message
+            _transitionToState(ConnectionState::Failed);
+            return gsl::narrow_cast<DWORD>(hr);
+        }
+
+        return 0;
+    }
+    catch (...)
+    {
+        // EXIT POINT
+        // We failed to allocate the buffers or to start the parse thread.
+        const auto hr = wil::ResultFromCaughtException();
+        _indicateExitWithStatus(hr); // print a message
+        _transitionToState(ConnectionState::Failed);
+        return gsl::narrow_cast<DWORD>(hr);
+    }
+
+    // Method Description:
+    // - Converts the output read by the output thread from UTF-8 and passes it on to our event handlers.
+    //   If more than one chunk is ready by the time we get to it, all of them are concatenated and passed
+    //   on at once. This way a burst of output only acquires the terminal's lock and wakes up the
+    //   renderer once, instead of once per ReadFile().
+    // Arguments:
+    // - chunks: the output read by the output thread. Returns once the output thread dropped its end.
+    // - freeBuffers: the buffers of chunks that have been converted are returned to the output thread here.
+    void ConptyConnection::_ParseThread(til::spsc::consumer<OutputChunk> chunks, til::spsc::producer<char*> freeBuffers)
+    try
+    {
+        std::array<OutputChunk, OutputChunkCount> batch{};
+
+        while (true)
+        {
+            const auto [count, alive] = chunks.pop_n(til::spsc::block_initially, batch.begin(), batch.size());
+            auto result = S_OK;
+
+            _u16Str.clear();
 
-            if (readFail) // reading failed (we must check this first, because read will also be 0.)
+            for (const auto& chunk : gsl::make_span(batch.data(), count))
             {
-                const auto lastError = GetLastError();
-                if (lastError != ERROR_BROKEN_PIPE)
+                result = til::u8u16(std::string_view{ chunk.data, chunk.size }, _u16Chunk, _u8State);
+                // The buffer is of no use to us anymore, now that its contents have been converted.
+                freeBuffers.emplace(chunk.data);
+                if (FAILED(result))
                 {
-                    // EXIT POINT
-                    _indicateExitWithStatus(HRESULT_FROM_WIN32(lastError)); // print a message
-                    _transitionToState(ConnectionState::Failed);
-                    return gsl::narrow_cast<DWORD>(HRESULT_FROM_WIN32(lastError));
+                    break;
                 }
-                // else we call convertUTF8ChunkToUTF16 with an empty string_view to convert possible remaining partials to U+FFFD
+                _u16Str.append(_u16Chunk);
+            }
+
+            // If the output thread is gone, we call u8u16 with an empty string_view to convert possible remaining partials to U+FFFD.
+            if (SUCCEEDED(result) && !alive)
+            {
+                result = til::u8u16(std::string_view{}, _u16Chunk, _u8State);
+                _u16Str.append(_u16Chunk);
             }
 
-            const auto result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
             if (FAILED(result))
             {
                 // EXIT POINT
                 _indicateExitWithStatus(result); // print a message
                 _transitionToState(ConnectionState::Failed);
-                return gsl::narrow_cast<DWORD>(result);
-            }
-
-            if (_u16Str.empty())
-            {
-                return 0;
+                return;
             }
 
-            if (!_receivedFirstByte)
+            if (!_u16Str.empty())
             {
-                const auto now = std::chrono::high_resolution_clock::now();
-                const std::chrono::duration<double> delta = now - _startTime;
+                if (!_receivedFirstByte)
+                {
+                    const auto now = std::chrono::high_resolution_clock::now();
+                    const std::chrono::duration<double> delta = now - _startTime;
 
 #pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
-                TraceLoggingWrite(g_hTerminalConnectionProvider,
-                                  "ReceivedFirstByte",
-                                  TraceLoggingDescription("An event emitted when the connection receives the first byte"),
-                                  TraceLoggingGuid(_guid, "SessionGuid", "The WT_SESSION's GUID"),
-                                  TraceLoggingFloat64(delta.count(), "Duration"),
-                                  TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
-                                  TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
-                _receivedFirstByte = true;
+                    TraceLoggingWrite(g_hTerminalConnectionProvider,
+                                      "ReceivedFirstByte",
+                                      TraceLoggingDescription("An event emitted when the connection receives the first byte"),
+                                      TraceLoggingGuid(_guid, "SessionGuid", "The WT_SESSION's GUID"),
+                                      TraceLoggingFloat64(delta.count(), "Duration"),
+                                      TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                                      TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+                    _receivedFirstByte = true;
+                }
+
+                // Pass the output to our registered event handlers
+                _TerminalOutputHandlers(_u16Str);
             }
 
-            // Pass the output to our registered event handlers
-            _TerminalOutputHandlers(_u16Str);
+            if (!alive)
+            {
+                return;
+            }
         }
-
-        return 0;
+    }
+    catch (...)
+    {
+        // EXIT POINT
+        // One of our event handlers threw. Letting it escape this thread would call std::terminate().
+        // Dropping our ends of the channels on the way out makes the output thread exit as well.
+        LOG_CAUGHT_EXCEPTION();
+        _indicateExitWithStatus(wil::ResultFromCaughtException()); // print a message
+        _transitionToState(ConnectionState::Failed);
     }
 
     static winrt::event<NewConnectionHandler> _newConnectionHandlers;
@@ -7,6 +7,7 @@
 #include "ConnectionStateHolder.h"
 
 #include <conpty-static.h>
+#include <til/spsc.h>
 
 #include "ITerminalHandoff.h"
 
@@ -79,6 +80,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         hstring _startingDirectory{};
         hstring _startingTitle{};
         bool _initialVisibility{ true };
+        bool _passthroughMode{};
         Windows::Foundation::Collections::ValueSet _environment{ nullptr };
         guid _guid{}; // A unique session identifier for connected client
         hstring _clientName{}; // The name of the process hosted by this ConPTY connection (as of launch).
@@ -93,10 +95,23 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_static_pseudoconsole_handle _hPC;
         wil::unique_threadpool_wait _clientExitWait;
 
+        // A chunk of UTF-8 output, read by the output thread into one of its buffers.
+        struct OutputChunk
+        {
+            char* data = nullptr;
+            DWORD size = 0;
+        };
+
+        // The output thread reads into a ring of OutputChunkCount buffers of OutputChunkSize bytes each.
+        // Large reads mean fewer round trips through the pipe during heavy output, while the ring
+        // bounds how far the output thread can run ahead of the parse thread.
+        static constexpr size_t OutputChunkSize = 64 * 1024;
+        static constexpr uint32_t OutputChunkCount = 4;
+
+        // These are only accessed by the parse thread.
         til::u8state _u8State{};
         std::wstring _u16Str{};
-        std::array<char, 4096> _buffer{};
-        bool _passthroughMode{};
+        std::wstring _u16Chunk{};
 
         struct StartupInfoFromDefTerm
         {
@@ -108,6 +123,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         } _startupInfo{};
 
         DWORD _OutputThread();
+        void _ParseThread(til::spsc::consumer<OutputChunk> chunks, til::spsc::producer<char*> freeBuffers);
     };
 }
 
@@ -570,9 +570,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::UserScrollViewport(const int viewTop)
     {
-        // Clear the regex pattern tree so the renderer does not try to render them while scrolling
-        _terminal->ClearPatternTree();
-
         // This is a scroll event that wasn't initiated by the terminal
         //      itself - it was initiated by the mouse wheel, or the scrollbar.
         _terminal->UserScrollViewport(viewTop);
@@ -1360,12 +1357,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             return;
         }
-        // Clear the regex pattern tree so the renderer does not try to render them while scrolling
-        // We're **NOT** taking the lock here unlike _scrollbarChangeHandler because
-        // we are already under lock (since this usually happens as a result of writing).
-        // TODO GH#9617: refine locking around pattern tree
-        _terminal->ClearPatternTree();
-
         // Start the throttled update of our scrollbar.
         auto update{ winrt::make<ScrollPositionChangedArgs>(viewTop,
                                                             viewHeight,
@@ -1380,6 +1371,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // Additionally, start the throttled update of where our links are.
+        // The pattern tree is keyed by absolute rows and thus remains valid while
+        // scrolling. Only the rows that scrolled into view still need to be searched.
         (*_updatePatternLocations)();
     }
 
@@ -455,6 +455,8 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
 
     _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
 
+    // The pattern tree is keyed by the absolute rows of the old buffer.
+    ClearPatternTree();
     _mainBuffer.swap(newTextBuffer);
 
     // GH#3494: Maintain scrollbar position during resize
@@ -484,9 +486,20 @@ void Terminal::Write(std::wstring_view stringView)
 
     const auto& cursor = _activeBuffer().GetCursor();
     const til::point cursorPosBefore{ cursor.GetPosition() };
+    const auto scrolledOffRowsBefore = _activeBuffer().GetScrolledOffRowCount();
 
     _stateMachine->ProcessString(stringView);
 
+    // The absolute rows the pattern tree is keyed by wrapped around, which turns it into garbage.
+    // There's no need to invalidate it, as the contents of the viewport were scrolled anyway.
+    if (_activeBuffer().GetScrolledOffRowCount() < scrolledOffRowsBefore)
+    {
+        _patternIntervalTree = {};
+    }
+
+    // Now that the output was written, none of the rows are in use anymore.
+    _activeBuffer().CompressColdRows();
+
     const til::point cursorPosAfter{ cursor.GetPosition() };
 
     // Firing the CursorPositionChanged event is very expensive so we try not to
@@ -646,20 +659,30 @@ uint16_t Terminal::GetHyperlinkIdAtViewportPosition(const til::point viewportPos
 // - The interval representing the start and end coordinates
 std::optional<PointTree::interval> Terminal::GetHyperlinkIntervalFromViewportPosition(const til::point viewportPos)
 {
-    const auto results = _patternIntervalTree.findOverlapping({ viewportPos.X + 1, viewportPos.Y }, viewportPos);
-    if (results.size() > 0)
+    const auto offset = _PatternTreeViewportOffset();
+    const til::point pos{ viewportPos.x, viewportPos.y + offset };
+    const auto results = _patternIntervalTree.findOverlapping({ pos.x + 1, pos.y }, pos);
+    for (auto result : results)
     {
-        for (const auto& result : results)
+        if (result.value == _hyperlinkPatternId)
         {
-            if (result.value == _hyperlinkPatternId)
-            {
-                return result;
-            }
+            result.start.y -= offset;
+            result.stop.y -= offset;
+            return result;
         }
     }
     return std::nullopt;
 }
 
+// Method Description:
+// - _patternIntervalTree is keyed by absolute rows (see TextBuffer::UpdatePatterns()),
+//   so that it stays valid as the buffer scrolls. This returns the absolute row of the
+//   top of the visible viewport, which converts between the two coordinate spaces.
+til::CoordType Terminal::_PatternTreeViewportOffset() const noexcept
+{
+    return _VisibleStartIndex() + _activeBuffer().GetScrolledOffRowCount();
+}
+
 // Method Description:
 // - Send this particular (non-character) key event to the terminal.
 // - The terminal will translate the key and the modifiers pressed into the
@@ -841,11 +864,15 @@ void Terminal::FocusChanged(const bool focused) noexcept
 // - The interval tree containing regions that need to be invalidated
 void Terminal::_InvalidatePatternTree(const interval_tree::IntervalTree<til::point, size_t>& tree)
 {
-    const auto vis = _VisibleStartIndex();
+    // The tree is keyed by absolute rows. Intervals that were scrolled out of the buffer don't need to be invalidated.
+    const auto scrolledOffRows = _activeBuffer().GetScrolledOffRowCount();
     auto invalidate = [=](const PointTree::interval& interval) {
-        const til::point startCoord{ interval.start.x, interval.start.y + vis };
-        const til::point endCoord{ interval.stop.x, interval.stop.y + vis };
-        _InvalidateFromCoords(startCoord, endCoord);
+        const til::point startCoord{ interval.start.x, interval.start.y - scrolledOffRows };
+        const til::point endCoord{ interval.stop.x, interval.stop.y - scrolledOffRows };
+        if (startCoord.y >= 0)
+        {
+            _InvalidateFromCoords(startCoord, endCoord);
+        }
     };
     tree.visit_all(invalidate);
 }
@@ -1079,60 +1106,49 @@ Viewport Terminal::_GetVisibleViewport() const noexcept
 //       I had to make a bunch of hacks to get Japanese and emoji to work-ish.
 void Terminal::_WriteBuffer(const std::wstring_view& stringView)
 {
-    auto& cursor = _activeBuffer().GetCursor();
+    auto& buffer = _activeBuffer();
+    auto& cursor = buffer.GetCursor();
+    const auto attributes = buffer.GetCurrentAttributes();
 
     // Defer the cursor drawing while we are iterating the string, for a better performance.
     // We can not waste time displaying a cursor event when we know more text is coming right behind it.
     cursor.StartDeferDrawing();
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    // Instead of writing the string one character at a time, we hand TextBuffer as much of it
+    // as fits into the current row and only adjust the cursor (and potentially circle the buffer)
+    // once per row. RowWriteState::text is updated to contain the part that remains to be written.
+    RowWriteState state;
+    state.text = stringView;
+
+    while (!state.text.empty())
     {
-        const auto wch = stringView.at(i);
-        const auto cursorPosBefore = cursor.GetPosition();
-        auto proposedCursorPosition = cursorPosBefore;
+        auto proposedCursorPosition = cursor.GetPosition();
 
-        // TODO: MSFT 21006766
-        // This is not great but I need it demoable. Fix by making a buffer stream writer.
-        //
-        // If wch is a surrogate character we need to read 2 code units
-        // from the stringView to form a single code point.
-        const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
-        const auto view = stringView.substr(i, isSurrogate ? 2 : 1);
-        const OutputCellIterator it{ view, _activeBuffer().GetCurrentAttributes() };
-        const auto end = _activeBuffer().Write(it);
-        const auto cellDistance = end.GetCellDistance(it);
-        const auto inputDistance = end.GetInputDistance(it);
-
-        if (inputDistance > 0)
-        {
-            // If "wch" was a surrogate character, we just consumed 2 code units above.
-            // -> Increment "i" by 1 in that case and thus by 2 in total in this iteration.
-            proposedCursorPosition.X += cellDistance;
-            i += gsl::narrow_cast<size_t>(inputDistance - 1);
-        }
-        else
-        {
-            // If _WriteBuffer() is called with a consecutive string longer than the viewport/buffer width
-            // the call to _buffer->Write() will refuse to write anything on the current line.
-            // GetInputDistance() thus returns 0, which would in turn cause i to be
-            // decremented by 1 below and force the outer loop to loop forever.
-            // This if() basically behaves as if "\r\n" had been encountered above and retries the write.
-            // With well behaving shells during normal operation this safeguard should normally not be encountered.
-            proposedCursorPosition.X = 0;
-            proposedCursorPosition.Y++;
-
-            // Try the character again.
-            i--;
-
-            // If we write the last cell of the row here, TextBuffer::Write will
-            // mark this line as wrapped for us. If the next character we
-            // process is a newline, the Terminal::CursorLineFeed will unmark
-            // this line as wrapped.
+        state.columnBegin = proposedCursorPosition.X;
+        state.columnLimit = buffer.GetLineWidth(proposedCursorPosition.Y);
+        buffer.Write(proposedCursorPosition.Y, attributes, state);
+        proposedCursorPosition.X = state.columnEnd;
 
+        if (state.columnEnd >= state.columnLimit)
+        {
+            // If we filled the last cell of the row, mark this line as wrapped.
+            // If the next character we process is a newline, the Terminal::CursorLineFeed
+            // will unmark this line as wrapped.
+            buffer.GetRowByOffset(proposedCursorPosition.Y).SetWrapForced(true);
+
+            // If there's more text to come, it continues on the next line. If the string ended
+            // exactly at the end of the row, the cursor remains in the past-the-end column,
+            // just like it did when we wrote one character at a time.
+            //
             // TODO: GH#780 - This should really be a _deferred_ newline. If
             // the next character to come in is a newline or a cursor
             // movement or anything, then we should _not_ wrap this line
             // here.
+            if (!state.text.empty())
+            {
+                proposedCursorPosition.X = 0;
+                proposedCursorPosition.Y++;
+            }
         }
 
         _AdjustCursorPosition(proposedCursorPosition);
@@ -1140,8 +1156,8 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
 
     // Notify UIA of new text.
     // It's important to do this here instead of in TextBuffer, because here you have access to the entire line of text,
-    // whereas TextBuffer writes it one character at a time via the OutputCellIterator.
-    _activeBuffer().TriggerNewTextNotification(stringView);
+    // whereas TextBuffer writes it one row at a time.
+    buffer.TriggerNewTextNotification(stringView);
 
     cursor.EndDeferDrawing();
 }
@@ -1190,9 +1206,6 @@ void Terminal::_AdjustCursorPosition(const til::point proposedPosition)
                 }
             }
         }
-
-        // manually erase our pattern intervals since the locations have changed now
-        _patternIntervalTree = {};
     }
 
     // Update Cursor Position
@@ -1406,7 +1419,7 @@ bool Terminal::IsCursorBlinkingAllowed() const noexcept
 void Terminal::UpdatePatternsUnderLock()
 {
     auto oldTree = _patternIntervalTree;
-    _patternIntervalTree = _activeBuffer().GetPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _patternIntervalTree = _activeBuffer().UpdatePatterns(_VisibleStartIndex(), _VisibleEndIndex());
     _InvalidatePatternTree(oldTree);
     _InvalidatePatternTree(_patternIntervalTree);
 }
@@ -1663,11 +1676,7 @@ void Terminal::ColorSelection(const TextAttribute& attr, winrt::Microsoft::Termi
                 if (!text.empty())
                 {
                     Search search(*this, text, Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, { 0, 0 });
-
-                    while (search.FindNext())
-                    {
-                        search.Color(attr);
-                    }
+                    search.ColorAll(attr);
                 }
             }
         }
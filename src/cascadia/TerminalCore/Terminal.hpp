@@ -7,6 +7,7 @@
 
 #include "../../inc/DefaultSettings.h"
 #include "../../buffer/out/textBuffer.hpp"
+#include "../../buffer/out/UrlScanner.hpp"
 #include "../../renderer/inc/IRenderData.hpp"
 #include "../../terminal/adapter/ITerminalApi.hpp"
 #include "../../terminal/parser/StateMachine.hpp"
@@ -19,7 +20,7 @@
 
 #include <til/ticket_lock.h>
 
-static constexpr std::wstring_view linkPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
+static constexpr std::wstring_view linkPattern{ UrlScanner::Pattern };
 static constexpr size_t TaskbarMinProgress{ 10 };
 
 // You have to forward decl the ICoreSettings here, instead of including the header.
@@ -388,6 +389,7 @@ private:
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
     void _InvalidatePatternTree(const interval_tree::IntervalTree<til::point, size_t>& tree);
+    til::CoordType _PatternTreeViewportOffset() const noexcept;
     void _InvalidateFromCoords(const til::point start, const til::point end);
 
     // Since virtual keys are non-zero, you assume that this field is empty/invalid if it is.
@@ -201,6 +201,7 @@ void Terminal::UseAlternateScreenBuffer()
     const auto cursorSize = _mainBuffer->GetCursor().GetSize();
 
     ClearSelection();
+    ClearPatternTree();
     _mainBuffer->ClearPatternRecognizers();
 
     // Create a new alt buffer
@@ -252,6 +253,7 @@ void Terminal::UseMainScreenBuffer()
     }
 
     ClearSelection();
+    ClearPatternTree();
 
     // Copy our cursor state back to the main buffer's cursor
     {
@@ -474,7 +474,19 @@ void Terminal::SelectHyperlink(const SearchDirection dir)
     til::point searchEnd = dir == SearchDirection::Forward ? til::point{ bufferSize.RightInclusive(), _VisibleEndIndex() } : _selection->start;
 
     // 1.A) Try searching the current viewport (no scrolling required)
-    auto resultList = _patternIntervalTree.findContained(convertToSearchArea(searchStart), convertToSearchArea(searchEnd));
+    // The pattern tree is keyed by absolute rows, which are offset from the viewport's.
+    const auto patternTreeOffset = _PatternTreeViewportOffset();
+    const auto convertToPatternTree = [&](til::point pt) {
+        pt = convertToSearchArea(pt);
+        pt.y += patternTreeOffset;
+        return pt;
+    };
+    auto resultList = _patternIntervalTree.findContained(convertToPatternTree(searchStart), convertToPatternTree(searchEnd));
+    for (auto& interval : resultList)
+    {
+        interval.start.y -= patternTreeOffset;
+        interval.stop.y -= patternTreeOffset;
+    }
     std::optional<std::pair<til::point, til::point>> result = extractResultFromList(resultList);
     if (!result)
     {
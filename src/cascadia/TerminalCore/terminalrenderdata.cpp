@@ -106,7 +106,8 @@ const std::wstring Microsoft::Terminal::Core::Terminal::GetHyperlinkCustomId(uin
 const std::vector<size_t> Terminal::GetPatternId(const til::point location) const
 {
     // Look through our interval tree for this location
-    const auto intervals = _patternIntervalTree.findOverlapping({ location.X + 1, location.Y }, location);
+    const til::point pos{ location.x, location.y + _PatternTreeViewportOffset() };
+    const auto intervals = _patternIntervalTree.findOverlapping({ pos.x + 1, pos.y }, pos);
     if (intervals.size() == 0)
     {
         return {};
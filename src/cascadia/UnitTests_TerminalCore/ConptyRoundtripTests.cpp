@@ -234,6 +234,8 @@ class TerminalCoreUnitTests::ConptyRoundtripTests final
     TEST_METHOD(TestNoExtendedAttrsOptimization);
     TEST_METHOD(TestNoBackgroundAttrsOptimization);
 
+    TEST_METHOD(SkipUnchangedTextOnRepaint);
+
 private:
     bool _writeCallback(const char* const pch, const size_t cch);
     void _flushFirstFrame();
@@ -4331,3 +4333,49 @@ void ConptyRoundtripTests::TestNoBackgroundAttrsOptimization()
     Log::Comment(L"========== Check terminal buffer ==========");
     verifyBuffer(*termTb);
 }
+
+void ConptyRoundtripTests::SkipUnchangedTextOnRepaint()
+{
+    Log::Comment(L"Repaint a line the terminal already displays, and make sure "
+                 L"that only the parts that actually changed are sent to it.");
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& hostSm = si.GetStateMachine();
+    auto& termTb = *term->_mainBuffer;
+
+    _flushFirstFrame();
+
+    Log::Comment(L"========== Paint the initial line ==========");
+    hostSm.ProcessString(L"AAA BBB CCC");
+    expectedOutput.push_back("AAA BBB CCC");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    Log::Comment(L"========== Overwrite the line, changing its last word ==========");
+    hostSm.ProcessString(L"\rAAA BBB XYZ");
+    expectedOutput.push_back("\x1b[1;9H"); // Jump straight to the changed word
+    expectedOutput.push_back("XYZ");
+    expectedOutput.push_back("\x1b[?25h");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    Log::Comment(L"========== Overwrite the line with identical text ==========");
+    hostSm.ProcessString(L"\rAAA BBB XYZ");
+    // Nothing needs to be sent at all.
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(0u, expectedOutput.size());
+
+    Log::Comment(L"========== Recolor the middle word ==========");
+    _checkConptyOutput = false;
+    hostSm.ProcessString(L"\r\x1b[4C\x1b[32mBBB\x1b[m");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    TestUtils::VerifyExpectedString(termTb, L"AAA BBB XYZ ", { 0, 0 });
+
+    auto greenAttrs = TextAttribute();
+    greenAttrs.SetIndexedForeground(TextColor::DARK_GREEN);
+    TestUtils::VerifyLineContains(termTb, { 0, 0 }, L'A', TextAttribute(), 3u);
+    TestUtils::VerifyLineContains(termTb, { 4, 0 }, L'B', greenAttrs, 3u);
+    TestUtils::VerifyLineContains(termTb, { 8, 0 }, L'X', TextAttribute(), 1u);
+}
@@ -30,12 +30,16 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     _u8State{},
     _dwThreadId{ 0 },
     _exitRequested{ false },
-    _pfnSetLookingForDSR{}
+    _pfnSetLookingForDSR{},
+    _pDispatch{ nullptr },
+    _buffer{ std::make_unique<char[]>(ReadBufferSize) }
 {
     THROW_HR_IF(E_HANDLE, _hFile.get() == INVALID_HANDLE_VALUE);
 
     auto dispatch = std::make_unique<InteractDispatch>();
 
+    _pDispatch = dispatch.get();
+
     auto engine = std::make_unique<InputStateMachineEngine>(std::move(dispatch), inheritCursor);
 
     auto engineRef = engine.get();
@@ -70,14 +74,18 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
 
     try
     {
-        std::wstring wstr{};
-        auto hr = til::u8u16(u8Str, wstr, _u8State);
+        auto hr = til::u8u16(u8Str, _wstr, _u8State);
         // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
         if (FAILED(hr))
         {
             return S_FALSE;
         }
-        _pInputStateMachine->ProcessString(wstr);
+
+        // All the key events generated from this input are written into the input buffer as a single batch.
+        _pDispatch->BeginInputBatch();
+        const auto endBatch = wil::scope_exit([&]() noexcept { _pDispatch->EndInputBatch(); });
+
+        _pInputStateMachine->ProcessString(_wstr);
     }
     CATCH_RETURN();
 
@@ -99,6 +107,9 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 // Method Description:
 // - Do a single ReadFile from our pipe, and try and handle it. If handling
 //      failed, throw or log, depending on what the caller wants.
+// - Once the read returns, everything else that's already waiting in the pipe
+//      is read as well (up to the size of our buffer), so that a large paste
+//      is handled in a few large chunks instead of many small ones.
 // Arguments:
 // - throwOnFail: If true, throw an exception if there was an error processing
 //      the input received. Otherwise, log the error.
@@ -106,9 +117,8 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 // - <none>
 void VtInputThread::DoReadInput(const bool throwOnFail)
 {
-    char buffer[256];
     DWORD dwRead = 0;
-    auto fSuccess = !!ReadFile(_hFile.get(), buffer, ARRAYSIZE(buffer), &dwRead, nullptr);
+    auto fSuccess = !!ReadFile(_hFile.get(), _buffer.get(), ReadBufferSize, &dwRead, nullptr);
 
     // If we failed to read because the terminal broke our pipe (usually due
     //      to dying itself), close gracefully with ERROR_BROKEN_PIPE.
@@ -120,7 +130,26 @@ void VtInputThread::DoReadInput(const bool throwOnFail)
         return;
     }
 
-    auto hr = _HandleRunInput({ buffer, gsl::narrow_cast<size_t>(dwRead) });
+    // If draining the pipe fails, we'll still handle what we've got so far.
+    // The next call to DoReadInput() will then notice the broken pipe.
+    while (dwRead < ReadBufferSize)
+    {
+        DWORD available = 0;
+        if (!PeekNamedPipe(_hFile.get(), nullptr, 0, nullptr, &available, nullptr) || available == 0)
+        {
+            break;
+        }
+
+        DWORD read = 0;
+        if (!ReadFile(_hFile.get(), _buffer.get() + dwRead, std::min(available, ReadBufferSize - dwRead), &read, nullptr) || read == 0)
+        {
+            break;
+        }
+
+        dwRead += read;
+    }
+
+    auto hr = _HandleRunInput({ _buffer.get(), gsl::narrow_cast<size_t>(dwRead) });
     if (FAILED(hr))
     {
         if (throwOnFail)
@@ -16,6 +16,11 @@ Author(s):
 
 #include "../terminal/parser/StateMachine.hpp"
 
+namespace Microsoft::Console::VirtualTerminal
+{
+    class InteractDispatch;
+}
+
 namespace Microsoft::Console
 {
     class VtInputThread
@@ -41,6 +46,13 @@ namespace Microsoft::Console
         std::function<void(bool)> _pfnSetLookingForDSR;
 
         std::unique_ptr<Microsoft::Console::VirtualTerminal::StateMachine> _pInputStateMachine;
+        // Owned by the _pInputStateMachine's engine.
+        Microsoft::Console::VirtualTerminal::InteractDispatch* _pDispatch;
         til::u8state _u8State;
+
+        // Large enough to receive a sizeable paste with a single read, instead of hundreds.
+        static constexpr DWORD ReadBufferSize = 64 * 1024;
+        std::unique_ptr<char[]> _buffer;
+        std::wstring _wstr;
     };
 }
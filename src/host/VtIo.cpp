@@ -217,8 +217,14 @@ VtIo::VtIo() :
             }
             if (_pVtRenderEngine)
             {
-                _pVtRenderEngine->SetTerminalOwner(this);
+                _pVtRenderEngine->SetTerminalOwnerCallbacks([this]() { CloseOutput(); }, [this]() { NotifyOutputFailed(); });
                 _pVtRenderEngine->SetResizeQuirk(_resizeQuirk);
+
+                // Write from a background thread, so that a terminal that's
+                // slow to read our output doesn't stall rendering.
+                VtEngine::WritePolicy writePolicy;
+                writePolicy.async = true;
+                _pVtRenderEngine->SetWritePolicy(writePolicy);
             }
         }
     }
@@ -257,6 +263,8 @@ bool VtIo::IsUsingVt() const
         try
         {
             g.pRender->AddRenderEngine(_pVtRenderEngine.get());
+            // A frame that follows a pause is still painted right away, so keystroke echo isn't delayed.
+            g.pRender->SetRenderScheduler(std::make_shared<FramePacedRenderScheduler>(_framesPerSecond));
             g.getConsoleInformation().GetActiveOutputBuffer().SetTerminalConnection(_pVtRenderEngine.get());
             g.getConsoleInformation().GetActiveInputBuffer()->SetTerminalConnection(_pVtRenderEngine.get());
 
@@ -455,6 +463,19 @@ void VtIo::CloseOutput()
     g.getConsoleInformation().GetActiveOutputBuffer().SetTerminalConnection(nullptr);
 }
 
+// Method Description:
+// - Called by the VT renderer's writer thread once writing to the output pipe failed.
+//   CloseOutput() needs the console lock, which that thread can't take without risking
+//   a deadlock with the render thread. Instead we request a frame, at the start of which
+//   the VT renderer notices the failure and calls CloseOutput() from the render thread.
+void VtIo::NotifyOutputFailed() noexcept
+{
+    if (const auto pRender = ServiceLocator::LocateGlobals().pRender)
+    {
+        pRender->NotifyPaintFrame();
+    }
+}
+
 void VtIo::_shutdownNow()
 {
     // At this point, we no longer have a renderer or inthread. So we've
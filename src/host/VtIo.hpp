@@ -40,6 +40,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         [[noreturn]] void CloseInput();
         void CloseOutput();
+        void NotifyOutputFailed() noexcept;
 
         void BeginResize();
         void EndResize();
@@ -56,6 +57,10 @@ namespace Microsoft::Console::VirtualTerminal
         void SetWindowVisibility(bool showOrHide) noexcept;
 
     private:
+        // Every frame is written to the output pipe and parsed by the terminal on the other end.
+        // This caps how many of those heavy output can produce per second.
+        static constexpr DWORD _framesPerSecond = 120;
+
         // After CreateIoHandlers is called, these will be invalid.
         wil::unique_hfile _hInput;
         wil::unique_hfile _hOutput;
@@ -3,6 +3,8 @@
 
 #include "precomp.h"
 
+#include <bit>
+
 #include "ApiRoutines.h"
 
 #include "_stream.h"
@@ -302,6 +304,69 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
     return Status;
 }
 
+// Routine Description:
+// - Finds the end of the run of printable ASCII characters [0x20,0x7E] at the start of the given string.
+//   WriteCharsLegacy writes these as they are, each taking up exactly 1 column.
+// Arguments:
+// - text - The string to search.
+// Return Value:
+// - The index of the first character that isn't printable ASCII, or text.size() if there is none.
+static size_t FindEndOfPrintableAscii(const std::wstring_view text) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    const auto beg = text.data();
+    const auto end = beg + text.size();
+    auto it = beg;
+
+    // This works just like StateMachine's _findActionableFromGround(): "0x20 <= x && x <= 0x7E" is
+    // turned into the single unsigned comparison "x - 0x20 <= 0x5E", which SSE2 computes as the
+    // saturating subtraction "(x - 0x20) - 0x5E" being 0, for 8 characters at a time.
+    // The inverted movemask then has bits set for each character that isn't printable ASCII.
+#if defined(_M_AMD64)
+    const auto base = _mm_set1_epi16(L' ');
+    const auto limit = _mm_set1_epi16(L'~' - L' ');
+    const auto zero = _mm_setzero_si128();
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto printable = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, base), limit), zero);
+        const auto mask = ~static_cast<uint32_t>(_mm_movemask_epi8(printable)) & 0xffff;
+        if (mask)
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + std::countr_zero(mask) / 2;
+        }
+    }
+#elif defined(_M_ARM64)
+    const auto base = vdupq_n_u16(L' ');
+    const auto limit = vdupq_n_u16(L'~' - L' ');
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = vld1q_u16(reinterpret_cast<const uint16_t*>(it));
+        const auto printable = vcleq_u16(vsubq_u16(chars, base), limit);
+        const auto mask = ~vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(printable)), 0);
+        if (mask)
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + std::countr_zero(mask) / 8;
+        }
+    }
+#endif
+
+    for (; it != end; ++it)
+    {
+        if (*it < L' ' || *it > L'~')
+        {
+            break;
+        }
+    }
+
+    return gsl::narrow_cast<size_t>(it - beg);
+#pragma warning(pop)
+}
+
 // Routine Description:
 // - This routine writes a string to the screen, processing any embedded
 //   unicode characters.  The string is also copied to the input buffer, if
@@ -340,6 +405,9 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
     size_t TempNumSpaces = 0;
     const auto fUnprocessed = WI_IsFlagClear(screenInfo.OutputMode, ENABLE_PROCESSED_OUTPUT);
     const auto fWrapAtEOL = WI_IsFlagSet(screenInfo.OutputMode, ENABLE_WRAP_AT_EOL_OUTPUT);
+    // Runs of printable ASCII are written straight from the input string, see below.
+    // Delayed EOL wraps are rare enough that they're left to the general path.
+    const auto fAsciiFastPath = fWrapAtEOL && WI_IsFlagClear(dwFlags, WC_DELAY_EOL_WRAP);
 
     // Must not adjust cursor here. It has to stay on for many write scenarios. Consumers should call for the
     // cursor to be turned off if they want that.
@@ -384,8 +452,54 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             }
         }
 
-        // As an optimization, collect characters in buffer and print out all at once.
         XPosition = cursor.GetPosition().X;
+
+        // Fast path for the most common case: A run of printable ASCII. It needs neither the classification
+        // nor the width measurement below, so the run is written as a whole row segment at a time,
+        // without copying it into LocalBuffer first. Control characters still take the path below.
+        if (fAsciiFastPath && XPosition < coordScreenBufferSize.X)
+        {
+            const auto remaining = (BufferSize - *pcb) / sizeof(WCHAR);
+            const auto run = std::min(FindEndOfPrintableAscii({ lpString, remaining }), gsl::narrow_cast<size_t>(coordScreenBufferSize.X - XPosition));
+            if (run != 0)
+            {
+                CursorPosition = cursor.GetPosition();
+
+                RowWriteState state;
+                state.text = { lpString, run };
+                state.columnBegin = CursorPosition.X;
+                state.columnLimit = coordScreenBufferSize.X;
+                // Just like the general path, this doesn't touch the row's wrap flag, even if the run fills it.
+                textBuffer.Write(CursorPosition.Y, Attributes, state);
+
+                const auto columns = gsl::narrow_cast<til::CoordType>(run);
+                if (screenInfo.HasAccessibilityEventing())
+                {
+                    screenInfo.NotifyAccessibilityEventing(CursorPosition.X, CursorPosition.Y, CursorPosition.X + columns - 1, CursorPosition.Y);
+                }
+
+                TempNumSpaces += run;
+                lpString += run;
+                pwchRealUnicode += run;
+                pwchBuffer += run;
+                *pcb += run * sizeof(WCHAR);
+
+                CursorPosition.X += columns;
+                Status = AdjustCursorPosition(screenInfo, CursorPosition, WI_IsFlagSet(dwFlags, WC_KEEP_CURSOR_VISIBLE), psScrollY);
+
+                if (*pcb == BufferSize)
+                {
+                    if (nullptr != pcSpaces)
+                    {
+                        *pcSpaces = TempNumSpaces;
+                    }
+                    return STATUS_SUCCESS;
+                }
+                continue;
+            }
+        }
+
+        // As an optimization, collect characters in buffer and print out all at once.
         til::CoordType i = 0;
         auto LocalBufPtr = LocalBuffer;
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.X)
@@ -1047,15 +1161,20 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
     }
 
     const auto& textBuffer = screenInfo.GetTextBuffer();
-    return WriteChars(screenInfo,
-                      pwchBuffer,
-                      pwchBuffer,
-                      pwchBuffer,
-                      pcbBuffer,
-                      nullptr,
-                      textBuffer.GetCursor().GetPosition().X,
-                      WC_LIMIT_BACKSPACE,
-                      nullptr);
+    const auto status = WriteChars(screenInfo,
+                                   pwchBuffer,
+                                   pwchBuffer,
+                                   pwchBuffer,
+                                   pcbBuffer,
+                                   nullptr,
+                                   textBuffer.GetCursor().GetPosition().X,
+                                   WC_LIMIT_BACKSPACE,
+                                   nullptr);
+
+    // Now that the output was written, none of the rows are in use anymore.
+    // The buffer may have been replaced by a resize in the meantime, so we can't reuse textBuffer.
+    screenInfo.GetTextBuffer().CompressColdRows();
+    return status;
 }
 
 // Routine Description:
@@ -418,7 +418,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // Return Value:
 // - HRESULT indicating success or failure
 [[nodiscard]] static HRESULT _WriteConsoleInputWImplHelper(InputBuffer& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& events,
+                                                           const gsl::span<const INPUT_RECORD> events,
                                                            size_t& written,
                                                            const bool append) noexcept
 {
@@ -480,7 +480,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             context.StoreWritePartialByteSequence(std::move(partialEvent));
         }
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        const auto records = IInputEvent::ToInputRecords(events);
+        return _WriteConsoleInputWImplHelper(context, records, written, append);
     }
     CATCH_RETURN();
 }
@@ -505,13 +506,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
     LockConsole();
     auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
-    try
-    {
-        auto events = IInputEvent::Create(buffer);
-
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
-    }
-    CATCH_RETURN();
+    return _WriteConsoleInputWImplHelper(context, buffer, written, append);
 }
 
 // Routine Description:
@@ -728,7 +723,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer().GetTextBuffer();
         const auto storageSize = storageBuffer.GetSize().Dimensions();
 
@@ -766,40 +760,47 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        til::point targetPos;
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Copy the request out of the buffer one row at a time. Rows store their attributes as runs, which allows
+        // us to convert each run into the legacy format once, instead of converting the attributes of every cell.
+        const auto targetStride = gsl::narrow_cast<size_t>(targetSize.X);
+        const auto sourceWidth = gsl::narrow_cast<size_t>(std::max(0, clippedRequestRectangle.Width()));
+        for (til::CoordType y = 0; y < clippedRequestRectangle.Height(); ++y)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            // The user's buffer may be smaller than the request. Stop as soon as we run out of space.
+            const auto targetOffset = gsl::narrow_cast<size_t>(targetPoint.Y + y) * targetStride + gsl::narrow_cast<size_t>(targetPoint.X);
+            if (targetOffset >= targetBuffer.size())
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                ++sourceIter;
+                break;
             }
 
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            ++targetIter;
+            const auto count = gsl::narrow_cast<til::CoordType>(std::min(sourceWidth, targetBuffer.size() - targetOffset));
+            const auto& row = storageBuffer.GetRowByOffset(sourcePoint.Y + y);
+            const auto slice = row.GetSlice(sourcePoint.X, sourcePoint.X + count);
+            auto targetIter = targetBuffer.begin() + targetOffset;
+            auto column = slice.ColumnBegin();
 
-            // Increment the target
-            targetPos.X++;
-            if (targetPos.X >= targetSize.X)
+            for (const auto& run : slice.Attributes().runs())
             {
-                targetPos.X = 0;
-                targetPos.Y++;
+                const auto attributes = run.value.GetLegacyAttributes();
+
+                for (const auto columnEnd = column + run.length; column < columnEnd; ++column, ++targetIter)
+                {
+                    til::CoordType columns = 0;
+                    const auto glyph = slice.GlyphAt(column, columns);
+
+                    auto dbcsAttr = DbcsAttribute::Single;
+                    if (slice.IsTrailer(column))
+                    {
+                        dbcsAttr = DbcsAttribute::Trailing;
+                    }
+                    else if (columns > 1)
+                    {
+                        dbcsAttr = DbcsAttribute::Leading;
+                    }
+
+                    targetIter->Char.UnicodeChar = Utf16ToUcs2(glyph);
+                    targetIter->Attributes = attributes | GeneratePublicApiAttributeFormat(dbcsAttr);
+                }
             }
         }
 
@@ -926,7 +927,9 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
         const auto writeRectangle = Viewport::FromInclusive(writeRegion);
 
+        auto& textBuffer = storageBuffer.GetTextBuffer();
         auto target = writeRectangle.Origin();
+        std::wstring chars;
 
         // For every row in the request, create a view into the clamped portion of just the one line to write.
         // This allows us to restrict the width of the call without allocating/copying any memory by just making
@@ -944,9 +947,42 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             // Convert to a CHAR_INFO view to fit into the iterator
             const auto charInfos = gsl::span<const CHAR_INFO>(subspan.data(), subspan.size());
 
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
+            // Wide glyphs are given as separate leading and trailing halves, which need to be paired up.
+            // OutputCellIterator takes care of that, but is slow, because it processes one cell at a time.
+            const auto hasDbcs = std::any_of(charInfos.begin(), charInfos.end(), [](const CHAR_INFO& ci) {
+                return WI_IsAnyFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE | COMMON_LVB_TRAILING_BYTE);
+            });
+            if (hasDbcs)
+            {
+                // Make the iterator and write to the target position.
+                OutputCellIterator it(charInfos);
+                storageBuffer.Write(it, target);
+                continue;
+            }
+
+            // Otherwise every CHAR_INFO is exactly 1 column and we can write the entire row segment at once.
+            // Applications mostly use only a few colors, so we convert the attributes once per run of identical ones.
+            chars.resize(charInfos.size());
+            std::transform(charInfos.begin(), charInfos.end(), chars.begin(), [](const CHAR_INFO& ci) {
+                return ci.Char.UnicodeChar;
+            });
+
+            auto& row = textBuffer.GetRowByOffset(target.Y);
+            row.ReplaceColumns(target.X, chars);
+
+            for (size_t beg = 0; beg < charInfos.size();)
+            {
+                const auto legacyAttributes = til::at(charInfos, beg).Attributes;
+                auto end = beg + 1;
+                for (; end < charInfos.size() && til::at(charInfos, end).Attributes == legacyAttributes; ++end)
+                {
+                }
+
+                row.ReplaceAttributes(target.X + gsl::narrow_cast<til::CoordType>(beg), target.X + gsl::narrow_cast<til::CoordType>(end), TextAttribute{ legacyAttributes });
+                beg = end;
+            }
+
+            textBuffer.TriggerRedraw(Viewport::FromDimensions(target, { writeRectangle.Width(), 1 }));
         }
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
@@ -33,6 +33,35 @@ namespace Microsoft::Console::Render
     class VtEngine;
 }
 
+// A FIFO queue of INPUT_RECORDs, stored by value in a single growable ring buffer.
+// Once it has grown to fit the typical amount of pending input,
+// writing and reading records doesn't allocate anymore.
+class InputRecordRing
+{
+public:
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+
+    INPUT_RECORD& operator[](size_t index) noexcept;
+    const INPUT_RECORD& operator[](size_t index) const noexcept;
+    INPUT_RECORD& front() noexcept;
+    INPUT_RECORD& back() noexcept;
+
+    void push_back(const INPUT_RECORD& record);
+    void pop_front() noexcept;
+    void truncate(size_t count) noexcept;
+    void clear() noexcept;
+
+private:
+    void _grow();
+
+    std::unique_ptr<INPUT_RECORD[]> _buffer;
+    // The capacity is always a power of 2, so that indices can be wrapped with a mask.
+    size_t _capacity = 0;
+    size_t _head = 0;
+    size_t _size = 0;
+};
+
 class InputBuffer final : public ConsoleObjectHeader
 {
 public:
@@ -60,6 +89,13 @@ public:
     void Flush();
     void FlushAllButKeys();
 
+    [[nodiscard]] NTSTATUS Read(const gsl::span<INPUT_RECORD> outRecords,
+                                _Out_ size_t& eventsRead,
+                                const bool Peek,
+                                const bool WaitForData,
+                                const bool Unicode,
+                                const bool Stream);
+
     [[nodiscard]] NTSTATUS Read(_Out_ std::deque<std::unique_ptr<IInputEvent>>& OutEvents,
                                 const size_t AmountToRead,
                                 const bool Peek,
@@ -73,8 +109,10 @@ public:
                                 const bool Unicode,
                                 const bool Stream);
 
+    size_t Prepend(const gsl::span<const INPUT_RECORD> inRecords);
     size_t Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
+    size_t Write(const gsl::span<const INPUT_RECORD> inRecords);
     size_t Write(_Inout_ std::unique_ptr<IInputEvent> inEvent);
     size_t Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
@@ -84,7 +122,7 @@ public:
     void PassThroughWin32MouseRequest(bool enable);
 
 private:
-    std::deque<std::unique_ptr<IInputEvent>> _storage;
+    InputRecordRing _storage;
     std::unique_ptr<IInputEvent> _readPartialByteSequence;
     std::unique_ptr<IInputEvent> _writePartialByteSequence;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -96,22 +134,26 @@ private:
     // Otherwise, we should be calling them.
     bool _vtInputShouldSuppress{ false };
 
-    void _ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                     const size_t readCount,
+    void _ReadBuffer(const gsl::span<INPUT_RECORD> outRecords,
                      _Out_ size_t& eventsRead,
                      const bool peek,
                      _Out_ bool& resetWaitEvent,
                      const bool unicode,
                      const bool streamRead);
 
-    void _WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inRecords,
+    size_t _Prepend(const gsl::span<const INPUT_RECORD> inRecords, const bool fromApi);
+    size_t _Write(const gsl::span<const INPUT_RECORD> inRecords, const bool fromApi);
+
+    void _WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
+                      const bool fromApi,
                       _Out_ size_t& eventsWritten,
                       _Out_ bool& setWaitEvent);
 
-    bool _CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept;
-    bool _CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    bool _CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    void _HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    bool _CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept;
+    bool _CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord) noexcept;
+    bool _CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord) noexcept;
+    bool _HandleConsoleSuspensionEvent(const INPUT_RECORD& inRecord);
+    bool _HandleTerminalInput(const INPUT_RECORD& inRecord, const bool fromApi);
 
     void _HandleTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
@@ -92,23 +92,11 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
         }
     }
 
-    // 2. We can move any other scenario in-place without copying. We just have to carefully
-    //    choose which direction we walk through filling up the target so it doesn't accidentally
-    //    erase the source material before it can be copied/moved to the new location.
+    // 2. Any other scenario is copied into a packed rectangle first and then written to the target, a row at a time.
+    //    Since the rectangle is a copy, we don't need to worry about the target erasing the source before it was copied.
     {
-        const auto target = Viewport::FromDimensions(targetOrigin, source.Dimensions());
-        const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
-
-        auto sourcePos = source.GetWalkOrigin(walkDirection);
-        auto targetPos = target.GetWalkOrigin(walkDirection);
-
-        do
-        {
-            const auto data = OutputCell(*screenInfo.GetCellDataAt(sourcePos));
-            screenInfo.Write(OutputCellIterator({ &data, 1 }), targetPos);
-
-            source.WalkInBounds(sourcePos, walkDirection);
-        } while (target.WalkInBounds(targetPos, walkDirection));
+        const auto data = screenInfo.ReadRect(source);
+        screenInfo.WriteRect(data, targetOrigin);
     }
 }
 
@@ -450,7 +438,16 @@ void ScrollRegion(SCREEN_INFORMATION& screenInfo,
     for (size_t i = 0; i < remaining.size(); i++)
     {
         const auto& view = remaining.at(i);
-        screenInfo.WriteRect(fillData, view);
+
+        // Every row of the fill is the same. Write it into a packed row once and copy that into each row of the view.
+        OutputCellRect fillRow{ 1, view.Width(), screenInfo.GetAttributes() };
+        fillRow.GetRow(0).WriteCells(fillData, 0, false);
+        for (auto row = view.Top(); row < view.BottomExclusive(); ++row)
+        {
+            screenInfo.WriteRect(fillRow, { view.Left(), row });
+            // Filling the rows up to the right edge of the view unwraps them, just like WriteRect(OutputCellIterator) does.
+            screenInfo.GetTextBuffer().GetRowByOffset(row).SetWrapForced(false);
+        }
 
         // If we're scrolling an area that encompasses the full buffer width,
         // then the filled rows should also have their line rendition reset.
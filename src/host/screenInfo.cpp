@@ -2371,38 +2371,27 @@ OutputCellRect SCREEN_INFORMATION::ReadRect(const Viewport viewport) const
     // If the viewport given doesn't fit inside this screen, it's not a valid argument.
     THROW_HR_IF(E_INVALIDARG, !GetBufferSize().IsInBounds(viewport));
 
-    OutputCellRect result(viewport.Height(), viewport.Width());
-    const OutputCell paddingCell{ std::wstring_view{ &UNICODE_SPACE, 1 }, {}, GetAttributes() };
+    // Any cells that don't get copied, like halves of wide glyphs that are cut off by the viewport, remain whitespace.
+    OutputCellRect result(viewport.Height(), viewport.Width(), GetAttributes());
     for (til::CoordType rowIndex = 0, height = viewport.Height(); rowIndex < height; ++rowIndex)
     {
-        auto location = viewport.Origin();
-        location.Y += rowIndex;
-
-        auto data = GetCellLineDataAt(location);
-        const auto span = result.GetRow(rowIndex);
-        auto it = span.begin();
-
-        // Copy row data while there still is data and we haven't run out of rect to store it into.
-        while (data && it < span.end())
-        {
-            *it++ = *data++;
-        }
-
-        // Pad out any remaining space.
-        while (it < span.end())
+        const auto& source = _textBuffer->GetRowByOffset(viewport.Top() + rowIndex);
+        RowCopyTextFromState state{
+            .source = source,
+            .columnBegin = 0,
+            .columnLimit = viewport.Width(),
+            .sourceColumnBegin = viewport.Left(),
+            .sourceColumnLimit = viewport.RightExclusive(),
+        };
+
+        // CopyTextFrom() skips the trailing half of a wide glyph at the start of the range.
+        // Skip the corresponding column in the result as well, so that the columns stay aligned.
+        if (source.DbcsAttrAt(viewport.Left()) == DbcsAttribute::Trailing)
         {
-            *it++ = paddingCell;
+            state.columnBegin = 1;
         }
 
-        // if we're clipping a dbcs char then don't include it, add a space instead
-        if (span.begin()->DbcsAttr() == DbcsAttribute::Trailing)
-        {
-            *span.begin() = paddingCell;
-        }
-        if (span.rbegin()->DbcsAttr() == DbcsAttribute::Leading)
-        {
-            *span.rbegin() = paddingCell;
-        }
+        result.GetRow(rowIndex).CopyTextFrom(state);
     }
 
     return result;
@@ -2475,15 +2464,30 @@ OutputCellIterator SCREEN_INFORMATION::WriteRect(const OutputCellIterator it,
 void SCREEN_INFORMATION::WriteRect(const OutputCellRect& data,
                                    const til::point location)
 {
+    const auto bufferSize = GetBufferSize();
+
     for (til::CoordType i = 0; i < data.Height(); i++)
     {
-        const auto iter = data.GetRowIter(i);
-
         til::point point;
         point.X = location.X;
         point.Y = location.Y + i;
 
-        _textBuffer->WriteLine(iter, point);
+        if (!bufferSize.IsInBounds(point))
+        {
+            continue;
+        }
+
+        auto& row = _textBuffer->GetRowByOffset(point.Y);
+        RowCopyTextFromState state{
+            .source = data.GetRow(i),
+            .columnBegin = point.X,
+            .columnLimit = row.size(),
+            .sourceColumnBegin = 0,
+            .sourceColumnLimit = data.Width(),
+        };
+        row.CopyTextFrom(state);
+
+        _textBuffer->TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, point.Y, state.columnEndDirty, point.Y + 1 }));
     }
 }
 
@@ -709,10 +709,7 @@ bool Selection::_HandleColorSelection(const INPUT_KEY_INFO* const pInputKeyInfo)
                     Telemetry::Instance().LogColorSelectionUsed();
 
                     Search search(gci.renderData, str, Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
-                    while (search.FindNext())
-                    {
-                        search.Color(selectionAttr);
-                    }
+                    search.ColorAll(selectionAttr);
                 }
             }
             CATCH_LOG();
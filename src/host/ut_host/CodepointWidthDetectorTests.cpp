@@ -76,26 +76,48 @@ class CodepointWidthDetectorTests
 
     TEST_METHOD(AmbiguousCache)
     {
-        // Set up a detector with fallback.
+        // Set up a detector with a fallback that counts how often it's asked.
+        size_t fallbackCalls = 0;
         CodepointWidthDetector widthDetector;
-        widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
-
-        // Ensure fallback cache is empty.
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        widthDetector.SetFallbackMethod([&](const std::wstring_view glyph) {
+            ++fallbackCalls;
+            return FallbackMethod(glyph);
+        });
 
         // Lookup ambiguous width character.
-        widthDetector.IsWide(ambiguous);
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), widthDetector.IsWide(ambiguous));
+        VERIFY_ARE_EQUAL(1u, fallbackCalls);
 
         // Cache should hold it.
-        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), widthDetector.IsWide(ambiguous));
+        VERIFY_ARE_EQUAL(1u, fallbackCalls);
 
-        // Cached item should match what we expect
-        const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
-        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
+        // Wide and narrow characters don't need the fallback.
+        VERIFY_IS_TRUE(widthDetector.IsWide(emoji));
+        VERIFY_IS_FALSE(widthDetector.IsWide(L"a"));
+        VERIFY_ARE_EQUAL(1u, fallbackCalls);
 
-        // Cache should empty when font changes.
+        // Cache should be invalidated when the font changes.
         widthDetector.NotifyFontChanged();
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), widthDetector.IsWide(ambiguous));
+        VERIFY_ARE_EQUAL(2u, fallbackCalls);
+    }
+
+    TEST_METHOD(AmbiguousCacheCollisions)
+    {
+        // U+0414 and U+2014 share a cache entry. They must not be mistaken for each other.
+        static constexpr std::wstring_view other = L"\x2014"; // U+2014 em dash
+
+        size_t fallbackCalls = 0;
+        CodepointWidthDetector widthDetector;
+        widthDetector.SetFallbackMethod([&](const std::wstring_view glyph) {
+            ++fallbackCalls;
+            return glyph == ambiguous;
+        });
+
+        VERIFY_ARE_EQUAL(CodepointWidth::Wide, widthDetector.GetWidth(ambiguous));
+        VERIFY_ARE_EQUAL(CodepointWidth::Ambiguous, widthDetector.GetWidth(other));
+        VERIFY_ARE_EQUAL(CodepointWidth::Wide, widthDetector.GetWidth(ambiguous));
+        VERIFY_ARE_EQUAL(3u, fallbackCalls);
     }
 };
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../renderer/base/RenderScheduler.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace Microsoft::Console::Render;
+
+class RenderSchedulerTests
+{
+    TEST_CLASS(RenderSchedulerTests);
+
+    static FrameTiming MakeTiming(const uint64_t now, const uint64_t firstRequest, const uint64_t lastRequest, const uint64_t lastFrame)
+    {
+        FrameTiming timing;
+        timing.now = now;
+        timing.firstRequest = firstRequest;
+        timing.lastRequest = lastRequest;
+        timing.lastFrame = lastFrame;
+        return timing;
+    }
+
+    TEST_METHOD(LowLatencyPaintsRightAway)
+    {
+        const LowLatencyRenderScheduler scheduler;
+
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1000, 1000, 1000, 0)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1000, 1000, 1000, 999)));
+    }
+
+    TEST_METHOD(FramePacedWaitsForFrameInterval)
+    {
+        const FramePacedRenderScheduler scheduler{ 100 };
+
+        Log::Comment(L"A frame requested shortly after the previous one waits for the rest of the interval.");
+        VERIFY_ARE_EQUAL(6ul, scheduler.GetFrameDelay(MakeTiming(1004, 1002, 1004, 1000)));
+
+        Log::Comment(L"Once the interval passed, it's painted right away.");
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1010, 1002, 1008, 1000)));
+
+        Log::Comment(L"A frame that follows a pause isn't delayed.");
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(5000, 5000, 5000, 1000)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(5000, 5000, 5000, 0)));
+    }
+
+    TEST_METHOD(FramePacedClampsFrameRate)
+    {
+        Log::Comment(L"0 FPS is treated as 1 FPS instead of dividing by zero.");
+        const FramePacedRenderScheduler scheduler{ 0 };
+        VERIFY_ARE_EQUAL(999ul, scheduler.GetFrameDelay(MakeTiming(1001, 1001, 1001, 1000)));
+    }
+
+    TEST_METHOD(IdleWaitsForOutputToStop)
+    {
+        const IdleRenderScheduler scheduler{ 5, 20 };
+
+        Log::Comment(L"The frame is held until no request arrived for the idle delay.");
+        VERIFY_ARE_EQUAL(3ul, scheduler.GetFrameDelay(MakeTiming(1002, 1000, 1000, 0)));
+        VERIFY_ARE_EQUAL(4ul, scheduler.GetFrameDelay(MakeTiming(1011, 1000, 1010, 0)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1015, 1000, 1010, 0)));
+
+        Log::Comment(L"Output that doesn't stop still gets painted after the max delay.");
+        VERIFY_ARE_EQUAL(2ul, scheduler.GetFrameDelay(MakeTiming(1018, 1000, 1018, 0)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1020, 1000, 1020, 0)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1030, 1000, 1030, 0)));
+    }
+
+    TEST_METHOD(IdleMaxDelayIsAtLeastIdleDelay)
+    {
+        Log::Comment(L"A max delay shorter than the idle delay is raised to the idle delay.");
+        const IdleRenderScheduler scheduler{ 10, 5 };
+        VERIFY_ARE_EQUAL(4ul, scheduler.GetFrameDelay(MakeTiming(1006, 1000, 1006, 0)));
+        VERIFY_ARE_EQUAL(0ul, scheduler.GetFrameDelay(MakeTiming(1010, 1000, 1010, 0)));
+    }
+};
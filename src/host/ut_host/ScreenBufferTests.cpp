@@ -161,6 +161,9 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyPrintableRuns);
+    TEST_METHOD(WriteReadConsoleOutputRoundTrip);
+    TEST_METHOD(ReadRectWriteRectRoundTrip);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -2876,6 +2879,130 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, renderSettings.GetAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyPrintableRuns()
+{
+    // WriteCharsLegacy writes runs of printable ASCII a row segment at a time.
+    // Verify that they wrap and interleave with control characters the same way single characters do.
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const auto& tbi = si.GetTextBuffer();
+    auto& cursor = si.GetTextBuffer().GetCursor();
+    const auto width = si.GetBufferSize().Width();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, til::point(0, 0), true));
+    cursor.SetPosition({ 0, 0 });
+
+    Log::Comment(L"Write a line that's 5 columns too long, followed by a line with a tab in it.");
+    const auto str = std::wstring(width + 5, L'a') + L"\r\nxyz\tq";
+    auto seqCb = str.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str.data(), str.data(), str.data(), &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+    VERIFY_ARE_EQUAL(str.size() * sizeof(wchar_t), seqCb);
+
+    VERIFY_ARE_EQUAL(til::point(9, 2), cursor.GetPosition());
+
+    // The general path doesn't mark rows as wrapped (GH#780), and neither does the fast path.
+    const auto& row0 = tbi.GetRowByOffset(0);
+    VERIFY_ARE_EQUAL(std::wstring(width, L'a'), row0.GetText());
+    VERIFY_IS_FALSE(row0.WasWrapForced());
+
+    const auto& row1 = tbi.GetRowByOffset(1);
+    VERIFY_ARE_EQUAL(L"aaaaa" + std::wstring(width - 5, L' '), row1.GetText());
+    VERIFY_IS_FALSE(row1.WasWrapForced());
+
+    const auto& row2 = tbi.GetRowByOffset(2);
+    VERIFY_ARE_EQUAL(L"xyz     q" + std::wstring(width - 9, L' '), row2.GetText());
+
+    Log::Comment(L"Write the same overly long line, but with non-ASCII text, which takes the general path.");
+    cursor.SetPosition({ 0, 3 });
+    const auto str2 = std::wstring(width + 5, L'\u00e4') + L"\r\n";
+    seqCb = str2.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str2.data(), str2.data(), str2.data(), &seqCb, nullptr, cursor.GetPosition().X, 0, nullptr));
+    VERIFY_ARE_EQUAL(str2.size() * sizeof(wchar_t), seqCb);
+
+    const auto& row3 = tbi.GetRowByOffset(3);
+    VERIFY_ARE_EQUAL(std::wstring(width, L'\u00e4'), row3.GetText());
+    VERIFY_ARE_EQUAL(row0.WasWrapForced(), row3.WasWrapForced());
+
+    const auto& row4 = tbi.GetRowByOffset(4);
+    VERIFY_ARE_EQUAL(std::wstring(5, L'\u00e4') + std::wstring(width - 5, L' '), row4.GetText());
+    VERIFY_ARE_EQUAL(row1.WasWrapForced(), row4.WasWrapForced());
+}
+
+void ScreenBufferTests::WriteReadConsoleOutputRoundTrip()
+{
+    // WriteConsoleOutputW and ReadConsoleOutputW transfer rectangles a row at a time.
+    // Verify that the attribute runs survive a round trip and that partially overwritten wide glyphs get erased.
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+
+    VERIFY_SUCCEEDED(si.SetViewportOrigin(true, til::point(0, 0), true));
+
+    Log::Comment(L"Put a wide glyph into the columns 3 and 4 of the first two rows.");
+    si.GetTextBuffer().GetRowByOffset(0).ReplaceCharacters(3, 2, L"\u304B");
+    si.GetTextBuffer().GetRowByOffset(1).ReplaceCharacters(3, 2, L"\u304B");
+
+    Log::Comment(L"Write 2 rows of 3 cells at column 4, each cell with different attributes, except for the last 2.");
+    std::array<CHAR_INFO, 6> written{};
+    for (size_t i = 0; i < written.size(); ++i)
+    {
+        auto& ci = til::at(written, i);
+        ci.Char.UnicodeChar = gsl::narrow_cast<wchar_t>(L'a' + i);
+        ci.Attributes = gsl::narrow_cast<WORD>(i < 4 ? i + 1 : FOREGROUND_RED | BACKGROUND_BLUE);
+    }
+
+    auto writtenRectangle = Viewport::Empty();
+    VERIFY_SUCCEEDED(g.api->WriteConsoleOutputWImpl(si, written, Viewport::FromDimensions({ 4, 0 }, { 3, 2 }), writtenRectangle));
+    VERIFY_ARE_EQUAL(Viewport::FromDimensions({ 4, 0 }, { 3, 2 }).ToExclusive(), writtenRectangle.ToExclusive());
+
+    Log::Comment(L"Read the columns 3 to 6 of both rows back.");
+    std::array<CHAR_INFO, 8> read{};
+    auto readRectangle = Viewport::Empty();
+    VERIFY_SUCCEEDED(g.api->ReadConsoleOutputWImpl(si, read, Viewport::FromDimensions({ 3, 0 }, { 4, 2 }), readRectangle));
+    VERIFY_ARE_EQUAL(Viewport::FromDimensions({ 3, 0 }, { 4, 2 }).ToExclusive(), readRectangle.ToExclusive());
+
+    for (size_t y = 0; y < 2; ++y)
+    {
+        // The leading half of the wide glyph, whose trailing half got overwritten, must have been replaced with whitespace.
+        VERIFY_ARE_EQUAL(L' ', til::at(read, y * 4).Char.UnicodeChar);
+
+        for (size_t x = 0; x < 3; ++x)
+        {
+            const auto& expected = til::at(written, y * 3 + x);
+            const auto& actual = til::at(read, y * 4 + x + 1);
+            VERIFY_ARE_EQUAL(expected.Char.UnicodeChar, actual.Char.UnicodeChar);
+            VERIFY_ARE_EQUAL(expected.Attributes, actual.Attributes);
+        }
+    }
+}
+
+void ScreenBufferTests::ReadRectWriteRectRoundTrip()
+{
+    // ReadRect() and WriteRect() save and restore the contents below popups.
+    // Wide glyphs that are cut in half by the rectangle must be replaced with whitespace.
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    auto& tbi = si.GetTextBuffer();
+
+    Log::Comment(L"Write \"a\u304Bbc\u304B\" into the first row, with the wide glyphs at columns 1-2 and 5-6.");
+    RowWriteState state{ .text = L"a\u304Bbc\u304B", .columnLimit = 10 };
+    tbi.GetRowByOffset(0).ReplaceText(state);
+
+    Log::Comment(L"Read the columns 2 to 5, which cuts both wide glyphs in half.");
+    const auto rect = si.ReadRect(Viewport::FromDimensions({ 2, 0 }, { 4, 1 }));
+    VERIFY_ARE_EQUAL(4, rect.Width());
+    VERIFY_ARE_EQUAL(1, rect.Height());
+    VERIFY_ARE_EQUAL(L" bc ", rect.GetRow(0).GetText());
+
+    Log::Comment(L"Write it to the second row at column 1.");
+    si.WriteRect(rect, { 1, 1 });
+    VERIFY_ARE_EQUAL(L"  bc ", tbi.GetRowByOffset(1).GetText().substr(0, 5));
+    VERIFY_ARE_EQUAL(tbi.GetRowByOffset(0).GetAttrByColumn(3), tbi.GetRowByOffset(1).GetAttrByColumn(2));
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
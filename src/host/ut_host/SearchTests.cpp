@@ -158,4 +158,50 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    TEST_METHOD(FindAllResults)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"ab", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+        const auto& results = s.GetResults();
+        VERIFY_ARE_EQUAL(4u, results.size());
+        for (til::CoordType y = 0; y < 4; ++y)
+        {
+            VERIFY_ARE_EQUAL(til::point(0, y), til::at(results, y).start);
+            VERIFY_ARE_EQUAL(til::point(1, y), til::at(results, y).end);
+        }
+    }
+
+    TEST_METHOD(ForwardWrappedLine)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto lastColumn = textBuffer.GetSize().RightInclusive();
+
+        // Row 1 wraps into row 2, but row 0 doesn't wrap into row 1.
+        textBuffer.GetRowByOffset(0).ReplaceCharacters(lastColumn, 1, L"X");
+        textBuffer.GetRowByOffset(1).ReplaceCharacters(lastColumn, 1, L"X");
+
+        Search s(gci.renderData, L"XA", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL(til::point(lastColumn, 1), s._coordSelStart);
+        VERIFY_ARE_EQUAL(til::point(0, 2), s._coordSelEnd);
+        VERIFY_IS_FALSE(s.FindNext());
+    }
+
+    TEST_METHOD(ForwardRegularExpression)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        // "C.D" spans the wide glyph \x304d between C and D.
+        Search s(gci.renderData, L"c.d", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, Search::Mode::RegularExpression);
+        for (til::CoordType y = 0; y < 4; ++y)
+        {
+            VERIFY_IS_TRUE(s.FindNext());
+            VERIFY_ARE_EQUAL(til::point(4, y), s._coordSelStart);
+            VERIFY_ARE_EQUAL(til::point(7, y), s._coordSelEnd);
+        }
+        VERIFY_IS_FALSE(s.FindNext());
+    }
 };
@@ -12,6 +12,7 @@
 
 #include "globals.h"
 #include "../buffer/out/textBuffer.hpp"
+#include "../buffer/out/UrlScanner.hpp"
 
 #include "input.h"
 #include "_stream.h"
@@ -26,6 +27,8 @@ using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
 
+using PointTree = interval_tree::IntervalTree<til::point, size_t>;
+
 class TextBufferTests
 {
     DummyRenderer _renderer;
@@ -147,6 +150,10 @@ class TextBufferTests
 
     TEST_METHOD(TestBurrito);
     TEST_METHOD(TestOverwriteChars);
+    TEST_METHOD(TestReplaceText);
+    TEST_METHOD(TestLazyCommit);
+    TEST_METHOD(TestColdRows);
+    TEST_METHOD(TestPatternDetection);
 
     TEST_METHOD(TestAppendRTFText);
 
@@ -154,6 +161,7 @@ class TextBufferTests
     TEST_METHOD(GetWordBoundaries);
     TEST_METHOD(MoveByWord);
     TEST_METHOD(GetGlyphBoundaries);
+    TEST_METHOD(GetRowSlice);
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetText);
@@ -2047,6 +2055,366 @@ void TextBufferTests::TestOverwriteChars()
 #undef complex1
 }
 
+void TextBufferTests::TestReplaceText()
+{
+    til::size bufferSize{ 10, 3 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    auto& row = buffer.GetRowByOffset(0);
+
+// U+30A2 KATAKANA LETTER A (2 columns wide)
+#define wide L"\u30A2"
+// U+1F32F BURRITO (2 columns wide)
+#define burrito L"\U0001F32F"
+
+    Log::Comment(L"ASCII text is written up to the column limit and the remainder is returned.");
+    {
+        RowWriteState state;
+        state.text = L"0123456789AB";
+        state.columnBegin = 0;
+        state.columnLimit = 10;
+        row.ReplaceText(state);
+        VERIFY_ARE_EQUAL(L"0123456789", row.GetText());
+        VERIFY_ARE_EQUAL(L"AB", state.text);
+        VERIFY_ARE_EQUAL(10, state.columnEnd);
+        VERIFY_ARE_EQUAL(0, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(10, state.columnEndDirty);
+    }
+
+    Log::Comment(L"Wide glyphs and surrogate pairs are measured and copied alongside ASCII.");
+    {
+        RowWriteState state;
+        state.text = L"a" wide L"b" burrito L"c";
+        state.columnBegin = 1;
+        state.columnLimit = 10;
+        row.ReplaceText(state);
+        VERIFY_ARE_EQUAL(L"0a" wide L"b" burrito L"c89", row.GetText());
+        VERIFY_ARE_EQUAL(L"", state.text);
+        VERIFY_ARE_EQUAL(8, state.columnEnd);
+        VERIFY_IS_TRUE(DbcsAttribute::Leading == row.DbcsAttrAt(2));
+        VERIFY_IS_TRUE(DbcsAttribute::Trailing == row.DbcsAttrAt(3));
+        VERIFY_IS_TRUE(DbcsAttribute::Leading == row.DbcsAttrAt(5));
+        VERIFY_IS_TRUE(DbcsAttribute::Trailing == row.DbcsAttrAt(6));
+    }
+
+    Log::Comment(L"Overwriting half of a wide glyph replaces the other half with whitespace.");
+    {
+        RowWriteState state;
+        state.text = L"xy";
+        state.columnBegin = 3;
+        state.columnLimit = 10;
+        row.ReplaceText(state);
+        VERIFY_ARE_EQUAL(L"0a xy" burrito L"c89", row.GetText());
+        VERIFY_ARE_EQUAL(5, state.columnEnd);
+        VERIFY_ARE_EQUAL(2, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(5, state.columnEndDirty);
+
+        state.text = L"z";
+        state.columnBegin = 5;
+        row.ReplaceText(state);
+        VERIFY_ARE_EQUAL(L"0a xyz c89", row.GetText());
+        VERIFY_ARE_EQUAL(6, state.columnEnd);
+        VERIFY_ARE_EQUAL(5, state.columnBeginDirty);
+        VERIFY_ARE_EQUAL(7, state.columnEndDirty);
+    }
+
+    Log::Comment(L"A wide glyph that doesn't fit into the last column pads the row.");
+    {
+        RowWriteState state;
+        state.text = L"12" wide;
+        state.columnBegin = 7;
+        state.columnLimit = 10;
+        row.ReplaceText(state);
+        VERIFY_ARE_EQUAL(L"0a xyz 12 ", row.GetText());
+        VERIFY_ARE_EQUAL(wide, state.text);
+        VERIFY_ARE_EQUAL(10, state.columnEnd);
+        VERIFY_IS_TRUE(row.WasDoubleBytePadded());
+    }
+
+    Log::Comment(L"Unpaired surrogates are replaced with U+FFFD.");
+    {
+        RowWriteState state;
+        state.text = L"\xD83C-\xDF2F";
+        state.columnBegin = 0;
+        state.columnLimit = 10;
+        row.ReplaceText(state);
+        VERIFY_IS_TRUE(row.GetText().starts_with(L"\xFFFD-\xFFFD"));
+        VERIFY_ARE_EQUAL(L"", state.text);
+    }
+
+    Log::Comment(L"TextBuffer::Write() applies the given attributes to the written columns.");
+    {
+        const TextAttribute red{ FOREGROUND_RED };
+        RowWriteState state;
+        state.text = L"ab";
+        state.columnBegin = 2;
+        state.columnLimit = 10;
+        buffer.Write(1, red, state);
+        const auto& row1 = buffer.GetRowByOffset(1);
+        VERIFY_ARE_EQUAL(L"  ab      ", row1.GetText());
+        VERIFY_ARE_EQUAL(attr, row1.GetAttrByColumn(1));
+        VERIFY_ARE_EQUAL(red, row1.GetAttrByColumn(2));
+        VERIFY_ARE_EQUAL(red, row1.GetAttrByColumn(3));
+        VERIFY_ARE_EQUAL(attr, row1.GetAttrByColumn(4));
+    }
+
+#undef burrito
+#undef wide
+}
+
+void TextBufferTests::TestLazyCommit()
+{
+    til::size bufferSize{ 120, 9001 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    const auto& constBuffer = buffer;
+
+    Log::Comment(L"A new buffer doesn't commit any rows.");
+    VERIFY_ARE_EQUAL(0u, buffer.GetCommittedBytes());
+
+    Log::Comment(L"Reading rows that were never written to doesn't commit them.");
+    VERIFY_ARE_EQUAL(std::wstring(120, L' '), constBuffer.GetRowByOffset(5000).GetText());
+    VERIFY_ARE_EQUAL(attr, constBuffer.GetRowByOffset(5000).GetAttrByColumn(119));
+    VERIFY_ARE_EQUAL(0u, buffer.GetCommittedBytes());
+
+    Log::Comment(L"Accessing a row for writing commits a single page.");
+    buffer.GetRowByOffset(5000).ReplaceCharacters(0, 1, L"a");
+    VERIFY_ARE_EQUAL(4096u, buffer.GetCommittedBytes());
+    VERIFY_ARE_EQUAL(L"a", constBuffer.GetRowByOffset(5000).GlyphAt(0));
+
+    Log::Comment(L"ResizeTraditional() only moves the committed rows.");
+    VERIFY_SUCCEEDED(buffer.ResizeTraditional({ 80, 9001 }));
+    VERIFY_ARE_EQUAL(4096u, buffer.GetCommittedBytes());
+    VERIFY_ARE_EQUAL(L"a", constBuffer.GetRowByOffset(5000).GlyphAt(0));
+    VERIFY_ARE_EQUAL(std::wstring(80, L' '), constBuffer.GetRowByOffset(4999).GetText());
+
+    Log::Comment(L"ClearScrollback() moves the kept rows to the top and decommits the others.");
+    const TextAttribute red{ FOREGROUND_RED };
+    buffer.GetRowByOffset(9000).ReplaceCharacters(0, 1, L"b");
+    buffer.ClearScrollback(5000, 2, red);
+    VERIFY_ARE_EQUAL(4096u, buffer.GetCommittedBytes());
+    VERIFY_ARE_EQUAL(L"a", constBuffer.GetRowByOffset(0).GlyphAt(0));
+    VERIFY_ARE_EQUAL(L" ", constBuffer.GetRowByOffset(1).GlyphAt(0));
+    VERIFY_ARE_EQUAL(L" ", constBuffer.GetRowByOffset(9000).GlyphAt(0));
+    VERIFY_ARE_EQUAL(red, constBuffer.GetRowByOffset(9000).GetAttrByColumn(0));
+
+    Log::Comment(L"Reset() decommits all rows.");
+    buffer.Reset();
+    VERIFY_ARE_EQUAL(0u, buffer.GetCommittedBytes());
+    VERIFY_ARE_EQUAL(std::wstring(80, L' '), constBuffer.GetRowByOffset(0).GetText());
+}
+
+void TextBufferTests::TestColdRows()
+{
+    til::size bufferSize{ 20, 400 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    const TextAttribute red{ FOREGROUND_RED };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+    const auto& constBuffer = buffer;
+    auto& cursor = buffer.GetCursor();
+
+    Log::Comment(L"Write a line per row, like a shell would, with a few interesting ones at the top.");
+    const auto writeRow = [&](til::CoordType y) {
+        cursor.SetYPosition(y);
+        auto& row = buffer.GetRowByOffset(y);
+        switch (y)
+        {
+        case 0:
+            row.ReplaceCharacters(0, 1, L"a");
+            row.ReplaceCharacters(1, 2, L"\u732B");
+            row.ReplaceCharacters(3, 2, L"\xD83D\xDE00");
+            break;
+        case 1:
+            row.ReplaceCharacters(0, 1, L"\u00E9");
+            row.ReplaceAttributes(2, 5, red);
+            break;
+        case 2:
+            row.ReplaceCharacters(19, 1, L"z");
+            break;
+        default:
+        {
+            const auto text = fmt::format(FMT_COMPILE(L"line {}"), y);
+            RowWriteState state;
+            state.text = text;
+            state.columnLimit = bufferSize.width;
+            row.ReplaceText(state);
+            break;
+        }
+        }
+    };
+
+    for (til::CoordType y = 0; y <= TextBuffer::ColdRowDistance; ++y)
+    {
+        writeRow(y);
+    }
+
+    Log::Comment(L"Rows only get compressed at safe points, but not while they're handed out.");
+    VERIFY_IS_FALSE(buffer._storage[0].IsCompressed());
+    buffer.CompressColdRows();
+
+    Log::Comment(L"Once the cursor is far enough down, rows above it get compressed and their memory reused.");
+    VERIFY_IS_TRUE(buffer._storage[0].IsCompressed());
+    VERIFY_IS_FALSE(buffer._storage[1].IsCompressed());
+    const auto committedBytes = buffer.GetCommittedBytes();
+    for (til::CoordType y = TextBuffer::ColdRowDistance + 1; y < 300; ++y)
+    {
+        writeRow(y);
+        buffer.CompressColdRows();
+    }
+    VERIFY_ARE_EQUAL(committedBytes, buffer.GetCommittedBytes());
+    VERIFY_IS_TRUE(buffer._storage[299 - TextBuffer::ColdRowDistance].IsCompressed());
+    VERIFY_IS_FALSE(buffer._storage[300 - TextBuffer::ColdRowDistance].IsCompressed());
+
+    Log::Comment(L"Reading a compressed row decodes a copy with its contents intact, but leaves the row compressed.");
+    {
+        const auto& row = constBuffer.GetRowByOffset(0);
+        VERIFY_IS_TRUE(buffer._storage[0].IsCompressed());
+        VERIFY_ARE_EQUAL(L"a", row.GlyphAt(0));
+        VERIFY_ARE_EQUAL(L"\u732B", row.GlyphAt(1));
+        VERIFY_IS_TRUE(row.DbcsAttrAt(2) == DbcsAttribute::Trailing);
+        VERIFY_ARE_EQUAL(L"\xD83D\xDE00", row.GlyphAt(4));
+        VERIFY_ARE_EQUAL(L" ", row.GlyphAt(19));
+        VERIFY_ARE_EQUAL(5, row.MeasureRight());
+    }
+    {
+        const auto& row = constBuffer.GetRowByOffset(1);
+        VERIFY_ARE_EQUAL(L"\u00E9" + std::wstring(19, L' '), row.GetText());
+        VERIFY_ARE_EQUAL(attr, row.GetAttrByColumn(1));
+        VERIFY_ARE_EQUAL(red, row.GetAttrByColumn(2));
+        VERIFY_ARE_EQUAL(red, row.GetAttrByColumn(4));
+        VERIFY_ARE_EQUAL(attr, row.GetAttrByColumn(5));
+    }
+    VERIFY_ARE_EQUAL(std::wstring(19, L' ') + L"z", constBuffer.GetRowByOffset(2).GetText());
+    VERIFY_ARE_EQUAL(L"line 3" + std::wstring(14, L' '), constBuffer.GetRowByOffset(3).GetText());
+
+    Log::Comment(L"Writing into a compressed row expands it, and the next safe point compresses it again.");
+    VERIFY_ARE_EQUAL(L"line 4" + std::wstring(14, L' '), constBuffer.GetRowByOffset(4).GetText());
+    VERIFY_IS_TRUE(buffer._storage[4].IsCompressed());
+    buffer.GetRowByOffset(4).ReplaceCharacters(0, 1, L"L");
+    VERIFY_IS_FALSE(buffer._storage[4].IsCompressed());
+    VERIFY_ARE_EQUAL(L"Line 4" + std::wstring(14, L' '), constBuffer.GetRowByOffset(4).GetText());
+    buffer.CompressColdRows();
+    VERIFY_IS_TRUE(buffer._storage[4].IsCompressed());
+    VERIFY_ARE_EQUAL(L"Line 4" + std::wstring(14, L' '), constBuffer.GetRowByOffset(4).GetText());
+
+    Log::Comment(L"ResizeTraditional() expands compressed rows into the new width.");
+    VERIFY_IS_TRUE(buffer._storage[10].IsCompressed());
+    VERIFY_SUCCEEDED(buffer.ResizeTraditional({ 30, 400 }));
+    VERIFY_ARE_EQUAL(L"line 10" + std::wstring(23, L' '), constBuffer.GetRowByOffset(10).GetText());
+    VERIFY_ARE_EQUAL(L"line 299" + std::wstring(22, L' '), constBuffer.GetRowByOffset(299).GetText());
+}
+
+void TextBufferTests::TestPatternDetection()
+{
+    til::size bufferSize{ 20, 10 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+
+    const auto urlId = buffer.AddPatternRecognizer(UrlScanner::Pattern);
+    const auto numberId = buffer.AddPatternRecognizer(L"[0-9]{3}");
+
+    const auto writeRow = [&](til::CoordType y, std::wstring_view text, bool wrap = false) {
+        RowWriteState state;
+        state.text = text;
+        state.columnLimit = bufferSize.width;
+        buffer.Write(y, attr, state);
+        buffer.GetRowByOffset(y).SetWrapForced(wrap);
+    };
+
+    // Sorts the intervals so that they can be compared with the expected ones.
+    const auto collect = [](const PointTree& tree) {
+        std::vector<PointTree::interval> intervals;
+        tree.visit_all([&](const PointTree::interval& interval) { intervals.emplace_back(interval); });
+        std::sort(intervals.begin(), intervals.end(), [](const auto& a, const auto& b) { return std::tie(a.start, a.value) < std::tie(b.start, b.value); });
+        return intervals;
+    };
+
+    const auto verifyIntervals = [&](const std::vector<PointTree::interval>& expected, const std::vector<PointTree::interval>& actual) {
+        VERIFY_ARE_EQUAL(expected.size(), actual.size());
+        for (size_t i = 0; i < std::min(expected.size(), actual.size()); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected[i].start, actual[i].start);
+            VERIFY_ARE_EQUAL(expected[i].stop, actual[i].stop);
+            VERIFY_ARE_EQUAL(expected[i].value, actual[i].value);
+        }
+    };
+
+    writeRow(0, L"see https://a.b/c.");
+    writeRow(1, L"xhttp://no ftp://ok");
+    // A URL that's wrapped across 2 rows.
+    writeRow(2, L"at http://example.co", true);
+    writeRow(3, L"m/x 123");
+    // A wide glyph in front of the URL.
+    writeRow(4, L"\u732B file:///");
+    writeRow(5, L"end");
+
+    std::vector<PointTree::interval> expected{
+        { { 4, 0 }, { 17, 0 }, urlId },
+        { { 11, 1 }, { 19, 1 }, urlId },
+        { { 3, 2 }, { 3, 3 }, urlId },
+        { { 4, 3 }, { 7, 3 }, numberId },
+        { { 3, 4 }, { 11, 4 }, urlId },
+    };
+
+    Log::Comment(L"UrlScanner finds the same matches as the regex would.");
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(0, 9)));
+
+    Log::Comment(L"GetPatterns() returns the matches relative to the first row and finds wrapped lines in their entirety.");
+    {
+        const auto actual = collect(buffer.GetPatterns(3, 3));
+        VERIFY_ARE_EQUAL(2u, actual.size());
+        VERIFY_ARE_EQUAL(til::point(3, -1), actual[0].start);
+        VERIFY_ARE_EQUAL(til::point(3, 0), actual[0].stop);
+    }
+
+    Log::Comment(L"Modified rows are searched again.");
+    writeRow(5, L"https://new");
+    expected.push_back({ { 0, 5 }, { 11, 5 }, urlId });
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(0, 9)));
+
+    Log::Comment(L"The results are keyed by absolute rows, so they remain the same while scrolling.");
+    buffer.IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(1, buffer.GetScrolledOffRowCount());
+    expected.erase(expected.begin());
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(0, 9)));
+
+    Log::Comment(L"Only rows that were handed out for writing are searched again.");
+    // Modify the row with the "https://new" URL behind the buffer's back.
+    buffer._storage[5].ReplaceCharacters(0, 1, L"x");
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(0, 9)));
+    buffer.GetRowByOffset(4);
+    expected.pop_back();
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(0, 9)));
+
+    Log::Comment(L"Matches aren't cut off where a line crosses from one chunk into the next.");
+    while (buffer.GetScrolledOffRowCount() < TextBuffer::PatternChunkHeight - 2)
+    {
+        buffer.IncrementCircularBuffer();
+    }
+    // Row 1 is the last row of a chunk and row 2 is the first one of the next.
+    writeRow(1, L"go http://example.co", true);
+    writeRow(2, L"m/x1234 ok");
+    expected = {
+        { { 3, 31 }, { 7, 32 }, urlId },
+        { { 3, 32 }, { 6, 32 }, numberId },
+    };
+    verifyIntervals(expected, collect(buffer.UpdatePatterns(2, 2)));
+    {
+        const auto actual = collect(buffer.GetPatterns(2, 2));
+        VERIFY_ARE_EQUAL(2u, actual.size());
+        VERIFY_ARE_EQUAL(til::point(3, -1), actual[0].start);
+        VERIFY_ARE_EQUAL(til::point(7, 0), actual[0].stop);
+    }
+
+    buffer.ClearPatternRecognizers();
+    VERIFY_ARE_EQUAL(0u, buffer._patternCache.size());
+    VERIFY_ARE_EQUAL(0u, collect(buffer.UpdatePatterns(0, 9)).size());
+}
+
 void TextBufferTests::TestAppendRTFText()
 {
     {
@@ -2345,6 +2713,91 @@ void TextBufferTests::GetGlyphBoundaries()
     }
 }
 
+void TextBufferTests::GetRowSlice()
+{
+    // This is the burrito emoji: 🌯
+    // It's encoded in UTF-16, as needed by the buffer.
+    const auto burrito = std::wstring(L"\xD83C\xDF2F");
+
+    const TextAttribute defaultAttr{ 0x7f };
+    const TextAttribute attrA{ 0x1e };
+    const TextAttribute attrB{ 0x2d };
+    TextBuffer buffer{ { 10, 2 }, defaultAttr, 12, false, _renderer };
+
+    // - - - Row Contents - - -
+    // |ab🌯c
+    // - - - - - - - - - - - -
+    buffer.Write(OutputCellIterator{ L"ab", attrA }, { 0, 0 });
+    buffer.Write(OutputCellIterator{ burrito, attrB }, { 2, 0 });
+    buffer.Write(OutputCellIterator{ L"c", attrA }, { 4, 0 });
+
+    const auto& row = buffer.GetRowByOffset(0);
+    til::CoordType columns = 0;
+
+    Log::Comment(L"A slice of the entire row");
+    {
+        const auto slice = row.GetSlice(0, 10);
+        VERIFY_ARE_EQUAL(0, slice.ColumnBegin());
+        VERIFY_ARE_EQUAL(10, slice.ColumnEnd());
+        VERIFY_ARE_EQUAL(L"ab" + burrito + L"c      ", slice.Text());
+
+        VERIFY_ARE_EQUAL(burrito, slice.GlyphAt(2, columns));
+        VERIFY_ARE_EQUAL(2, columns);
+        VERIFY_IS_FALSE(slice.IsTrailer(2));
+        VERIFY_IS_TRUE(slice.IsTrailer(3));
+
+        const auto& runs = slice.Attributes().runs();
+        VERIFY_ARE_EQUAL(4u, runs.size());
+        VERIFY_ARE_EQUAL(attrA, runs[0].value);
+        VERIFY_ARE_EQUAL(2, runs[0].length);
+        VERIFY_ARE_EQUAL(attrB, runs[1].value);
+        VERIFY_ARE_EQUAL(2, runs[1].length);
+        VERIFY_ARE_EQUAL(attrA, runs[2].value);
+        VERIFY_ARE_EQUAL(1, runs[2].length);
+        VERIFY_ARE_EQUAL(defaultAttr, runs[3].value);
+        VERIFY_ARE_EQUAL(5, runs[3].length);
+    }
+
+    Log::Comment(L"A slice beginning with the trailing half of a wide glyph");
+    {
+        const auto slice = row.GetSlice(3, 6);
+        VERIFY_ARE_EQUAL(3, slice.ColumnBegin());
+        VERIFY_ARE_EQUAL(6, slice.ColumnEnd());
+        VERIFY_ARE_EQUAL(burrito + L"c ", slice.Text());
+
+        VERIFY_IS_TRUE(slice.IsTrailer(3));
+        VERIFY_ARE_EQUAL(burrito, slice.GlyphAt(3, columns));
+        VERIFY_ARE_EQUAL(1, columns);
+        VERIFY_ARE_EQUAL(L"c", slice.GlyphAt(4, columns));
+        VERIFY_ARE_EQUAL(1, columns);
+
+        const auto& runs = slice.Attributes().runs();
+        VERIFY_ARE_EQUAL(3u, runs.size());
+        VERIFY_ARE_EQUAL(attrB, runs[0].value);
+        VERIFY_ARE_EQUAL(1, runs[0].length);
+        VERIFY_ARE_EQUAL(attrA, runs[1].value);
+        VERIFY_ARE_EQUAL(1, runs[1].length);
+        VERIFY_ARE_EQUAL(defaultAttr, runs[2].value);
+        VERIFY_ARE_EQUAL(1, runs[2].length);
+    }
+
+    Log::Comment(L"A slice ending with the leading half of a wide glyph");
+    {
+        const auto slice = row.GetSlice(1, 3);
+        VERIFY_ARE_EQUAL(L"b" + burrito, slice.Text());
+        VERIFY_ARE_EQUAL(burrito, slice.GlyphAt(2, columns));
+        VERIFY_ARE_EQUAL(2, columns);
+    }
+
+    Log::Comment(L"Slices are clamped to the row");
+    {
+        const auto slice = row.GetSlice(8, 20);
+        VERIFY_ARE_EQUAL(8, slice.ColumnBegin());
+        VERIFY_ARE_EQUAL(10, slice.ColumnEnd());
+        VERIFY_ARE_EQUAL(L"  ", slice.Text());
+    }
+}
+
 void TextBufferTests::GetTextRects()
 {
     // GetTextRects() is used to...
@@ -83,6 +83,9 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(TestAsyncWrites);
+    TEST_METHOD(TestAsyncWriteFailure);
+
     void Test16Colors(VtEngine* engine);
 
     std::deque<std::string> qExpectedInput;
@@ -1594,3 +1597,78 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormatted(bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::TestAsyncWrites()
+{
+    Log::Comment(L"With async writes, output that's flushed while the writer is "
+                 L"holding back output should be coalesced into a single write.");
+
+    wil::unique_hfile reader;
+    wil::unique_hfile writer;
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(reader.addressof(), writer.addressof(), nullptr, 0));
+
+    auto engine = std::make_unique<Xterm256Engine>(std::move(writer), SetUpViewport());
+
+    // Hold back anything that isn't urgent until the next urgent flush.
+    VtEngine::WritePolicy policy;
+    policy.async = true;
+    policy.batchBytes = SIZE_MAX;
+    policy.batchLatency = std::chrono::hours{ 1 };
+    engine->SetWritePolicy(policy);
+
+    VERIFY_SUCCEEDED(engine->WriteTerminalW(L"A"));
+    VERIFY_SUCCEEDED(engine->WriteTerminalW(L"B"));
+    VERIFY_SUCCEEDED(engine->_Write("C"));
+    VERIFY_SUCCEEDED(engine->_Flush());
+
+    // Switching back to synchronous writes waits for the writer to finish.
+    engine->SetWritePolicy({});
+
+    auto stats = engine->GetWriteStats();
+    VERIFY_ARE_EQUAL(uint64_t{ 1 }, stats.writes);
+    VERIFY_ARE_EQUAL(uint64_t{ 3 }, stats.bytes);
+
+    std::array<char, 16> buffer{};
+    DWORD read = 0;
+    VERIFY_WIN32_BOOL_SUCCEEDED(ReadFile(reader.get(), buffer.data(), gsl::narrow_cast<DWORD>(buffer.size()), &read, nullptr));
+    VERIFY_ARE_EQUAL(std::string{ "ABC" }, std::string(buffer.data(), read));
+
+    Log::Comment(L"Without async writes, every flush is written right away.");
+    VERIFY_SUCCEEDED(engine->WriteTerminalW(L"D"));
+    stats = engine->GetWriteStats();
+    VERIFY_ARE_EQUAL(uint64_t{ 2 }, stats.writes);
+    VERIFY_ARE_EQUAL(uint64_t{ 4 }, stats.bytes);
+}
+
+void VtRendererTest::TestAsyncWriteFailure()
+{
+    Log::Comment(L"If the writer thread fails to write, the pipe should be closed "
+                 L"on the next frame, even if nothing else gets flushed.");
+
+    wil::unique_hfile reader;
+    wil::unique_hfile writer;
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(reader.addressof(), writer.addressof(), nullptr, 0));
+
+    auto engine = std::make_unique<Xterm256Engine>(std::move(writer), SetUpViewport());
+
+    VtEngine::WritePolicy policy;
+    policy.async = true;
+    engine->SetWritePolicy(policy);
+
+    // Writing to a pipe without a reader fails with ERROR_NO_DATA.
+    reader.reset();
+    VERIFY_SUCCEEDED(engine->_Write("A"));
+    VERIFY_SUCCEEDED(engine->_Flush());
+
+    // The write fails on the writer thread, so we need to wait for it.
+    for (auto i = 0; i < 500 && SUCCEEDED(engine->_GetWriterError()); ++i)
+    {
+        Sleep(10);
+    }
+    VERIFY_FAILED(engine->_GetWriterError());
+    VERIFY_IS_TRUE(static_cast<bool>(engine->_hFile));
+
+    VERIFY_ARE_EQUAL(S_FALSE, engine->StartPaint());
+    VERIFY_IS_FALSE(static_cast<bool>(engine->_hFile));
+    VERIFY_FAILED(engine->_exitResult);
+}
@@ -0,0 +1,325 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+namespace til
+{
+    // A hash map that keeps track of the order in which its entries were used.
+    // It's meant for caches which need to evict their least recently used entries once they're full.
+    //
+    // All entries live in a single vector and are linked into the LRU list via prev/next indices.
+    // Lookups go through an open addressing hash table of indices into that vector, using linear probing.
+    // Compared to a std::list and a std::unordered_set this avoids an allocation per entry,
+    // and a lookup touches just the index table and the entry itself.
+    //
+    // Iterators remain valid until their entry is evicted, even if the map grows in the meantime.
+    // The map must not be moved while iterators into it are in use.
+    template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class lru_map
+    {
+        static constexpr uint32_t npos = UINT32_MAX;
+        static constexpr size_t initial_capacity = 64;
+
+        struct node
+        {
+            std::optional<std::pair<K, V>> entry;
+            size_t hash = 0;
+            uint32_t prev = npos;
+            uint32_t next = npos;
+        };
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+
+        class iterator
+        {
+        public:
+            iterator() = default;
+
+            value_type& operator*() const noexcept
+            {
+                return *_map->_nodes[_index].entry;
+            }
+
+            value_type* operator->() const noexcept
+            {
+                return &**this;
+            }
+
+            bool operator==(const iterator& other) const noexcept = default;
+
+        private:
+            friend class lru_map;
+
+            iterator(lru_map* map, uint32_t index) noexcept :
+                _map{ map },
+                _index{ index }
+            {
+            }
+
+            lru_map* _map = nullptr;
+            uint32_t _index = npos;
+        };
+
+        lru_map() = default;
+
+        lru_map(const lru_map&) = delete;
+        lru_map& operator=(const lru_map&) = delete;
+
+        lru_map(lru_map&& other) noexcept :
+            _nodes{ std::move(other._nodes) },
+            _slots{ std::move(other._slots) },
+            _head{ std::exchange(other._head, npos) },
+            _tail{ std::exchange(other._tail, npos) },
+            _free{ std::exchange(other._free, npos) },
+            _size{ std::exchange(other._size, 0) }
+        {
+            other.clear();
+        }
+
+        lru_map& operator=(lru_map&& other) noexcept
+        {
+            if (this != &other)
+            {
+                _nodes = std::move(other._nodes);
+                _slots = std::move(other._slots);
+                _head = std::exchange(other._head, npos);
+                _tail = std::exchange(other._tail, npos);
+                _free = std::exchange(other._free, npos);
+                _size = std::exchange(other._size, 0);
+                other.clear();
+            }
+            return *this;
+        }
+
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        iterator end() noexcept
+        {
+            return { this, npos };
+        }
+
+        void clear() noexcept
+        {
+            _nodes.clear();
+            _slots.clear();
+            _head = npos;
+            _tail = npos;
+            _free = npos;
+            _size = 0;
+        }
+
+        // Returns the entry for the given key, or end() if there's none.
+        // A found entry becomes the most recently used one.
+        iterator find(const K& key)
+        {
+            if (_slots.empty())
+            {
+                return end();
+            }
+
+            const auto hash = Hash{}(key);
+            const auto mask = _slots.size() - 1;
+
+            for (auto i = hash & mask;; i = (i + 1) & mask)
+            {
+                const auto index = _slots[i];
+                if (index == npos)
+                {
+                    return end();
+                }
+
+                const auto& n = _nodes[index];
+                if (n.hash == hash && KeyEqual{}(n.entry->first, key))
+                {
+                    _make_newest(index);
+                    return { this, index };
+                }
+            }
+        }
+
+        // Inserts a new entry as the most recently used one. The key must not exist in the map yet.
+        iterator insert(K&& key, V&& value)
+        {
+            if ((_size + 1) * 2 > _slots.size())
+            {
+                _grow();
+            }
+
+            const auto hash = Hash{}(key);
+            const auto index = _allocate_node();
+            auto& n = _nodes[index];
+            n.entry.emplace(std::move(key), std::move(value));
+            n.hash = hash;
+            _link_front(index);
+
+            const auto mask = _slots.size() - 1;
+            auto i = hash & mask;
+            while (_slots[i] != npos)
+            {
+                i = (i + 1) & mask;
+            }
+            _slots[i] = index;
+
+            ++_size;
+            return { this, index };
+        }
+
+        // Turns the given entry into the most recently used one.
+        void make_newest(const iterator& it) noexcept
+        {
+            _make_newest(it._index);
+        }
+
+        // Evicts up to `count` of the least recently used entries, oldest first.
+        // `func` is called with each entry right before it's destroyed,
+        // which allows the caller to salvage any resources it holds.
+        // Returns the number of evicted entries.
+        template<typename F>
+        size_t pop_oldest(size_t count, F&& func)
+        {
+            count = std::min(count, _size);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto index = _tail;
+                func(*_nodes[index].entry);
+                _erase(index);
+            }
+            return count;
+        }
+
+    private:
+        uint32_t _allocate_node()
+        {
+            if (_free != npos)
+            {
+                const auto index = _free;
+                _free = _nodes[index].next;
+                return index;
+            }
+
+            _nodes.emplace_back();
+            return gsl::narrow<uint32_t>(_nodes.size() - 1);
+        }
+
+        void _link_front(uint32_t index) noexcept
+        {
+            auto& n = _nodes[index];
+            n.prev = npos;
+            n.next = _head;
+            if (_head != npos)
+            {
+                _nodes[_head].prev = index;
+            }
+            else
+            {
+                _tail = index;
+            }
+            _head = index;
+        }
+
+        void _unlink(uint32_t index) noexcept
+        {
+            const auto& n = _nodes[index];
+            if (n.prev != npos)
+            {
+                _nodes[n.prev].next = n.next;
+            }
+            else
+            {
+                _head = n.next;
+            }
+            if (n.next != npos)
+            {
+                _nodes[n.next].prev = n.prev;
+            }
+            else
+            {
+                _tail = n.prev;
+            }
+        }
+
+        void _make_newest(uint32_t index) noexcept
+        {
+            if (index != _head)
+            {
+                _unlink(index);
+                _link_front(index);
+            }
+        }
+
+        void _erase(uint32_t index) noexcept
+        {
+            const auto mask = _slots.size() - 1;
+            auto hole = _nodes[index].hash & mask;
+            while (_slots[hole] != index)
+            {
+                hole = (hole + 1) & mask;
+            }
+
+            // Backward shift deletion: Instead of leaving a tombstone behind, we move every following
+            // entry of the probe sequence whose home slot isn't in between the hole and itself into the hole.
+            for (auto i = (hole + 1) & mask;; i = (i + 1) & mask)
+            {
+                const auto other = _slots[i];
+                if (other == npos)
+                {
+                    break;
+                }
+
+                const auto home = _nodes[other].hash & mask;
+                if (((i - home) & mask) >= ((i - hole) & mask))
+                {
+                    _slots[hole] = other;
+                    hole = i;
+                }
+            }
+            _slots[hole] = npos;
+
+            _unlink(index);
+            auto& n = _nodes[index];
+            n.entry.reset();
+            n.prev = npos;
+            n.next = _free;
+            _free = index;
+            --_size;
+        }
+
+        void _grow()
+        {
+            const auto capacity = std::max(initial_capacity, _slots.size() * 2);
+            const auto mask = capacity - 1;
+
+            _slots.assign(capacity, npos);
+
+            // Only entries which are part of the LRU list are alive.
+            for (auto index = _head; index != npos; index = _nodes[index].next)
+            {
+                auto i = _nodes[index].hash & mask;
+                while (_slots[i] != npos)
+                {
+                    i = (i + 1) & mask;
+                }
+                _slots[i] = index;
+            }
+        }
+
+        std::vector<node> _nodes;
+        std::vector<uint32_t> _slots;
+        uint32_t _head = npos;
+        uint32_t _tail = npos;
+        uint32_t _free = npos;
+        size_t _size = 0;
+    };
+}
@@ -0,0 +1,246 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "rect.h"
+
+namespace til
+{
+    // Packs rectangles of varying sizes into a 2D area, like glyphs into a texture atlas.
+    //
+    // The area is divided into horizontal shelves, stacked from top to bottom. A rectangle is put
+    // on the shelf whose height fits it best, at the leftmost free span that's wide enough.
+    // Unlike a skyline packer, each shelf keeps a list of its free spans, so rectangles can be
+    // deallocated individually and their space reused. Adjacent free spans are coalesced and
+    // shelves that become empty are merged with their empty neighbors, which allows their space
+    // to be split up again for rectangles of a different height.
+    class shelf_packer
+    {
+    public:
+        shelf_packer() = default;
+
+        explicit shelf_packer(const til::size size) noexcept :
+            _size{ size }
+        {
+        }
+
+        til::size size() const noexcept
+        {
+            return _size;
+        }
+
+        size_t area() const noexcept
+        {
+            return static_cast<size_t>(_size.width) * static_cast<size_t>(_size.height);
+        }
+
+        // The sum of the area of all rectangles that are currently allocated.
+        size_t allocated_area() const noexcept
+        {
+            return _allocated;
+        }
+
+        size_t shelf_count() const noexcept
+        {
+            return _shelves.size();
+        }
+
+        // The fraction of the area that is covered by allocated rectangles, between 0 and 1.
+        double occupancy() const noexcept
+        {
+            const auto total = area();
+            return total ? static_cast<double>(_allocated) / static_cast<double>(total) : 0.0;
+        }
+
+        // Grows the area to the given size. Existing rectangles keep their position.
+        void grow(const til::size size)
+        {
+            Expects(size.width >= _size.width && size.height >= _size.height);
+
+            if (size.width > _size.width)
+            {
+                for (auto& s : _shelves)
+                {
+                    if (!s.free.empty() && s.free.back().right == _size.width)
+                    {
+                        s.free.back().right = size.width;
+                    }
+                    else
+                    {
+                        s.free.push_back(span{ _size.width, size.width });
+                    }
+                }
+            }
+
+            _size = size;
+        }
+
+        // Returns the top left corner of a free rectangle of the given size, or nullopt if there's no room left.
+        std::optional<til::point> allocate(const til::size size)
+        {
+            if (size.width <= 0 || size.height <= 0 || size.width > _size.width || size.height > _size.height)
+            {
+                return std::nullopt;
+            }
+
+            // Find the shelf that wastes the least amount of vertical space. An empty shelf that's too
+            // tall wastes nothing, as it's split in two below. On a tie we prefer shelves that
+            // are already in use, so that empty ones remain available for other heights.
+            auto best = _shelves.end();
+            auto bestWaste = std::numeric_limits<CoordType>::max();
+            auto bestEmpty = true;
+
+            for (auto it = _shelves.begin(); it != _shelves.end(); ++it)
+            {
+                if (it->height < size.height || _find_span(*it, size.width) == it->free.end())
+                {
+                    continue;
+                }
+
+                const auto empty = _is_empty(*it);
+                const auto waste = empty ? 0 : it->height - size.height;
+                if (waste < bestWaste || (waste == bestWaste && bestEmpty && !empty))
+                {
+                    best = it;
+                    bestWaste = waste;
+                    bestEmpty = empty;
+                }
+            }
+
+            // Rather than wasting space on a taller shelf, open a new one if there's still room.
+            if ((best == _shelves.end() || bestWaste != 0) && _size.height - _bottom() >= size.height)
+            {
+                shelf s{ _bottom(), size.height, { { 0, _size.width } } };
+                best = _shelves.insert(_shelves.end(), std::move(s));
+                bestEmpty = true;
+            }
+
+            if (best == _shelves.end())
+            {
+                return std::nullopt;
+            }
+
+            if (bestEmpty && best->height > size.height)
+            {
+                const shelf rest{ best->top + size.height, best->height - size.height, { { 0, _size.width } } };
+                best->height = size.height;
+                best = std::prev(_shelves.insert(std::next(best), rest));
+            }
+
+            const auto freeSpan = _find_span(*best, size.width);
+            const til::point pos{ freeSpan->left, best->top };
+            freeSpan->left += size.width;
+            if (freeSpan->left == freeSpan->right)
+            {
+                best->free.erase(freeSpan);
+            }
+
+            _allocated += static_cast<size_t>(size.width) * static_cast<size_t>(size.height);
+            return pos;
+        }
+
+        // Returns a previously allocated rectangle, or any part of it that spans its full height, to the free space.
+        void deallocate(const til::rect& rect)
+        {
+            auto it = std::lower_bound(_shelves.begin(), _shelves.end(), rect.top, [](const shelf& s, CoordType top) {
+                return s.top < top;
+            });
+            Expects(it != _shelves.end() && it->top == rect.top && rect.bottom <= it->top + it->height);
+
+            auto& free = it->free;
+            auto next = std::lower_bound(free.begin(), free.end(), rect.left, [](const span& s, CoordType left) {
+                return s.left < left;
+            });
+            Expects((next == free.begin() || std::prev(next)->right <= rect.left) && (next == free.end() || rect.right <= next->left));
+
+            if (next != free.begin() && std::prev(next)->right == rect.left)
+            {
+                const auto prev = std::prev(next);
+                prev->right = rect.right;
+                if (next != free.end() && next->left == prev->right)
+                {
+                    prev->right = next->right;
+                    free.erase(next);
+                }
+            }
+            else if (next != free.end() && next->left == rect.right)
+            {
+                next->left = rect.left;
+            }
+            else
+            {
+                free.insert(next, span{ rect.left, rect.right });
+            }
+
+            _allocated -= static_cast<size_t>(rect.width()) * static_cast<size_t>(rect.height());
+
+            if (_is_empty(*it))
+            {
+                _merge_empty(it);
+            }
+        }
+
+    private:
+        // A free range [left, right) of columns on a shelf.
+        struct span
+        {
+            CoordType left = 0;
+            CoordType right = 0;
+        };
+
+        struct shelf
+        {
+            CoordType top = 0;
+            CoordType height = 0;
+            // Sorted by `left` and never adjacent to each other.
+            std::vector<span> free;
+        };
+
+        CoordType _bottom() const noexcept
+        {
+            return _shelves.empty() ? 0 : _shelves.back().top + _shelves.back().height;
+        }
+
+        bool _is_empty(const shelf& s) const noexcept
+        {
+            return s.free.size() == 1 && s.free.front().left == 0 && s.free.front().right == _size.width;
+        }
+
+        static std::vector<span>::iterator _find_span(shelf& s, CoordType width) noexcept
+        {
+            return std::find_if(s.free.begin(), s.free.end(), [&](const span& sp) {
+                return sp.right - sp.left >= width;
+            });
+        }
+
+        // Merges the given empty shelf with its empty neighbors.
+        // An empty shelf at the bottom of the stack is removed entirely.
+        void _merge_empty(std::vector<shelf>::iterator it)
+        {
+            if (const auto next = std::next(it); next != _shelves.end() && _is_empty(*next))
+            {
+                it->height += next->height;
+                _shelves.erase(next);
+            }
+
+            if (it != _shelves.begin())
+            {
+                if (const auto prev = std::prev(it); _is_empty(*prev))
+                {
+                    prev->height += it->height;
+                    it = std::prev(_shelves.erase(it));
+                }
+            }
+
+            if (std::next(it) == _shelves.end())
+            {
+                _shelves.erase(it);
+            }
+        }
+
+        std::vector<shelf> _shelves;
+        til::size _size;
+        size_t _allocated = 0;
+    };
+}
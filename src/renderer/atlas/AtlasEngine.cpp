@@ -1615,10 +1615,7 @@ bool AtlasEngine::_emplaceGlyph(IDWriteFontFace* fontFace, size_t bufferPos1, si
         u16x2* coords;
         AtlasValue value{ flags, cellCount, &coords };
 
-        for (u16 i = 0; i < cellCount; ++i)
-        {
-            coords[i] = _r.tileAllocator.allocate(_r.glyphs);
-        }
+        _r.tileAllocator.allocate(_r.glyphs, coords, cellCount);
 
         it = _r.glyphs.insert(std::move(key), std::move(value));
         _r.glyphQueue.emplace_back(it);
@@ -572,55 +572,35 @@ namespace Microsoft::Console::Render
 
         struct AtlasKeyHasher
         {
-            using is_transparent = int;
-
             size_t operator()(const AtlasKey& v) const noexcept
             {
                 return v.hash();
             }
-
-            size_t operator()(const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& v) const noexcept
-            {
-                return operator()(v->first);
-            }
         };
 
         struct AtlasKeyEq
         {
-            using is_transparent = int;
-
-            bool operator()(const AtlasKey& a, const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& b) const noexcept
+            bool operator()(const AtlasKey& a, const AtlasKey& b) const noexcept
             {
-                return a == b->first;
-            }
-
-            bool operator()(const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& a, const std::list<std::pair<AtlasKey, AtlasValue>>::iterator& b) const noexcept
-            {
-                return operator()(a->first, b);
+                return a == b;
             }
         };
 
         struct TileHashMap
         {
-            using iterator = std::list<std::pair<AtlasKey, AtlasValue>>::iterator;
+            using iterator = til::lru_map<AtlasKey, AtlasValue, AtlasKeyHasher, AtlasKeyEq>::iterator;
 
             TileHashMap() noexcept = default;
 
             iterator end() noexcept
             {
-                return _lru.end();
+                return _map.end();
             }
 
             iterator find(const AtlasKey& key)
             {
-                const auto it = _map.find(key);
-                if (it != _map.end())
-                {
-                    // Move the key to the head of the LRU queue.
-                    makeNewest(*it);
-                    return *it;
-                }
-                return end();
+                // find() moves the key to the head of the LRU queue.
+                return _map.find(key);
             }
 
             iterator insert(AtlasKey&& key, AtlasValue&& value)
@@ -629,44 +609,41 @@ namespace Microsoft::Console::Render
                 //
                 // && decays to & if the argument is named, because C++ is a simple language
                 // and so you have to std::move it again, because C++ is a simple language.
-                _lru.emplace_front(std::move(key), std::move(value));
-                auto it = _lru.begin();
-                _map.emplace(it);
-                return it;
+                return _map.insert(std::move(key), std::move(value));
             }
 
-            void makeNewest(const iterator& it)
+            void makeNewest(const iterator& it) noexcept
             {
-                _lru.splice(_lru.begin(), _lru, it);
+                _map.make_newest(it);
             }
 
+            // Evicts the oldest entries and appends their tiles to `out`. Entries are evicted
+            // in small batches, so that TileAllocator doesn't need to come back for every single tile.
             void popOldestTiles(std::vector<u16x2>& out) noexcept
             {
-                Expects(!_lru.empty());
-                const auto it = --_lru.end();
-
-                const auto key = it->first.data();
-                const auto value = it->second.data();
-                const auto beg = &value->coords[0];
-                const auto cellCount = key->attributes.cellCount;
-
-                const auto offset = out.size();
-                out.resize(offset + cellCount);
-                std::copy_n(beg, cellCount, out.begin() + offset);
-
-                _map.erase(it);
-                _lru.pop_back();
+                Expects(!_map.empty());
+
+                const auto pop = [&](std::pair<AtlasKey, AtlasValue>& entry) {
+                    const auto beg = &entry.second.data()->coords[0];
+                    const auto cellCount = entry.first.data()->attributes.cellCount;
+                    out.insert(out.end(), beg, beg + cellCount);
+                };
+
+                // StartPaint() turns the glyphs in the window into the newest entries. Evicting
+                // at most an 8th of all entries at once keeps them out of reach of the batch.
+                const auto batch = std::clamp<size_t>(_map.size() / 8, 1, _evictionBatchSize);
+                _map.pop_oldest(batch, pop);
             }
 
         private:
-            // Please don't copy this code. It's a proof-of-concept.
-            // If you need a LRU hash-map, write a custom one with an intrusive
-            // prev/next linked list (it's easier than you might think!).
-            std::list<std::pair<AtlasKey, AtlasValue>> _lru;
-            std::unordered_set<iterator, AtlasKeyHasher, AtlasKeyEq> _map;
+            static constexpr size_t _evictionBatchSize = 8;
+
+            til::lru_map<AtlasKey, AtlasValue, AtlasKeyHasher, AtlasKeyEq> _map;
         };
 
         // TileAllocator yields `tileSize`-sized tiles for our texture atlas.
+        // A glyph that spans multiple cells gets a contiguous horizontal run of tiles, so that
+        // _drawGlyph() can draw it in one go. The runs are packed into the atlas by a til::shelf_packer.
         // While doing so it'll grow the atlas size() by a factor of 2 if needed.
         // Once the setMaxArea() is exceeded it'll stop growing and instead
         // snatch tiles back from the oldest TileHashMap entries.
@@ -674,10 +651,6 @@ namespace Microsoft::Console::Render
         // The quadratic growth works by alternating the size()
         // between an 1:1 and 2:1 aspect ratio, like so:
         //   (64,64) -> (128,64) -> (128,128) -> (256,128) -> (256,256)
-        // These initial tile positions allocate() returns are in a Z
-        // pattern over the available space in the atlas texture.
-        // You can log the `return _pos;` in allocate() using "Tracepoint"s
-        // in Visual Studio if you'd like to understand the Z pattern better.
         struct TileAllocator
         {
             TileAllocator() = default;
@@ -686,24 +659,27 @@ namespace Microsoft::Console::Render
                 _tileSize{ tileSize }
             {
                 const auto initialSize = std::max(u16{ _absoluteMinSize }, std::bit_ceil(std::max(tileSize.x, tileSize.y)));
-                _size = { initialSize, initialSize };
-                _limit = { gsl::narrow_cast<u16>(initialSize - _tileSize.x), gsl::narrow_cast<u16>(initialSize - _tileSize.y) };
+                _packer = til::shelf_packer{ { initialSize, initialSize } };
+                // The tile at position {0, 0} is reserved for the cursor texture.
+                // The first allocation in an empty packer always ends up there.
+                _packer.allocate({ tileSize.x, tileSize.y });
                 setMaxArea(windowSize);
             }
 
             u16x2 size() const noexcept
             {
-                return _size;
+                const auto size = _packer.size();
+                return { gsl::narrow_cast<u16>(size.width), gsl::narrow_cast<u16>(size.height) };
             }
 
             void setMaxArea(u16x2 windowSize) noexcept
             {
-                // _generate() uses a quadratic growth factor for _size's area.
+                // _grow() uses a quadratic growth factor for size()'s area.
                 // Once it exceeds the _maxArea, it'll start snatching tiles back from the
-                // TileHashMap using its LRU queue. Since _size will at least reach half
+                // TileHashMap using its LRU queue. Since size() will at least reach half
                 // of _maxSize (because otherwise it could still grow by a factor of 2)
                 // and by ensuring that _maxArea is at least twice the window size
-                // we make it impossible* for _generate() to return false before
+                // we make it impossible* for _grow() to return false before
                 // TileHashMap contains at least as many tiles as the window contains.
                 // If that wasn't the case we'd snatch and reuse tiles that are still in use.
                 // * lhecker's legal department:
@@ -717,91 +693,96 @@ namespace Microsoft::Console::Render
                 // at position {0,0} is already reserved for the cursor texture.
                 const auto tileArea = static_cast<size_t>(_tileSize.x) * static_cast<size_t>(_tileSize.y);
                 _maxArea = clamp(max + tileArea, _absoluteMinArea, _absoluteMaxArea);
-                _updateCanGenerate();
             }
 
             u16x2 allocate(TileHashMap& map) noexcept
             {
-                if (_generate())
-                {
-                    return _pos;
-                }
-
-                if (_cache.empty())
-                {
-                    map.popOldestTiles(_cache);
-                }
-
-                const auto pos = _cache.back();
-                _cache.pop_back();
-                return pos;
+                u16x2 coord{};
+                allocate(map, &coord, 1);
+                return coord;
             }
 
-        private:
-            // This method generates the Z pattern coordinates
-            // described above in the TileAllocator comment.
-            bool _generate() noexcept
+            // Allocates the tiles for a glyph that's `cellCount` cells wide and writes their positions to `coords`.
+            void allocate(TileHashMap& map, u16x2* coords, u16 cellCount) noexcept
             {
-                if (!_canGenerate)
+                // A run can't be wider than the atlas. Very long ligatures are split up into multiple runs.
+                const auto maxRun = gsl::narrow_cast<u16>(_packer.size().width / _tileSize.x);
+
+                for (u16 i = 0; i < cellCount;)
                 {
-                    return false;
-                }
+                    auto run = std::min<u16>(cellCount - i, maxRun);
+                    const auto pos = _allocateRun(map, run);
 
-                // We need to backup _pos/_size in case our resize below exceeds _maxArea.
-                // In that case we have to restore _pos/_size so that if _maxArea is increased
-                // (window resize for instance), we can pick up where we previously left off.
-                const auto pos = _pos;
+                    for (u16 j = 0; j < run; ++j)
+                    {
+                        coords[i + j] = { gsl::narrow_cast<u16>(pos.x + j * _tileSize.x), pos.y };
+                    }
 
-                _pos.x += _tileSize.x;
-                if (_pos.x <= _limit.x)
-                {
-                    return true;
+                    i += run;
                 }
+            }
+
+        private:
+            // Allocates a run of `run` tiles. If the atlas is full, it evicts the oldest entries once.
+            // If their tiles aren't contiguous enough for the run either, it'll rather shorten `run`
+            // than evict any further entries, because re-rasterizing them would cost more than
+            // drawing the glyph in multiple pieces.
+            u16x2 _allocateRun(TileHashMap& map, u16& run) noexcept
+            {
+                auto evicted = false;
 
-                _pos.y += _tileSize.y;
-                if (_pos.y <= _limit.y)
+                for (;;)
                 {
-                    _pos.x = _originX;
-                    return true;
+                    if (const auto pos = _packer.allocate({ run * _tileSize.x, _tileSize.y }))
+                    {
+                        return { gsl::narrow_cast<u16>(pos->x), gsl::narrow_cast<u16>(pos->y) };
+                    }
+
+                    if (_grow())
+                    {
+                        continue;
+                    }
+
+                    if (run > 1 && evicted)
+                    {
+                        run = (run + 1) / 2;
+                        continue;
+                    }
+
+                    map.popOldestTiles(_evicted);
+                    for (const auto& c : _evicted)
+                    {
+                        _packer.deallocate({ c.x, c.y, c.x + _tileSize.x, c.y + _tileSize.y });
+                    }
+                    _evicted.clear();
+                    evicted = true;
                 }
+            }
 
-                // Same as for pos.
-                const auto size = _size;
-
-                // This implements a quadratic growth factor for _size, by
-                // alternating between an 1:1 and 2:1 aspect ratio, like so:
-                //   (64,64) -> (128,64) -> (128,128) -> (256,128) -> (256,256)
-                // This behavior is strictly dependent on setMaxArea(u16x2)'s
-                // behavior. See it's comment for an explanation.
-                if (_size.x == _size.y)
+            // This implements a quadratic growth factor for size(), by
+            // alternating between an 1:1 and 2:1 aspect ratio, like so:
+            //   (64,64) -> (128,64) -> (128,128) -> (256,128) -> (256,256)
+            // This behavior is strictly dependent on setMaxArea(u16x2)'s
+            // behavior. See it's comment for an explanation.
+            bool _grow() noexcept
+            {
+                auto size = _packer.size();
+                if (size.width == size.height)
                 {
-                    _size.x *= 2;
-                    _pos.y = 0;
+                    size.width *= 2;
                 }
                 else
                 {
-                    _size.y *= 2;
-                    _pos.x = 0;
+                    size.height *= 2;
                 }
 
-                _updateCanGenerate();
-                if (_canGenerate)
-                {
-                    _limit = { gsl::narrow_cast<u16>(_size.x - _tileSize.x), gsl::narrow_cast<u16>(_size.y - _tileSize.y) };
-                    _originX = _pos.x;
-                }
-                else
+                if (static_cast<size_t>(size.width) * static_cast<size_t>(size.height) > _maxArea)
                 {
-                    _size = size;
-                    _pos = pos;
+                    return false;
                 }
 
-                return _canGenerate;
-            }
-
-            void _updateCanGenerate() noexcept
-            {
-                _canGenerate = static_cast<size_t>(_size.x) * static_cast<size_t>(_size.y) <= _maxArea;
+                _packer.grow(size);
+                return true;
             }
 
             static constexpr u16 _absoluteMinSize = 256;
@@ -810,18 +791,11 @@ namespace Microsoft::Console::Render
             // That way we can make better to use of a user's available video memory.
             static constexpr size_t _absoluteMaxArea = D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION * D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION;
 
-            std::vector<u16x2> _cache;
+            til::shelf_packer _packer;
+            // Scratch space for the tiles of the entries popOldestTiles() evicted.
+            std::vector<u16x2> _evicted;
             size_t _maxArea = _absoluteMaxArea;
             u16x2 _tileSize;
-            u16x2 _size;
-            u16x2 _limit;
-            // Since _pos starts at {0, 0}, it'll result in the first allocate()d tile to be at {_tileSize.x, 0}.
-            // Coincidentially that's exactly what we want as the cursor texture lives at {0, 0}.
-            u16x2 _pos;
-            u16 _originX = 0;
-            // Indicates whether we've exhausted our Z pattern across the atlas texture.
-            // If this is false, we have to snatch tiles back from TileHashMap.
-            bool _canGenerate = true;
         };
 
         struct CachedCursorOptions
@@ -438,14 +438,22 @@ void AtlasEngine::_drawGlyph(const TileHashMap::iterator& it) const
         _r.d2dRenderTarget->SetTextAntialiasMode(coloredGlyph ? D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE : D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE);
     }
 
-    for (u16 i = 0; i < cellCount; ++i)
+    // TileAllocator hands out contiguous runs of tiles for glyphs spanning multiple cells,
+    // so we usually only need to draw the glyph once, instead of once per cell.
+    for (u16 i = 0; i < cellCount;)
     {
         const auto coord = coords[i];
 
+        u16 run = 1;
+        while (i + run < cellCount && coords[i + run].y == coord.y && coords[i + run].x == coords[i + run - 1].x + _r.fontMetrics.cellSize.x)
+        {
+            ++run;
+        }
+
         D2D1_RECT_F rect;
         rect.left = static_cast<float>(coord.x) * _r.dipPerPixel;
         rect.top = static_cast<float>(coord.y) * _r.dipPerPixel;
-        rect.right = rect.left + _r.cellSizeDIP.x;
+        rect.right = rect.left + run * _r.cellSizeDIP.x;
         rect.bottom = rect.top + _r.cellSizeDIP.y;
 
         D2D1_POINT_2F origin;
@@ -466,6 +474,8 @@ void AtlasEngine::_drawGlyph(const TileHashMap::iterator& it) const
         cachedLayout.undoScaling(_r.d2dRenderTarget.get());
 
         _r.d2dRenderTarget->PopAxisAlignedClip();
+
+        i += run;
     }
 }
 
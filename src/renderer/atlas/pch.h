@@ -50,3 +50,5 @@
 
 #include <til.h>
 #include <til/bit.h>
+#include <til/lru_map.h>
+#include <til/shelf_packer.h>
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "RenderScheduler.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+
+// Returns how many milliseconds are left until `deadline`, or 0 if it already passed.
+static DWORD remainingUntil(const uint64_t now, const uint64_t deadline) noexcept
+{
+    return deadline > now ? gsl::narrow_cast<DWORD>(deadline - now) : 0;
+}
+
+DWORD LowLatencyRenderScheduler::GetFrameDelay(const FrameTiming& /*timing*/) const noexcept
+{
+    return 0;
+}
+
+FramePacedRenderScheduler::FramePacedRenderScheduler(const DWORD framesPerSecond) noexcept :
+    _frameInterval{ 1000 / std::max<DWORD>(1, framesPerSecond) }
+{
+}
+
+DWORD FramePacedRenderScheduler::GetFrameDelay(const FrameTiming& timing) const noexcept
+{
+    return remainingUntil(timing.now, timing.lastFrame + _frameInterval);
+}
+
+IdleRenderScheduler::IdleRenderScheduler(const DWORD idleDelay, const DWORD maxDelay) noexcept :
+    _idleDelay{ idleDelay },
+    _maxDelay{ std::max(idleDelay, maxDelay) }
+{
+}
+
+DWORD IdleRenderScheduler::GetFrameDelay(const FrameTiming& timing) const noexcept
+{
+    const auto idle = remainingUntil(timing.now, timing.lastRequest + _idleDelay);
+    const auto max = remainingUntil(timing.now, timing.firstRequest + _maxDelay);
+    return std::min(idle, max);
+}
@@ -0,0 +1,93 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RenderScheduler.hpp
+
+Abstract:
+- A RenderScheduler decides how long RenderThread holds on to a requested frame before painting it.
+  Holding on to it coalesces all the paint requests that arrive in the meantime into a single frame,
+  which keeps heavy output from producing hundreds of frames per second that compete with the
+  parser for the console lock.
+- RenderStats are the counters the Renderer keeps about the frames it painted.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    // All times are in milliseconds, as returned by GetTickCount64().
+    struct FrameTiming
+    {
+        uint64_t now = 0;
+        // When the first paint request that the pending frame is for arrived.
+        uint64_t firstRequest = 0;
+        // When the most recent paint request arrived.
+        uint64_t lastRequest = 0;
+        // When the previous frame started painting, or 0 if there was none.
+        uint64_t lastFrame = 0;
+    };
+
+    class RenderScheduler
+    {
+    public:
+        virtual ~RenderScheduler() = default;
+
+        // Returns how many milliseconds to wait before the pending frame gets painted.
+        // RenderThread asks again once they've passed, so the answer may change as more
+        // requests arrive. 0 means that the frame should be painted right away.
+        virtual DWORD GetFrameDelay(const FrameTiming& timing) const noexcept = 0;
+    };
+
+    // Paints every frame as soon as it's requested. This has the lowest latency, which
+    // is what you want for keystroke echo, and it's what RenderThread does by default.
+    class LowLatencyRenderScheduler final : public RenderScheduler
+    {
+    public:
+        DWORD GetFrameDelay(const FrameTiming& timing) const noexcept override;
+    };
+
+    // Paints at most the given number of frames per second. A frame that is requested after
+    // a pause longer than the frame interval is still painted right away.
+    class FramePacedRenderScheduler final : public RenderScheduler
+    {
+    public:
+        explicit FramePacedRenderScheduler(const DWORD framesPerSecond) noexcept;
+        DWORD GetFrameDelay(const FrameTiming& timing) const noexcept override;
+
+    private:
+        DWORD _frameInterval;
+    };
+
+    // Paints once output went idle for idleDelay milliseconds, but holds on to a frame
+    // for no longer than maxDelay milliseconds even if the output doesn't stop.
+    class IdleRenderScheduler final : public RenderScheduler
+    {
+    public:
+        IdleRenderScheduler(const DWORD idleDelay, const DWORD maxDelay) noexcept;
+        DWORD GetFrameDelay(const FrameTiming& timing) const noexcept override;
+
+    private:
+        DWORD _idleDelay;
+        DWORD _maxDelay;
+    };
+
+    // A snapshot of Renderer::GetRenderStats(). Times are in microseconds.
+    struct RenderStats
+    {
+        // Calls to Renderer::PaintFrame() that painted anything, regardless of the number of engines.
+        uint64_t framesPainted = 0;
+        // Paint requests that didn't get a frame of their own,
+        // because they got coalesced into a frame that was already pending.
+        uint64_t requestsCoalesced = 0;
+        uint64_t rowsPainted = 0;
+        uint64_t lockWaitTime = 0;
+        uint64_t paintTime = 0;
+
+        // The same counters, but only for the most recently painted frame.
+        uint64_t lastFrameRowsPainted = 0;
+        uint64_t lastFrameLockWaitTime = 0;
+        uint64_t lastFramePaintTime = 0;
+    };
+}
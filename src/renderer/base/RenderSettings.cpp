@@ -8,6 +8,8 @@
 #include "../../types/inc/ColorFix.hpp"
 #include "../../types/inc/colorTable.hpp"
 
+#include <til/small_vector.h>
+
 using namespace Microsoft::Console::Render;
 using Microsoft::Console::Utils::InitializeColorTable;
 
@@ -15,6 +17,12 @@ static constexpr size_t AdjustedFgIndex{ 16 };
 static constexpr size_t AdjustedBgIndex{ 17 };
 static constexpr size_t AdjustedBrightFgIndex{ 18 };
 
+// See perceivableColorKey() further below.
+static constexpr uint64_t PerceivableColorCacheMultiplier{ 0x9E3779B97F4B };
+static constexpr uint64_t PerceivableColorCacheKeyMask{ (uint64_t{ 1 } << 48) - 1 };
+static constexpr int PerceivableColorCacheTagBits{ 38 };
+static constexpr uint64_t PerceivableColorCacheTagMask{ (uint64_t{ 1 } << PerceivableColorCacheTagBits) - 1 };
+
 RenderSettings::RenderSettings() noexcept
 {
     InitializeColorTable(_colorTable);
@@ -78,6 +86,10 @@ void RenderSettings::ResetColorTable() noexcept
 //   color pair to the adjusted foreground for that color pair
 void RenderSettings::MakeAdjustedColorArray() noexcept
 {
+    // This is called whenever the color scheme changes. The cached RGB pairs don't go stale
+    // (they only depend on the two colors), but most of them belong to the old scheme now.
+    _ClearPerceivableColorCache();
+
     // The color table has 16 colors, but the adjusted color table needs to be 19
     // to include the default background, default foreground and bright default foreground colors
     std::array<COLORREF, 19> colorTableWithDefaults;
@@ -183,6 +195,77 @@ size_t RenderSettings::GetColorAliasIndex(const ColorAlias alias) const noexcept
 // Return Value:
 // - The color values of the attribute's foreground and background.
 std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttribute& attr) const noexcept
+{
+    COLORREF fg{};
+    COLORREF bg{};
+
+    if (_ResolveAttributeColors(attr, fg, bg))
+    {
+        fg = _GetPerceivableColor(fg, bg);
+    }
+
+    return { fg, bg };
+}
+
+// Routine Description:
+// - Calculates the RGB colors of a list of text attributes, like the attribute runs of a row.
+//   It's the same as calling GetAttributeColors() for each of them, but the foreground colors that
+//   need to be adjusted for perceivability and aren't cached yet are adjusted in a single batch.
+// Arguments:
+// - attrs - The TextAttributes to retrieve the colors for.
+// - colors - Receives the foreground and background color of each attribute.
+void RenderSettings::GetAttributeColors(gsl::span<const TextAttribute> attrs, gsl::span<std::pair<COLORREF, COLORREF>> colors) const
+{
+    const auto count = std::min(attrs.size(), colors.size());
+    til::small_vector<size_t, 32> pending;
+    til::small_vector<COLORREF, 32> pendingFg;
+    til::small_vector<COLORREF, 32> pendingBg;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& [fg, bg] = til::at(colors, i);
+        if (!_ResolveAttributeColors(til::at(attrs, i), fg, bg))
+        {
+            continue;
+        }
+
+        if (fg > 0xffffff || bg > 0xffffff)
+        {
+            fg = _GetPerceivableColor(fg, bg);
+        }
+        else if (!_TryGetCachedPerceivableColor(fg, bg, fg))
+        {
+            pending.emplace_back(i);
+            pendingFg.emplace_back(fg);
+            pendingBg.emplace_back(bg);
+        }
+    }
+
+    if (pending.empty())
+    {
+        return;
+    }
+
+    ColorFix::GetPerceivableColors(pendingFg, pendingBg);
+
+    for (size_t j = 0; j < pending.size(); ++j)
+    {
+        auto& [fg, bg] = til::at(colors, pending[j]);
+        _CachePerceivableColor(fg, bg, pendingFg[j]);
+        fg = pendingFg[j];
+    }
+}
+
+// Routine Description:
+// - Resolves the colors of a given text attribute, but doesn't adjust the foreground
+//   color of RGB pairs for perceivability yet (AlwaysDistinguishableColors).
+// Arguments:
+// - attr - The TextAttribute to retrieve the colors for.
+// - fg - Receives the foreground color.
+// - bg - Receives the background color.
+// Return Value:
+// - true if fg still needs to be adjusted via _GetPerceivableColor().
+bool RenderSettings::_ResolveAttributeColors(const TextAttribute& attr, COLORREF& fg, COLORREF& bg) const noexcept
 {
     _blinkIsInUse = _blinkIsInUse || attr.IsBlinking();
 
@@ -223,21 +306,20 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
 
         if (swapFgAndBg)
         {
-            const auto fg = _adjustedForegroundColors[fgIndex][bgIndex];
-            const auto bg = fgTextColor.GetColor(_colorTable, defaultFgIndex, brightenFg);
-            return { fg, bg };
+            fg = _adjustedForegroundColors[fgIndex][bgIndex];
+            bg = fgTextColor.GetColor(_colorTable, defaultFgIndex, brightenFg);
         }
         else
         {
-            const auto fg = _adjustedForegroundColors[bgIndex][fgIndex];
-            const auto bg = bgTextColor.GetColor(_colorTable, defaultBgIndex);
-            return { fg, bg };
+            fg = _adjustedForegroundColors[bgIndex][fgIndex];
+            bg = bgTextColor.GetColor(_colorTable, defaultBgIndex);
         }
+        return false;
     }
     else
     {
-        auto fg = fgTextColor.GetColor(_colorTable, defaultFgIndex, brightenFg);
-        auto bg = bgTextColor.GetColor(_colorTable, defaultBgIndex);
+        fg = fgTextColor.GetColor(_colorTable, defaultFgIndex, brightenFg);
+        bg = bgTextColor.GetColor(_colorTable, defaultBgIndex);
 
         if (dimFg)
         {
@@ -255,14 +337,77 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
         // We intentionally aren't _only_ checking for attr.IsInvisible here, because we also want to
         // catch the cases where the fg was intentionally set to be the same as the bg. In either case,
         // don't adjust the foreground.
-        if (Feature_AdjustIndistinguishableText::IsEnabled() &&
-            fg != bg &&
-            GetRenderMode(Mode::AlwaysDistinguishableColors))
-        {
-            fg = ColorFix::GetPerceivableColor(fg, bg);
-        }
+        return Feature_AdjustIndistinguishableText::IsEnabled() &&
+               fg != bg &&
+               GetRenderMode(Mode::AlwaysDistinguishableColors);
+    }
+}
+
+// Routine Description:
+// - Returns ColorFix::GetPerceivableColor(fg, bg), but memoized, since the CIELAB conversions and DeltaE
+//   iterations it performs are far too expensive to be done for every cell of every frame.
+// Arguments:
+// - fg - The foreground color.
+// - bg - The background color.
+// Return Value:
+// - The foreground color after making it perceivable on the background.
+COLORREF RenderSettings::_GetPerceivableColor(const COLORREF fg, const COLORREF bg) const noexcept
+{
+    // Colors with an alpha component don't fit into the cache. They don't occur in practice.
+    if (fg > 0xffffff || bg > 0xffffff)
+    {
+        return ColorFix::GetPerceivableColor(fg, bg);
+    }
+
+    COLORREF result{};
+    if (!_TryGetCachedPerceivableColor(fg, bg, result))
+    {
+        result = ColorFix::GetPerceivableColor(fg, bg);
+        _CachePerceivableColor(fg, bg, result);
+    }
+    return result;
+}
 
-        return { fg, bg };
+// The perceivable color cache is a fixed-size, direct-mapped table of 64-bit entries, accessed with relaxed atomics:
+// Concurrent lookups may at worst miss an entry that's just being replaced and compute the color again.
+// The 48-bit key (fg << 24 | bg) is scrambled by multiplying it with an odd constant, which is a bijection
+// modulo 2^48. Its top bits select the slot and the remaining bits (the tag) are stored alongside the result.
+// Since slot and tag together are the whole scrambled key, a matching tag means a matching color pair.
+// Entry layout: tag (38 bits) | color (24 bits) | valid (1 bit)
+static uint64_t perceivableColorKey(const COLORREF fg, const COLORREF bg) noexcept
+{
+    return (uint64_t{ fg } << 24 | bg) * PerceivableColorCacheMultiplier & PerceivableColorCacheKeyMask;
+}
+
+bool RenderSettings::_TryGetCachedPerceivableColor(const COLORREF fg, const COLORREF bg, COLORREF& result) const noexcept
+{
+    static_assert(PerceivableColorCacheSize == (PerceivableColorCacheKeyMask >> PerceivableColorCacheTagBits) + 1);
+
+    const auto key = perceivableColorKey(fg, bg);
+    const auto entry = til::at(_perceivableColorCache, key >> PerceivableColorCacheTagBits).load(std::memory_order_relaxed);
+
+    if ((entry & 1) && (entry >> 25) == (key & PerceivableColorCacheTagMask))
+    {
+        result = static_cast<COLORREF>(entry >> 1 & 0xffffff);
+        return true;
+    }
+    return false;
+}
+
+void RenderSettings::_CachePerceivableColor(const COLORREF fg, const COLORREF bg, const COLORREF result) const noexcept
+{
+    const auto key = perceivableColorKey(fg, bg);
+    const auto entry = (key & PerceivableColorCacheTagMask) << 25 | uint64_t{ result & 0xffffff } << 1 | 1;
+    til::at(_perceivableColorCache, key >> PerceivableColorCacheTagBits).store(entry, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Drops all entries from the perceivable color cache.
+void RenderSettings::_ClearPerceivableColorCache() noexcept
+{
+    for (auto& entry : _perceivableColorCache)
+    {
+        entry.store(0, std::memory_order_relaxed);
     }
 }
 
@@ -64,6 +64,11 @@ Renderer::~Renderer()
 // - HRESULT S_OK, GDI error, Safe Math error, or state/argument errors.
 [[nodiscard]] HRESULT Renderer::PaintFrame()
 {
+    _frameRowsPainted = 0;
+    _frameLockWaitTime = 0;
+    _framePaintTime = 0;
+    _framePainted = false;
+
     FOREACH_ENGINE(pEngine)
     {
         auto tries = maxRetriesForRenderEngine;
@@ -102,6 +107,21 @@ Renderer::~Renderer()
         }
     }
 
+    {
+        // A frame counts once, no matter how many engines painted it.
+        const auto stats = _stats.lock();
+        stats->lockWaitTime += _frameLockWaitTime;
+        if (_framePainted)
+        {
+            stats->framesPainted++;
+            stats->rowsPainted += _frameRowsPainted;
+            stats->paintTime += _framePaintTime;
+            stats->lastFrameRowsPainted = _frameRowsPainted;
+            stats->lastFrameLockWaitTime = _frameLockWaitTime;
+            stats->lastFramePaintTime = _framePaintTime;
+        }
+    }
+
     return S_OK;
 }
 
@@ -110,11 +130,15 @@ try
 {
     FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
 
+    const auto lockStart = std::chrono::steady_clock::now();
     _pData->LockConsole();
     auto unlock = wil::scope_exit([&]() {
         _pData->UnlockConsole();
     });
 
+    const auto paintStart = std::chrono::steady_clock::now();
+    _frameLockWaitTime += s_MicrosecondsBetween(lockStart, paintStart);
+
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
 
@@ -178,6 +202,9 @@ try
     // Trigger out-of-lock presentation for renderers that can support it
     RETURN_IF_FAILED(pEngine->Present());
 
+    _framePaintTime += s_MicrosecondsBetween(paintStart, std::chrono::steady_clock::now());
+    _framePainted = true;
+
     // As we leave the scope, EndPaint will be called (declared above)
     return S_OK;
 }
@@ -658,6 +685,42 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
     _pThread->WaitForPaintCompletionAndDisable(dwTimeoutMs);
 }
 
+// Routine Description:
+// - Sets the scheduler that decides when the render thread paints requested frames.
+// Arguments:
+// - scheduler - The new scheduler, or nullptr to paint every frame as soon as it's requested.
+// Return Value:
+// - <none>
+void Renderer::SetRenderScheduler(std::shared_ptr<RenderScheduler> scheduler)
+{
+    // When running the unit tests, we may be using a render without a render thread.
+    if (_pThread)
+    {
+        _pThread->SetScheduler(std::move(scheduler));
+    }
+}
+
+// Routine Description:
+// - Returns the counters about the frames that were painted so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - A snapshot of the counters.
+RenderStats Renderer::GetRenderStats() const
+{
+    auto stats = *_stats.lock_shared();
+    if (_pThread)
+    {
+        stats.requestsCoalesced = _pThread->GetCoalescedRequestCount();
+    }
+    return stats;
+}
+
+uint64_t Renderer::s_MicrosecondsBetween(const std::chrono::steady_clock::time_point begin, const std::chrono::steady_clock::time_point end) noexcept
+{
+    return gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+}
+
 // Routine Description:
 // - Paint helper to fill in the background color of the invalid area within the frame.
 // Arguments:
@@ -734,21 +797,22 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
             // of the backing buffer to fill in line 1 of the screen.
             const auto screenPosition = bufferLine.Origin() - til::point{ 0, view.Top() };
 
-            // Retrieve the cell information iterator limited to just this line we want to redraw.
-            auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
+            // Retrieve the row we want to redraw. Its text and attributes are read a run at a time.
+            const auto& bufferRow = buffer.GetRowByOffset(bufferLine.Origin().Y);
 
             // Calculate if two things are true:
             // 1. this row wrapped
             // 2. We're painting the last col of the row.
             // In that case, set lineWrapped=true for the _PaintBufferOutputHelper call.
-            const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().Y).WasWrapForced()) &&
+            const auto lineWrapped = bufferRow.WasWrapForced() &&
                                      (bufferLine.RightExclusive() == buffer.GetSize().Width());
 
             // Prepare the appropriate line transform for the current row and viewport offset.
             LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.Y, view.Left()));
 
             // Ask the helper to paint through this specific line.
-            _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+            _PaintBufferOutputHelper(pEngine, bufferRow.GetSlice(bufferLine.Left(), bufferLine.RightExclusive()), screenPosition, lineWrapped);
+            _frameRowsPainted++;
         }
     }
 }
@@ -759,154 +823,170 @@ static bool _IsAllSpaces(const std::wstring_view v)
     return v.find_first_not_of(L' ') == decltype(v)::npos;
 }
 
+// Routine Description:
+// - Paints a slice of a row, one run of clusters with identical attributes (and patterns and font) at a time.
+// Arguments:
+// - pEngine - The engine to paint with
+// - slice - The columns of the row to paint
+// - target - The screen position of the slice's first column
+// - lineWrapped - Whether the row wrapped and we're painting its last column
 void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
+                                        const RowSlice& slice,
                                         const til::point target,
                                         const bool lineWrapped)
 {
-    auto globalInvert{ _renderSettings.GetRenderMode(RenderSettings::Mode::ScreenReversed) };
+    const auto columnBegin = slice.ColumnBegin();
+    const auto columnEnd = slice.ColumnEnd();
 
     // If we have valid data, let's figure out how to draw it.
-    if (it)
+    if (columnBegin >= columnEnd)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
-        til::CoordType cols = 0;
-
-        // Retrieve the first color.
-        auto color = it->TextAttr();
-        // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
-        // Determine whether we're using a soft font.
-        auto usingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-
-        // And hold the point where we should start drawing.
-        auto screenPoint = target;
-
-        // This outer loop will continue until we reach the end of the text we are trying to draw.
-        while (it)
+        return;
+    }
+
+    auto globalInvert{ _renderSettings.GetRenderMode(RenderSettings::Mode::ScreenReversed) };
+
+    // The attribute runs of the slice. Within a run the attributes can't change,
+    // so we only need to compare them when we cross into the next run.
+    const auto& runs = slice.Attributes().runs();
+    auto runIt = runs.begin();
+    auto runEnd = columnBegin + runIt->length;
+
+    til::CoordType glyphColumns = 0;
+    auto column = columnBegin;
+    til::CoordType cols = 0;
+
+    // Retrieve the first color.
+    auto color = runIt->value;
+    // Retrieve the first pattern id
+    auto patternIds = _pData->GetPatternId(target);
+    // Determine whether we're using a soft font.
+    auto usingSoftFont = s_IsSoftFontChar(slice.GlyphAt(column, glyphColumns), _firstSoftFontChar, _lastSoftFontChar);
+
+    // And hold the point where we should start drawing.
+    auto screenPoint = target;
+
+    // This outer loop will continue until we reach the end of the text we are trying to draw.
+    while (column < columnEnd)
+    {
+        // Hold onto the current run color right here for the length of the outer loop.
+        // We'll be changing the persistent one as we run through the inner loops to detect
+        // when a run changes, but we will still need to know this color at the bottom
+        // when we go to draw gridlines for the length of the run.
+        const auto currentRunColor = color;
+
+        // Update the drawing brushes with our color and font usage.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
+
+        // Advance the point by however many columns we've just outputted and reset the accumulator.
+        screenPoint.X += cols;
+        cols = 0;
+
+        // Hold onto the start of this run and the target location where we started
+        // in case we need to do some special work to paint the line drawing characters.
+        const auto currentRunColumnStart = column;
+        const auto currentRunTargetStart = screenPoint;
+
+        // Ensure that our cluster vector is clear.
+        _clusterBuffer.clear();
+
+        // Reset our flag to know when we're in the special circumstance
+        // of attempting to draw only the right-half of a two-column character
+        // as the first item in our run.
+        auto trimLeft = false;
+
+        // Run contains wide character (>1 columns)
+        auto containsWideCharacter = false;
+
+        // This inner loop will accumulate clusters until the color changes.
+        // When the color changes, it will save the new color off and break.
+        // We also accumulate clusters according to regex patterns
+        do
         {
-            // Hold onto the current run color right here for the length of the outer loop.
-            // We'll be changing the persistent one as we run through the inner loops to detect
-            // when a run changes, but we will still need to know this color at the bottom
-            // when we go to draw gridlines for the length of the run.
-            const auto currentRunColor = color;
-
-            // Hold onto the current pattern id as well
-            const auto currentPatternId = patternIds;
-
-            // Update the drawing brushes with our color and font usage.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
-
-            // Advance the point by however many columns we've just outputted and reset the accumulator.
-            screenPoint.X += cols;
-            cols = 0;
-
-            // Hold onto the start of this run iterator and the target location where we started
-            // in case we need to do some special work to paint the line drawing characters.
-            const auto currentRunItStart = it;
-            const auto currentRunTargetStart = screenPoint;
-
-            // Ensure that our cluster vector is clear.
-            _clusterBuffer.clear();
-
-            // Reset our flag to know when we're in the special circumstance
-            // of attempting to draw only the right-half of a two-column character
-            // as the first item in our run.
-            auto trimLeft = false;
-
-            // Run contains wide character (>1 columns)
-            auto containsWideCharacter = false;
-
-            // This inner loop will accumulate clusters until the color changes.
-            // When the color changes, it will save the new color off and break.
-            // We also accumulate clusters according to regex patterns
-            do
+            while (column >= runEnd)
+            {
+                ++runIt;
+                runEnd += runIt->length;
+            }
+
+            const auto glyph = slice.GlyphAt(column, glyphColumns);
+            const til::point thisPoint{ screenPoint.X + cols, screenPoint.Y };
+            const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
+            const auto thisUsingSoftFont = s_IsSoftFontChar(glyph, _firstSoftFontChar, _lastSoftFontChar);
+            const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
+            if (color != runIt->value || changedPatternOrFont)
             {
-                til::point thisPoint{ screenPoint.X + cols, screenPoint.Y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
-                const auto thisUsingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-                const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
-                if (color != it->TextAttr() || changedPatternOrFont)
+                const auto& newAttr{ runIt->value };
+                // foreground doesn't matter for runs of spaces (!)
+                // if we trick it . . . we call Paint far fewer times for cmatrix
+                if (!_IsAllSpaces(glyph) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
                 {
-                    auto newAttr{ it->TextAttr() };
-                    // foreground doesn't matter for runs of spaces (!)
-                    // if we trick it . . . we call Paint far fewer times for cmatrix
-                    if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
-                    {
-                        color = newAttr;
-                        patternIds = thisPointPatterns;
-                        usingSoftFont = thisUsingSoftFont;
-                        break; // vend this run
-                    }
+                    color = newAttr;
+                    patternIds = thisPointPatterns;
+                    usingSoftFont = thisUsingSoftFont;
+                    break; // vend this run
                 }
+            }
 
-                // Walk through the text data and turn it into rendering clusters.
-                // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
-                auto columnCount = it->Columns();
+            // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
+            auto columnCount = glyphColumns;
 
-                // If we're on the first cluster to be added and it's marked as "trailing"
-                // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr() == DbcsAttribute::Trailing)
-                {
-                    // Move left to the one so the whole character can be struck correctly.
-                    --screenPoint.X;
-                    // And tell the next function to trim off the left half of it.
-                    trimLeft = true;
-                    // And add one to the number of columns we expect it to take as we insert it.
-                    ++columnCount;
-                }
+            // If we're on the first cluster to be added and it's the trailing half of a two column character,
+            // then we need some special handling. GlyphAt() counts it as 1 column, since that's all that's left of it.
+            if (_clusterBuffer.empty() && slice.IsTrailer(column))
+            {
+                // Move left to the one so the whole character can be struck correctly.
+                --screenPoint.X;
+                // And tell the next function to trim off the left half of it.
+                trimLeft = true;
+                // And add one to the number of columns we expect it to take as we insert it.
+                ++columnCount;
+            }
 
-                if (columnCount > 1)
-                {
-                    containsWideCharacter = true;
-                }
+            if (columnCount > 1)
+            {
+                containsWideCharacter = true;
+            }
 
-                // Advance the cluster and column counts.
-                _clusterBuffer.emplace_back(it->Chars(), columnCount);
-                it += std::max(it->Columns(), 1); // prevent infinite loop for no visible columns
-                cols += columnCount;
+            // Advance the cluster and column counts.
+            _clusterBuffer.emplace_back(glyph, columnCount);
+            column += glyphColumns;
+            cols += columnCount;
 
-            } while (it);
+        } while (column < columnEnd);
 
-            // Do the painting.
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
+        // Do the painting.
+        THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
 
-            // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
-            // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+        // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
+        // We're only allowed to draw the grid lines under certain circumstances.
+        if (_pData->IsGridLineDrawingAllowed())
+        {
+            // See GH: 803
+            // If we found a wide character while we looped above, it's possible we skipped over the right half
+            // attribute that could have contained different line information than the left half.
+            if (containsWideCharacter)
             {
-                // See GH: 803
-                // If we found a wide character while we looped above, it's possible we skipped over the right half
-                // attribute that could have contained different line information than the left half.
-                if (containsWideCharacter)
+                // Start from the original target in this run.
+                auto lineTarget = currentRunTargetStart;
+
+                // We need to go through the attributes again to ensure we get the lines associated with each
+                // exact column. The code above will condense two-column characters into one, but it is possible
+                // (like with the IME) that the line drawing characters will vary from the left to right half
+                // of a wider character.
+                const auto& attributes = slice.Attributes();
+                for (til::CoordType colsPainted = 0; colsPainted < cols; ++colsPainted, ++lineTarget.X)
                 {
-                    // Start from the original position in this run.
-                    auto lineIt = currentRunItStart;
-                    // Start from the original target in this run.
-                    auto lineTarget = currentRunTargetStart;
-
-                    // We need to go through the iterators again to ensure we get the lines associated with each
-                    // exact column. The code above will condense two-column characters into one, but it is possible
-                    // (like with the IME) that the line drawing characters will vary from the left to right half
-                    // of a wider character.
-                    // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
-                    // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (til::CoordType colsPainted = 0; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.X)
-                    {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
-                    }
-                }
-                else
-                {
-                    // If nothing exciting is going on, draw the lines in bulk.
-                    _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
+                    const auto lineColumn = std::min(currentRunColumnStart + colsPainted, columnEnd - 1);
+                    const auto lines = attributes.at(gsl::narrow_cast<uint16_t>(lineColumn - columnBegin));
+                    _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
                 }
             }
+            else
+            {
+                // If nothing exciting is going on, draw the lines in bulk.
+                _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
+            }
         }
     }
 }
@@ -1138,9 +1218,9 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
                     const til::point target{ viewDirty.Left, iRow };
                     const auto source = target - overlay.origin;
 
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
+                    const auto& row = overlay.buffer.GetRowByOffset(source.Y);
 
-                    _PaintBufferOutputHelper(&engine, it, target, false);
+                    _PaintBufferOutputHelper(&engine, row.GetSlice(source.X, row.size()), target, false);
                 }
             }
         }
@@ -16,6 +16,8 @@ Author(s):
 
 #pragma once
 
+#include <chrono>
+
 #include "../inc/IRenderEngine.hpp"
 #include "../inc/RenderSettings.hpp"
 
@@ -81,6 +83,9 @@ namespace Microsoft::Console::Render
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs);
         void WaitUntilCanRender();
 
+        void SetRenderScheduler(std::shared_ptr<RenderScheduler> scheduler);
+        RenderStats GetRenderStats() const;
+
         void AddRenderEngine(_In_ IRenderEngine* const pEngine);
 
         void SetBackgroundColorChangedCallback(std::function<void()> pfn);
@@ -93,12 +98,13 @@ namespace Microsoft::Console::Render
     private:
         static IRenderEngine::GridLineSet s_GetGridlines(const TextAttribute& textAttribute) noexcept;
         static bool s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSoftFontChar, const size_t lastSoftFontChar);
+        static uint64_t s_MicrosecondsBetween(const std::chrono::steady_clock::time_point begin, const std::chrono::steady_clock::time_point end) noexcept;
 
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
         bool _CheckViewportAndScroll();
         [[nodiscard]] HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
-        void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine, TextBufferCellIterator it, const til::point target, const bool lineWrapped);
+        void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine, const RowSlice& slice, const til::point target, const bool lineWrapped);
         void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine, const TextAttribute textAttribute, const size_t cchLine, const til::point coordTarget);
         void _PaintSelection(_In_ IRenderEngine* const pEngine);
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
@@ -125,6 +131,13 @@ namespace Microsoft::Console::Render
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
+        // Written by the render thread after every frame, read by whoever wants to know.
+        til::shared_mutex<RenderStats> _stats;
+        // The counters of the frame PaintFrame() is working on, summed up over all engines.
+        uint64_t _frameRowsPainted = 0;
+        uint64_t _frameLockWaitTime = 0;
+        uint64_t _framePaintTime = 0;
+        bool _framePainted = false;
         bool _destructing = false;
         bool _forceUpdateViewport = true;
 
@@ -208,6 +208,8 @@ DWORD WINAPI RenderThread::_ThreadProc()
             ResetEvent(_hEvent);
         }
 
+        _WaitForScheduledFrame();
+
         ResetEvent(_hPaintCompletedEvent);
 
         _pRenderer->WaitUntilCanRender();
@@ -219,8 +221,58 @@ DWORD WINAPI RenderThread::_ThreadProc()
     return S_OK;
 }
 
+// Method Description:
+// - Holds on to the requested frame for as long as the scheduler wants us to.
+//   Paint requests that arrive in the meantime are coalesced into this frame.
+void RenderThread::_WaitForScheduledFrame() noexcept
+{
+    if (const auto scheduler = *_scheduler.lock_shared())
+    {
+        for (;;)
+        {
+            FrameTiming timing;
+            timing.now = GetTickCount64();
+            timing.firstRequest = _firstRequestTime.load(std::memory_order_relaxed);
+            timing.lastRequest = _lastRequestTime.load(std::memory_order_relaxed);
+            timing.lastFrame = _lastFrameTime;
+
+            // If NotifyPaint() didn't get to store the timestamp yet, the request is as recent as it gets.
+            if (!timing.firstRequest)
+            {
+                timing.firstRequest = timing.lastRequest = timing.now;
+            }
+
+            const auto delay = scheduler->GetFrameDelay(timing);
+            if (!delay || !_fKeepRunning)
+            {
+                break;
+            }
+
+            // NotifyPaint() doesn't signal _hEvent while we aren't _fWaiting.
+            // Only the destructor does, because it wants the last frame out right away.
+            WaitForSingleObject(_hEvent, delay);
+        }
+    }
+
+    // The frame we're about to paint covers every request up to this point. Any request
+    // that arrives after this will set _fNextFrameRequested again and get its own frame.
+    _fNextFrameRequested.store(false, std::memory_order_release);
+    _firstRequestTime.store(0, std::memory_order_relaxed);
+    _lastFrameTime = GetTickCount64();
+}
+
 void RenderThread::NotifyPaint() noexcept
 {
+    // Remember when the pending frame was first and last requested, for the scheduler.
+    // If a frame was pending already, this request gets coalesced into it.
+    const auto now = GetTickCount64();
+    uint64_t expected = 0;
+    if (!_firstRequestTime.compare_exchange_strong(expected, now, std::memory_order_relaxed))
+    {
+        _coalescedRequests.fetch_add(1, std::memory_order_relaxed);
+    }
+    _lastRequestTime.store(now, std::memory_order_relaxed);
+
     if (_fWaiting.load(std::memory_order_acquire))
     {
         SetEvent(_hEvent);
@@ -297,3 +349,19 @@ void RenderThread::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noe
     ResetEvent(_hPaintEnabledEvent);
     WaitForSingleObject(_hPaintCompletedEvent, dwTimeoutMs);
 }
+
+// Method Description:
+// - Sets the scheduler that decides when requested frames are painted.
+// Arguments:
+// - scheduler: the new scheduler, or nullptr to paint every frame as soon as it's requested.
+void RenderThread::SetScheduler(std::shared_ptr<RenderScheduler> scheduler) noexcept
+{
+    *_scheduler.lock() = std::move(scheduler);
+}
+
+// Method Description:
+// - Returns the number of paint requests that got coalesced into a frame that was already pending.
+uint64_t RenderThread::GetCoalescedRequestCount() const noexcept
+{
+    return _coalescedRequests.load(std::memory_order_relaxed);
+}
@@ -14,6 +14,10 @@ Author(s):
 
 #pragma once
 
+#include <til/mutex.h>
+
+#include "RenderScheduler.hpp"
+
 namespace Microsoft::Console::Render
 {
     class Renderer;
@@ -31,9 +35,13 @@ namespace Microsoft::Console::Render
         void DisablePainting() noexcept;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noexcept;
 
+        void SetScheduler(std::shared_ptr<RenderScheduler> scheduler) noexcept;
+        uint64_t GetCoalescedRequestCount() const noexcept;
+
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
+        void _WaitForScheduledFrame() noexcept;
 
         HANDLE _hThread;
         HANDLE _hEvent;
@@ -46,5 +54,15 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+
+        // The scheduler may be replaced while the thread is running, which is why it's guarded by a lock.
+        // nullptr behaves like LowLatencyRenderScheduler.
+        til::shared_mutex<std::shared_ptr<RenderScheduler>> _scheduler;
+        // GetTickCount64() of the first and most recent NotifyPaint() since the last frame started.
+        // _firstRequestTime is 0 while no frame is pending.
+        std::atomic<uint64_t> _firstRequestTime{ 0 };
+        std::atomic<uint64_t> _lastRequestTime{ 0 };
+        uint64_t _lastFrameTime = 0;
+        std::atomic<uint64_t> _coalescedRequests{ 0 };
     };
 }
@@ -41,14 +41,26 @@ namespace Microsoft::Console::Render
         void SetColorAliasIndex(const ColorAlias alias, const size_t tableIndex) noexcept;
         size_t GetColorAliasIndex(const ColorAlias alias) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept;
+        void GetAttributeColors(gsl::span<const TextAttribute> attrs, gsl::span<std::pair<COLORREF, COLORREF>> colors) const;
         std::pair<COLORREF, COLORREF> GetAttributeColorsWithAlpha(const TextAttribute& attr) const noexcept;
         void ToggleBlinkRendition(class Renderer& renderer) noexcept;
 
     private:
+        // The number of RGB color pairs the perceivable color cache can hold. Each entry is 8 bytes.
+        static constexpr size_t PerceivableColorCacheSize = 1024;
+
+        bool _ResolveAttributeColors(const TextAttribute& attr, COLORREF& fg, COLORREF& bg) const noexcept;
+        COLORREF _GetPerceivableColor(COLORREF fg, COLORREF bg) const noexcept;
+        bool _TryGetCachedPerceivableColor(COLORREF fg, COLORREF bg, COLORREF& result) const noexcept;
+        void _CachePerceivableColor(COLORREF fg, COLORREF bg, COLORREF result) const noexcept;
+        void _ClearPerceivableColorCache() noexcept;
+
         til::enumset<Mode> _renderMode{ Mode::BlinkAllowed, Mode::IntenseIsBright };
         std::array<COLORREF, TextColor::TABLE_SIZE> _colorTable;
         std::array<size_t, static_cast<size_t>(ColorAlias::ENUM_COUNT)> _colorAliasIndices;
         std::array<std::array<COLORREF, 19>, 19> _adjustedForegroundColors;
+        // Memoizes ColorFix::GetPerceivableColor() for RGB color pairs. See _GetPerceivableColor().
+        mutable std::array<std::atomic<uint64_t>, PerceivableColorCacheSize> _perceivableColorCache{};
         size_t _blinkCycle = 0;
         mutable bool _blinkIsInUse = false;
         bool _blinkShouldBeFaint = false;
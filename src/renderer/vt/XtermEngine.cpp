@@ -82,6 +82,13 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
         }
     }
 
+    // If we just cleared the terminal, resized it, or the buffer circled,
+    // then we can't trust what we remember about its contents anymore.
+    if (_clearedAllThisFrame || _circled || _shadowSize != _lastViewport.Dimensions())
+    {
+        _ResetShadow();
+    }
+
     if (!_quickReturn)
     {
         if (_WillWriteSingleChar())
@@ -397,6 +404,7 @@ try
         RETURN_IF_FAILED(_MoveCursor({ 0, 0 }));
         RETURN_IF_FAILED(_InsertLine(absDy));
     }
+    _ScrollShadow(dy);
 
     // Restore our wrap state.
     _wrappedRow = oldWrappedRow;
@@ -509,8 +517,14 @@ CATCH_RETURN();
                                                    const bool /*trimLeft*/,
                                                    const bool lineWrapped) noexcept
 {
-    return _fUseAsciiOnly ?
-               VtEngine::_PaintAsciiBufferLine(clusters, coord) :
+    if (_fUseAsciiOnly)
+    {
+        return VtEngine::_PaintAsciiBufferLine(clusters, coord);
+    }
+
+    // Only send the parts of the line that the terminal doesn't display already.
+    return _CanPaintChangedOnly(coord, lineWrapped) ?
+               VtEngine::_PaintChangedUtf8BufferLine(clusters, coord) :
                VtEngine::_PaintUtf8BufferLine(clusters, coord, lineWrapped);
 }
 
@@ -523,9 +537,7 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr) noexcept
 {
-    RETURN_IF_FAILED(_fUseAsciiOnly ?
-                         VtEngine::_WriteTerminalAscii(wstr) :
-                         VtEngine::_WriteTerminalUtf8(wstr));
+    RETURN_IF_FAILED(AppendTerminalW(wstr));
     // GH#4106, GH#2011 - WriteTerminalW is only ever called by the
     // StateMachine, when we've encountered a string we don't understand. When
     // this happens, we usually don't actually trigger another frame, but we
@@ -535,9 +547,27 @@ CATCH_RETURN();
     // actual frame is triggered.
     //
     // To fix this, flush here, so this string is sent to the connected terminal
-    // application.
+    // application. With async writes, the write policy may hold it back for a
+    // moment, to coalesce it with any strings or frames that follow.
 
-    return _Flush();
+    return _Flush(false);
+}
+
+// Method Description:
+// - Same as WriteTerminalW, but the string is only appended to our buffer.
+//      It's sent to the terminal with the next flush.
+// Arguments:
+// - wstr - wstring of text to be written
+// Return Value:
+// - S_OK or suitable HRESULT error from conversion.
+[[nodiscard]] HRESULT XtermEngine::AppendTerminalW(const std::wstring_view wstr) noexcept
+{
+    RETURN_IF_FAILED(_fUseAsciiOnly ?
+                         VtEngine::_WriteTerminalAscii(wstr) :
+                         VtEngine::_WriteTerminalUtf8(wstr));
+    // We don't know what the string did to the terminal's contents.
+    _ResetShadow();
+    return S_OK;
 }
 
 // Method Description:
@@ -129,12 +129,15 @@ CATCH_RETURN();
 // - Notifies us that we're about to be torn down. This gives us a last chance
 //      to force a repaint before the buffer contents are lost. The VT renderer
 //      needs to be able to render all text before it's lost, so we return true.
+//   The process may exit right after that last frame, so we stop writing
+//      asynchronously and write it synchronously instead.
 // Arguments:
 // - Receives a bool indicating if we should force the repaint.
 // Return Value:
 // - S_OK
 [[nodiscard]] HRESULT VtEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
 {
+    _StopWriter();
     *pForcePaint = true;
     return S_OK;
 }
@@ -25,6 +25,14 @@ using namespace Microsoft::Console::Types;
         return S_FALSE;
     }
 
+    // The writer thread failed since the last frame. Close the pipe now, instead of
+    // waiting for the next _Flush, which may not come until there's new output.
+    if (const auto hr = _GetWriterError(); FAILED(hr))
+    {
+        LOG_IF_FAILED(_WriteFailed(hr));
+        return S_FALSE;
+    }
+
     // If we're using line renditions, and this is a full screen paint, we can
     // potentially stop using them at the end of this frame.
     _stopUsingLineRenditions = _usingLineRenditions && _AllIsInvalid();
@@ -590,6 +598,7 @@ using namespace Microsoft::Console::Types;
         _delayedEolWrap = true;
     }
 
+    auto readdedSpaces = false;
     if (useEraseChar)
     {
         // ECH doesn't actually move the cursor itself. However, we think that
@@ -624,9 +633,18 @@ using namespace Microsoft::Console::Types;
             RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8(spaces));
 
             _lastText.X += numSpaces;
+            readdedSpaces = true;
         }
     }
 
+    // Remember what the terminal displays now. Trailing spaces that we neither
+    // wrote nor erased might still show something else, so they stay unknown.
+    if (!_usingSoftFont && !_usingLineRenditions && !_passthrough)
+    {
+        const auto wroteAll = !removeSpaces || useEraseChar || readdedSpaces;
+        _RecordShadow(clusters, coord, wroteAll ? totalWidth : columnsActual);
+    }
+
     // If we printed to the bottom line, and we previously thought that this was
     // a new bottom line, it certainly isn't new any longer.
     if (printingBottomLine)
@@ -638,6 +656,251 @@ using namespace Microsoft::Console::Types;
     return S_OK;
 }
 
+// Routine Description:
+// - Draws only those parts of a line of the buffer that differ from what the
+//      terminal already displays according to our shadow frame. Unchanged
+//      text between two changed spans is repainted anyway, if that takes fewer
+//      bytes than moving the cursor across it.
+// - The caller must have checked _CanPaintChangedOnly for this line.
+// Arguments:
+// - clusters - text and column widths to be written
+// - coord - character coordinate target to render within viewport
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_PaintChangedUtf8BufferLine(const gsl::span<const Cluster> clusters,
+                                                            const til::point coord) noexcept
+{
+    const auto utf8Length = [](const std::wstring_view text) noexcept {
+        size_t length = 0;
+        for (const auto ch : text)
+        {
+            // A surrogate pair encodes to 4 bytes in UTF-8, which is 2 per surrogate.
+            length += ch < 0x80 ? 1 : (ch < 0x800 || (ch >= 0xD800 && ch <= 0xDFFF)) ? 2 : 3;
+        }
+        return length;
+    };
+    // The length of "\x1b[#C".
+    const auto cursorForwardLength = [](const til::CoordType columns) noexcept {
+        return size_t{ columns < 10 ? 4u : columns < 100 ? 5u : 6u };
+    };
+
+    const auto count = clusters.size();
+    size_t i = 0;
+    auto x = coord.x;
+
+    while (i < count)
+    {
+        // Skip the clusters the terminal already displays.
+        while (i < count && _IsShadowed(til::at(clusters, i), { x, coord.y }))
+        {
+            x += til::at(clusters, i).GetColumns();
+            ++i;
+        }
+        if (i == count)
+        {
+            break;
+        }
+
+        const auto spanBegin = i;
+        const auto spanX = x;
+        auto spanEnd = i;
+        auto spanEndX = x;
+
+        while (i < count)
+        {
+            if (!_IsShadowed(til::at(clusters, i), { x, coord.y }))
+            {
+                x += til::at(clusters, i).GetColumns();
+                spanEnd = ++i;
+                spanEndX = x;
+                continue;
+            }
+
+            // Measure the unchanged gap up to the next changed cluster.
+            size_t gapLength = 0;
+            auto gapEnd = i;
+            auto gapEndX = x;
+            while (gapEnd < count && _IsShadowed(til::at(clusters, gapEnd), { gapEndX, coord.y }))
+            {
+                gapLength += utf8Length(til::at(clusters, gapEnd).GetText());
+                gapEndX += til::at(clusters, gapEnd).GetColumns();
+                ++gapEnd;
+            }
+            if (gapEnd == count || gapLength > cursorForwardLength(gapEndX - x))
+            {
+                break;
+            }
+            i = gapEnd;
+            x = gapEndX;
+        }
+
+        RETURN_IF_FAILED(_PaintUtf8BufferLine(clusters.subspan(spanBegin, spanEnd - spanBegin), { spanX, coord.y }, false));
+        i = spanEnd;
+        x = spanEndX;
+    }
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Determines whether we may skip the parts of this line that the terminal
+//      already displays. We can't when the line wraps (the terminal needs
+//      its last cell to be written to wrap it), when the frame starts from a
+//      cleared screen, or when the shadow frame doesn't match the viewport.
+// Arguments:
+// - coord - character coordinate target to render within viewport
+// - lineWrapped - true if this run we're painting is the end of a line that wrapped.
+// Return Value:
+// - true if _PaintChangedUtf8BufferLine can be used for this line.
+bool VtEngine::_CanPaintChangedOnly(const til::point coord, const bool lineWrapped) const noexcept
+{
+    return !lineWrapped &&
+           !_passthrough &&
+           !_usingSoftFont &&
+           !_usingLineRenditions &&
+           !_clearedAllThisFrame &&
+           !_wrappedRow.has_value() &&
+           !(_newBottomLine && coord.y == _lastViewport.BottomInclusive()) &&
+           coord.y >= _virtualTop &&
+           coord.y < _shadowSize.height &&
+           coord.x >= 0 &&
+           _shadowSize == _lastViewport.Dimensions();
+}
+
+// Routine Description:
+// - Checks whether the terminal already displays the given cluster at the
+//      given position, in the attributes that are currently selected.
+// Arguments:
+// - cluster - the text and column width of the glyph
+// - coord - character coordinate within the viewport
+// Return Value:
+// - true if the cluster doesn't need to be painted.
+bool VtEngine::_IsShadowed(const Cluster& cluster, const til::point coord) const noexcept
+{
+    const auto columns = cluster.GetColumns();
+    if (coord.x < 0 || coord.y < 0 || coord.x + columns > _shadowSize.width || coord.y >= _shadowSize.height)
+    {
+        return false;
+    }
+
+    const auto& cell = til::at(_shadowFrame, gsl::narrow_cast<size_t>(coord.y * _shadowSize.width + coord.x));
+    return cell.length != 0 &&
+           cell.columns == columns &&
+           std::wstring_view{ cell.text.data(), cell.length } == cluster.GetText() &&
+           cell.attributes == _lastTextAttributes;
+}
+
+// Routine Description:
+// - Records that the given clusters have been painted at the given position
+//      in the current attributes. Cells past the first knownColumns
+//      columns have been touched, but their contents are uncertain.
+// Arguments:
+// - clusters - text and column widths that were written
+// - coord - character coordinate within the viewport
+// - knownColumns - the number of columns whose contents we know
+// Return Value:
+// - <none>
+void VtEngine::_RecordShadow(const gsl::span<const Cluster> clusters, const til::point coord, const til::CoordType knownColumns) noexcept
+{
+    const auto width = _shadowSize.width;
+    if (coord.y < 0 || coord.y >= _shadowSize.height || coord.x < 0 || coord.x >= width)
+    {
+        return;
+    }
+
+    const auto row = gsl::make_span(_shadowFrame).subspan(gsl::narrow_cast<size_t>(coord.y * width), gsl::narrow_cast<size_t>(width));
+
+    // If we overwrote the trailing half of a wide glyph, the terminal erased all of it.
+    if (coord.x > 0 && til::at(row, coord.x - 1).columns > 1)
+    {
+        til::at(row, coord.x - 1) = {};
+    }
+
+    const auto knownEnd = coord.x + knownColumns;
+    auto x = coord.x;
+
+    for (const auto& cluster : clusters)
+    {
+        if (x >= width)
+        {
+            break;
+        }
+
+        const auto text = cluster.GetText();
+        const auto columns = std::max(cluster.GetColumns(), 1);
+        auto& cell = til::at(row, x);
+
+        if (x + columns <= std::min(knownEnd, width) && !text.empty() && text.size() <= cell.text.size())
+        {
+            cell.attributes = _lastTextAttributes;
+            std::copy(text.begin(), text.end(), cell.text.begin());
+            cell.length = gsl::narrow_cast<uint8_t>(text.size());
+            cell.columns = gsl::narrow_cast<uint8_t>(columns);
+        }
+        else
+        {
+            cell = {};
+        }
+
+        for (auto trailer = x + 1; trailer < x + columns && trailer < width; ++trailer)
+        {
+            til::at(row, trailer) = {};
+        }
+
+        x += columns;
+    }
+}
+
+// Routine Description:
+// - Moves the contents of the shadow frame along with the terminal's viewport,
+//      after we scrolled it with newlines (dy < 0) or by inserting lines at
+//      the top (dy > 0). The rows that were scrolled in are unknown.
+// Arguments:
+// - dy - the number of rows the viewport contents moved down by
+// Return Value:
+// - <none>
+void VtEngine::_ScrollShadow(const til::CoordType dy) noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(_shadowSize.width);
+    const auto rows = gsl::narrow_cast<size_t>(std::min(std::abs(dy), _shadowSize.height));
+    const auto shift = std::min(rows * width, _shadowFrame.size());
+    const auto begin = _shadowFrame.begin();
+    const auto end = _shadowFrame.end();
+
+    if (dy < 0)
+    {
+        std::move(begin + shift, end, begin);
+        std::fill(end - shift, end, ShadowCell{});
+    }
+    else if (dy > 0)
+    {
+        std::move_backward(begin, end - shift, end);
+        std::fill(begin, begin + shift, ShadowCell{});
+    }
+}
+
+// Routine Description:
+// - Forgets everything we know about the terminal's contents and resizes the
+//      shadow frame to the current viewport. Used whenever the terminal's
+//      contents changed in ways we don't track.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_ResetShadow() noexcept
+try
+{
+    const auto size = _lastViewport.Dimensions();
+    _shadowFrame.assign(gsl::narrow_cast<size_t>(std::max(size.width, 0)) * gsl::narrow_cast<size_t>(std::max(size.height, 0)), ShadowCell{});
+    _shadowSize = size;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    _shadowFrame.clear();
+    _shadowSize = {};
+}
+
 // Method Description:
 // - Updates the window's title string. Emits the VT sequence to SetWindowTitle.
 //      Because wintelnet does not understand these sequences by default, we
@@ -4,7 +4,6 @@
 #include "precomp.h"
 #include "vtrenderer.hpp"
 #include "../../inc/conattrs.hpp"
-#include "../../host/VtIo.hpp"
 
 // For _vcprintf
 #include <conio.h>
@@ -47,7 +46,8 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     _firstPaint(true),
     _skipCursor(false),
     _exitResult{ S_OK },
-    _terminalOwner{ nullptr },
+    _pfnCloseOutput{},
+    _pfnOutputFailed{},
     _newBottomLine{ false },
     _deferredCursorPos{ INVALID_COORDS },
     _inResizeRequest{ false },
@@ -67,6 +67,11 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 #endif
 }
 
+VtEngine::~VtEngine()
+{
+    _StopWriter();
+}
+
 // Method Description:
 // - Writes a fill of characters to our file handle (repeat of same character over and over)
 [[nodiscard]] HRESULT VtEngine::_WriteFill(const size_t n, const char c) noexcept
@@ -136,31 +141,287 @@ CATCH_RETURN();
     CATCH_RETURN();
 }
 
-[[nodiscard]] HRESULT VtEngine::_Flush() noexcept
+// Method Description:
+// - Hands everything written since the last flush to the pipe. By default it's
+//      written right away. If async writes are enabled (see SetWritePolicy), it's
+//      handed to the writer thread instead, which coalesces everything flushed
+//      while it was busy writing into a single write.
+// Arguments:
+// - urgent: false if the output may be held back according to the batching
+//      policy. The end of a frame is always urgent.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_Flush(const bool urgent) noexcept
 {
-    if (_hFile)
+    if (!_hFile)
+    {
+        return S_OK;
+    }
+
+    if (!_writer.joinable())
     {
-        auto fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
+        const auto hr = _WriteToPipe(_buffer);
         _buffer.clear();
-        if (!fSuccess)
+        return FAILED(hr) ? _WriteFailed(hr) : S_OK;
+    }
+
+    auto hr = S_OK;
+    try
+    {
+        std::unique_lock lock{ _writerLock };
+
+        // If the reader has fallen far behind, wait for it, like a synchronous write would.
+        _writerDrained.wait(lock, [&]() {
+            return _writerPending.size() < _writePolicy.maxPendingBytes || FAILED(_writerError);
+        });
+
+        hr = _writerError;
+        if (SUCCEEDED(hr))
         {
-            _exitResult = HRESULT_FROM_WIN32(GetLastError());
-            _hFile.reset();
-            if (_terminalOwner)
+            if (_writerPending.empty())
             {
-                _terminalOwner->CloseOutput();
+                _writerPendingSince = std::chrono::steady_clock::now();
             }
-            return _exitResult;
+            _writerPending.append(_buffer);
+            _writerUrgent |= urgent;
         }
     }
+    CATCH_RETURN();
+
+    _buffer.clear();
+
+    if (FAILED(hr))
+    {
+        return _WriteFailed(hr);
+    }
 
+    _writerWake.notify_one();
     return S_OK;
 }
 
+// Method Description:
+// - Synchronously writes the given output to the pipe and updates the write statistics.
+// Arguments:
+// - data: The output to write.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_WriteToPipe(const std::string_view data) noexcept
+{
+    if (data.empty())
+    {
+        return S_OK;
+    }
+
+    const auto beg = std::chrono::steady_clock::now();
+    const auto succeeded = !!WriteFile(_hFile.get(), data.data(), gsl::narrow_cast<DWORD>(data.size()), nullptr, nullptr);
+    const auto hr = succeeded ? S_OK : HRESULT_FROM_WIN32(GetLastError());
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - beg);
+    _trace.TraceWrite(data.size(), latency);
+
+    try
+    {
+        const std::unique_lock lock{ _writerLock };
+        _writeStats.writes++;
+        _writeStats.bytes += data.size();
+        _writeStats.largestWrite = std::max<uint64_t>(_writeStats.largestWrite, data.size());
+        _writeStats.totalLatency += latency;
+        _writeStats.slowestWrite = std::max(_writeStats.slowestWrite, latency);
+    }
+    CATCH_LOG();
+
+    return hr;
+}
+
+// Method Description:
+// - Closes our end of the pipe after a failed write and lets our owner know.
+// Arguments:
+// - hr: The error the write failed with.
+// Return Value:
+// - hr
+[[nodiscard]] HRESULT VtEngine::_WriteFailed(const HRESULT hr) noexcept
+{
+    _StopWriter();
+    _exitResult = hr;
+    _hFile.reset();
+    if (_pfnCloseOutput)
+    {
+        _pfnCloseOutput();
+    }
+    return hr;
+}
+
+// Method Description:
+// - The body of the writer thread used for async writes. It waits for _Flush to
+//      hand it output and writes it to the pipe. If the output isn't urgent, it
+//      waits for more according to the batching policy.
+//   It exits once it's asked to and everything has been written, or once a write failed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_WriterThread() noexcept
+try
+{
+    std::string writing;
+    std::unique_lock lock{ _writerLock };
+
+    while (true)
+    {
+        if (_writerPending.empty())
+        {
+            if (_writerExit)
+            {
+                return;
+            }
+            _writerWake.wait(lock);
+            continue;
+        }
+
+        if (!_writerUrgent && !_writerExit && _writerPending.size() < _writePolicy.batchBytes)
+        {
+            const auto deadline = _writerPendingSince + _writePolicy.batchLatency;
+            if (std::chrono::steady_clock::now() < deadline)
+            {
+                _writerWake.wait_until(lock, deadline);
+                continue;
+            }
+        }
+
+        writing.swap(_writerPending);
+        _writerPending.clear();
+        _writerUrgent = false;
+        lock.unlock();
+        _writerDrained.notify_all();
+
+        const auto hr = _WriteToPipe(writing);
+        writing.clear();
+
+        if (FAILED(hr))
+        {
+            _WriterFailed(hr);
+            return;
+        }
+        lock.lock();
+    }
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    _WriterFailed(wil::ResultFromCaughtException());
+}
+
+// Method Description:
+// - Called by the writer thread when it can't write any more output. Anyone waiting
+//      in _Flush is woken up and any further _Flush fails with the given error.
+//      Our owner is told right away, so that it doesn't have to wait for the next _Flush.
+// Arguments:
+// - hr: The reason why the writer thread is exiting.
+// Return Value:
+// - <none>
+void VtEngine::_WriterFailed(const HRESULT hr) noexcept
+{
+    try
+    {
+        const std::unique_lock lock{ _writerLock };
+        _writerError = hr;
+        _writerPending.clear();
+    }
+    CATCH_LOG();
+
+    _writerDrained.notify_all();
+
+    if (_pfnOutputFailed)
+    {
+        _pfnOutputFailed();
+    }
+}
+
+// Method Description:
+// - Returns the error the writer thread exited with, if any.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if the writer thread is fine or not running.
+HRESULT VtEngine::_GetWriterError() const noexcept
+try
+{
+    const std::shared_lock lock{ _writerLock };
+    return _writerError;
+}
+CATCH_RETURN();
+
+// Method Description:
+// - Waits for the writer thread to write all pending output and exit.
+//      Does nothing if async writes aren't enabled.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_StopWriter() noexcept
+{
+    if (!_writer.joinable())
+    {
+        return;
+    }
+
+    try
+    {
+        const std::unique_lock lock{ _writerLock };
+        _writerExit = true;
+    }
+    CATCH_LOG();
+
+    _writerWake.notify_one();
+    _writer.join();
+
+    _writerExit = false;
+    _writerUrgent = false;
+    _writerPending.clear();
+}
+
+// Method Description:
+// - Changes how our output is written to the pipe. Any pending output is
+//      written before the new policy takes effect.
+// Arguments:
+// - policy: The new policy. See WritePolicy.
+// Return Value:
+// - <none>
+void VtEngine::SetWritePolicy(const WritePolicy& policy)
+{
+    _StopWriter();
+    _writePolicy = policy;
+
+    if (_writePolicy.async && _hFile && SUCCEEDED(_writerError))
+    {
+        _writer = std::thread{ [this]() { _WriterThread(); } };
+    }
+}
+
+// Method Description:
+// - Returns the number of writes we made to the pipe, how large they were and
+//      how long they took.
+// Arguments:
+// - <none>
+// Return Value:
+// - The statistics since this engine was created.
+VtEngine::WriteStats VtEngine::GetWriteStats() const noexcept
+try
+{
+    const std::shared_lock lock{ _writerLock };
+    return _writeStats;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return {};
+}
+
 // Method Description:
 // - Wrapper for _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
 {
+    // We don't know what the string did to the terminal's contents.
+    _ResetShadow();
     return _Write(str);
 }
 
@@ -311,6 +572,12 @@ CATCH_RETURN();
     _suppressResizeRepaint = false;
     _lastViewport = newView;
 
+    // The terminal may have reflowed its contents.
+    if (oldSize != newSize)
+    {
+        _ResetShadow();
+    }
+
     return hr;
 }
 
@@ -409,9 +676,20 @@ bool VtEngine::_AllIsInvalid() const
     return S_OK;
 }
 
-void VtEngine::SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner)
+// Method Description:
+// - Sets the callbacks we use to let our owner know that we can't write to the
+//      terminal anymore. pfnCloseOutput is called once we've closed our end of
+//      the pipe. pfnOutputFailed is called from the writer thread as soon as it
+//      fails, so that the owner can get the render thread to notice it.
+// Arguments:
+// - pfnCloseOutput - called once the output was closed after a failed write.
+// - pfnOutputFailed - called by the writer thread when a write failed.
+// Return Value:
+// - <none>
+void VtEngine::SetTerminalOwnerCallbacks(std::function<void()> pfnCloseOutput, std::function<void()> pfnOutputFailed) noexcept
 {
-    _terminalOwner = terminalOwner;
+    _pfnCloseOutput = std::move(pfnCloseOutput);
+    _pfnOutputFailed = std::move(pfnOutputFailed);
 }
 
 // Method Description:
@@ -550,6 +828,7 @@ HRESULT VtEngine::RequestWin32Input() noexcept
 HRESULT VtEngine::SwitchScreenBuffer(const bool useAltBuffer) noexcept
 {
     RETURN_IF_FAILED(_SwitchScreenBuffer(useAltBuffer));
+    _ResetShadow();
     RETURN_IF_FAILED(_Flush());
     return S_OK;
 }
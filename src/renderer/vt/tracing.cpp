@@ -99,6 +99,21 @@ void RenderTracing::TraceString(const std::string_view& instr) const
 #endif UNIT_TESTING
 }
 
+void RenderTracing::TraceWrite(const size_t bytes, const std::chrono::nanoseconds latency) const
+{
+#ifndef UNIT_TESTING
+    TraceLoggingWrite(g_hConsoleVtRendererTraceProvider,
+                      "VtEngine_TraceWrite",
+                      TraceLoggingUInt64(gsl::narrow_cast<uint64_t>(bytes), "bytes"),
+                      TraceLoggingInt64(gsl::narrow_cast<int64_t>(latency.count()), "latencyNs"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+#else
+    UNREFERENCED_PARAMETER(bytes);
+    UNREFERENCED_PARAMETER(latency);
+#endif UNIT_TESTING
+}
+
 void RenderTracing::TraceInvalidate(const til::rect& invalidRect) const
 {
 #ifndef UNIT_TESTING
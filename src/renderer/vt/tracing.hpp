@@ -11,6 +11,7 @@ Abstract:
 
 #pragma once
 #include <string>
+#include <chrono>
 #include <windows.h>
 #include <winmeta.h>
 #include <TraceLoggingProvider.h>
@@ -28,6 +29,7 @@ namespace Microsoft::Console::VirtualTerminal
         ~RenderTracing();
         void TraceStringFill(const size_t n, const char c) const;
         void TraceString(const std::string_view& str) const;
+        void TraceWrite(const size_t bytes, const std::chrono::nanoseconds latency) const;
         void TraceInvalidate(const til::rect& view) const;
         void TraceLastText(const til::point lastText) const;
         void TraceScrollFrame(const til::point scrollDelta) const;
@@ -20,6 +20,8 @@ Author(s):
 #include "tracing.hpp"
 #include <string>
 #include <functional>
+#include <chrono>
+#include <condition_variable>
 
 // fwdecl unittest classes
 #ifdef UNIT_TESTING
@@ -30,11 +32,6 @@ namespace TerminalCoreUnitTests
 class ScreenBufferTests;
 #endif
 
-namespace Microsoft::Console::VirtualTerminal
-{
-    class VtIo;
-}
-
 namespace Microsoft::Console::Render
 {
     class VtEngine : public RenderEngineBase
@@ -44,8 +41,33 @@ namespace Microsoft::Console::Render
         static const size_t ERASE_CHARACTER_STRING_LENGTH = 8;
         static const til::point INVALID_COORDS;
 
+        // Controls how our output is written to the pipe. See SetWritePolicy.
+        struct WritePolicy
+        {
+            // Write from a background thread, so that painting doesn't wait for a slow reader.
+            bool async = false;
+            // With async writes, output flushed outside of a frame (like passed-through
+            // sequences) is held back until this many bytes or this much time have
+            // accumulated, or until the next frame ends, whichever comes first.
+            size_t batchBytes = 0;
+            std::chrono::milliseconds batchLatency{ 0 };
+            // With async writes, flushing blocks once this many bytes are waiting to be
+            // written, so that we don't buffer without bounds if the reader falls behind.
+            size_t maxPendingBytes = 1024 * 1024;
+        };
+
+        struct WriteStats
+        {
+            uint64_t writes = 0;
+            uint64_t bytes = 0;
+            uint64_t largestWrite = 0;
+            std::chrono::nanoseconds totalLatency{};
+            std::chrono::nanoseconds slowestWrite{};
+        };
+
         VtEngine(_In_ wil::unique_hfile hPipe,
                  const Microsoft::Console::Types::Viewport initialViewport);
+        ~VtEngine() override;
 
         // IRenderEngine
         [[nodiscard]] HRESULT StartPaint() noexcept override;
@@ -79,7 +101,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InheritCursor(const til::point coordCursor) noexcept;
         [[nodiscard]] HRESULT WriteTerminalUtf8(const std::string_view str) noexcept;
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str) noexcept = 0;
-        void SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner);
+        [[nodiscard]] virtual HRESULT AppendTerminalW(const std::wstring_view str) noexcept = 0;
+        void SetTerminalOwnerCallbacks(std::function<void()> pfnCloseOutput, std::function<void()> pfnOutputFailed) noexcept;
         void BeginResizeRequest();
         void EndResizeRequest();
         void SetResizeQuirk(const bool resizeQuirk);
@@ -88,6 +111,8 @@ namespace Microsoft::Console::Render
         void SetTerminalCursorTextPosition(const til::point coordCursor) noexcept;
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
         [[nodiscard]] HRESULT RequestWin32Input() noexcept;
+        void SetWritePolicy(const WritePolicy& policy);
+        WriteStats GetWriteStats() const noexcept;
         [[nodiscard]] virtual HRESULT SetWindowVisibility(const bool showOrHide) noexcept = 0;
         [[nodiscard]] HRESULT SwitchScreenBuffer(const bool useAltBuffer) noexcept;
 
@@ -128,7 +153,9 @@ namespace Microsoft::Console::Render
         til::point _deferredCursorPos;
 
         HRESULT _exitResult;
-        Microsoft::Console::VirtualTerminal::VtIo* _terminalOwner;
+        // _pfnOutputFailed is called from the writer thread and must not take the console lock.
+        std::function<void()> _pfnCloseOutput;
+        std::function<void()> _pfnOutputFailed;
 
         Microsoft::Console::VirtualTerminal::RenderTracing _trace;
         bool _inResizeRequest{ false };
@@ -141,9 +168,44 @@ namespace Microsoft::Console::Render
         bool _passthrough{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // What we believe the terminal's viewport currently shows, cell by cell.
+        // It lets us skip the parts of a repainted line that the terminal already displays.
+        struct ShadowCell
+        {
+            TextAttribute attributes;
+            std::array<wchar_t, 2> text{};
+            // 0 if we don't know what's in this cell, because we never painted
+            // it or it's the trailing half of a wide glyph.
+            uint8_t length = 0;
+            uint8_t columns = 0;
+        };
+        std::vector<ShadowCell> _shadowFrame;
+        til::size _shadowSize;
+
+        // Output handed over by _Flush, waiting for _WriterThread to write it.
+        // All of these are protected by _writerLock.
+        mutable std::shared_mutex _writerLock;
+        std::condition_variable_any _writerWake;
+        std::condition_variable_any _writerDrained;
+        std::string _writerPending;
+        std::chrono::steady_clock::time_point _writerPendingSince;
+        HRESULT _writerError{ S_OK };
+        bool _writerUrgent{ false };
+        bool _writerExit{ false };
+        WriteStats _writeStats;
+
+        WritePolicy _writePolicy;
+        std::thread _writer;
+
         [[nodiscard]] HRESULT _WriteFill(const size_t n, const char c) noexcept;
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
-        [[nodiscard]] HRESULT _Flush() noexcept;
+        [[nodiscard]] HRESULT _Flush(const bool urgent = true) noexcept;
+        [[nodiscard]] HRESULT _WriteToPipe(const std::string_view data) noexcept;
+        [[nodiscard]] HRESULT _WriteFailed(const HRESULT hr) noexcept;
+        HRESULT _GetWriterError() const noexcept;
+        void _WriterThread() noexcept;
+        void _WriterFailed(const HRESULT hr) noexcept;
+        void _StopWriter() noexcept;
 
         template<typename S, typename... Args>
         [[nodiscard]] HRESULT _WriteFormatted(S&& format, Args&&... args)
@@ -223,6 +285,14 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _PaintAsciiBufferLine(const gsl::span<const Cluster> clusters,
                                                     const til::point coord) noexcept;
 
+        [[nodiscard]] HRESULT _PaintChangedUtf8BufferLine(const gsl::span<const Cluster> clusters,
+                                                          const til::point coord) noexcept;
+        bool _CanPaintChangedOnly(const til::point coord, const bool lineWrapped) const noexcept;
+        bool _IsShadowed(const Cluster& cluster, const til::point coord) const noexcept;
+        void _RecordShadow(const gsl::span<const Cluster> clusters, const til::point coord, const til::CoordType knownColumns) noexcept;
+        void _ScrollShadow(const til::CoordType dy) noexcept;
+        void _ResetShadow() noexcept;
+
         [[nodiscard]] HRESULT _WriteTerminalUtf8(const std::wstring_view str) noexcept;
         [[nodiscard]] HRESULT _WriteTerminalAscii(const std::wstring_view str) noexcept;
         [[nodiscard]] HRESULT _WriteTerminalDrcs(const std::wstring_view str) noexcept;
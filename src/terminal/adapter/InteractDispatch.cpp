@@ -40,6 +40,13 @@ InteractDispatch::InteractDispatch() :
 // - True.
 bool InteractDispatch::WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
 {
+    if (_batchingInput)
+    {
+        std::move(inputEvents.begin(), inputEvents.end(), std::back_inserter(_pendingInput));
+        inputEvents.clear();
+        return true;
+    }
+
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     gci.GetActiveInputBuffer()->Write(inputEvents);
     return true;
@@ -56,6 +63,9 @@ bool InteractDispatch::WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inpu
 // - True.
 bool InteractDispatch::WriteCtrlKey(const KeyEvent& event)
 {
+    // Ctrl+Break flushes the input buffer, so anything written
+    // before it must have arrived there before we handle it.
+    _FlushPendingInput();
     HandleGenericKeyEvent(event, false);
     return true;
 }
@@ -240,9 +250,60 @@ bool InteractDispatch::FocusChanged(const bool focused) const
 
         WI_UpdateFlag(gci.Flags, CONSOLE_HAS_FOCUS, shouldActuallyFocus);
         gci.ProcessHandleList.ModifyConsoleProcessFocus(shouldActuallyFocus);
+        _FlushPendingInput();
         gci.pInputBuffer->Write(std::make_unique<FocusEvent>(focused));
     }
     // Does nothing outside of ConPTY. If there's a real HWND, then the HWND is solely in charge.
 
     return true;
 }
+
+// Method Description:
+// - Starts collecting the input written via WriteInput() and WriteString(),
+//   instead of writing it to the input buffer right away. A large paste results
+//   in a lot of small writes, each of which would otherwise have to notify the
+//   input buffer's waiting readers. See EndInputBatch().
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InteractDispatch::BeginInputBatch() noexcept
+{
+    _batchingInput = true;
+}
+
+// Method Description:
+// - Writes all input collected since BeginInputBatch() to the input buffer at once.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InteractDispatch::EndInputBatch() noexcept
+try
+{
+    _batchingInput = false;
+    _FlushPendingInput();
+}
+CATCH_LOG()
+
+// Method Description:
+// - Writes the input collected during the current batch to the input buffer,
+//   so that any input written after this call is ordered correctly after it.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void InteractDispatch::_FlushPendingInput() const
+{
+    if (_pendingInput.empty())
+    {
+        return;
+    }
+
+    // Take the events out first, so that we start over with an empty batch, even if writing them throws.
+    auto inputEvents = std::move(_pendingInput);
+    _pendingInput.clear();
+
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.GetActiveInputBuffer()->Write(inputEvents);
+}
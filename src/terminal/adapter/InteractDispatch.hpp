@@ -37,7 +37,18 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool FocusChanged(const bool focused) const override;
 
+        void BeginInputBatch() noexcept;
+        void EndInputBatch() noexcept;
+
     private:
+        void _FlushPendingInput() const;
+
         ConhostInternalGetSet _api;
+
+        // While an input batch is open, WriteInput() collects events in here instead
+        // of writing them to the input buffer. It's mutable, because FocusChanged()
+        // is const and needs to flush it before writing its own event.
+        mutable std::deque<std::unique_ptr<IInputEvent>> _pendingInput;
+        bool _batchingInput = false;
     };
 }
@@ -2419,12 +2419,13 @@ void AdaptDispatch::_EraseScrollback()
     auto& cursor = textBuffer.GetCursor();
     const auto row = cursor.GetPosition().Y;
 
-    // Scroll the viewport content to the top of the buffer.
-    textBuffer.ScrollRows(top, height, -top);
-    // Clear everything after the viewport.
-    _FillRect(textBuffer, { 0, height, bufferSize.X, bufferSize.Y }, L' ', {});
-    // Also reset the line rendition for all of the cleared rows.
-    textBuffer.ResetLineRenditionRange(height, bufferSize.Y);
+    // Move the viewport content to the top of the buffer and discard everything else.
+    // This also resets the line rendition of the cleared rows and releases their memory.
+    textBuffer.ClearScrollback(top, height, {});
+    if (height < bufferSize.Y)
+    {
+        _api.NotifyAccessibilityChange({ 0, height, bufferSize.X, bufferSize.Y });
+    }
     // Move the viewport
     _api.SetViewportPosition({ viewport.left, 0 });
     // Move the cursor to the same relative location.
@@ -3102,18 +3103,21 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
     // set translation is correctly handled on the host side.
     const auto conptyPassthrough = _api.IsConsolePty() ? _CreateDrcsPassthroughHandler(charsetSize) : nullptr;
 
-    return [=](const auto ch) {
+    return [=](const std::wstring_view string) {
         if (conptyPassthrough)
         {
-            conptyPassthrough(ch);
+            conptyPassthrough(string);
         }
         // We pass the data string straight through to the font buffer class
         // until we receive an ESC, indicating the end of the string. At that
         // point we can finalize the buffer, and if valid, update the renderer
         // with the constructed bit pattern.
-        if (ch != AsciiChars::ESC)
+        if (string.front() != AsciiChars::ESC)
         {
-            _fontBuffer->AddSixelData(ch);
+            for (const auto ch : string)
+            {
+                _fontBuffer->AddSixelData(ch);
+            }
         }
         else if (_fontBuffer->FinalizeSixelData())
         {
@@ -3151,25 +3155,33 @@ ITermDispatch::StringHandler AdaptDispatch::_CreateDrcsPassthroughHandler(const
     if (defaultPassthrough)
     {
         auto& engine = _api.GetStateMachine().Engine();
-        return [=, &engine, gotId = false](const auto ch) mutable {
+        return [=, &engine, gotId = false](std::wstring_view string) mutable {
             // The character set ID is contained in the first characters of the
             // sequence, so we just ignore that initial content until we receive
             // a "final" character (i.e. in range 30 to 7E). At that point we
             // pass through a hardcoded ID of "@".
             if (!gotId)
             {
-                if (ch >= 0x30 && ch <= 0x7E)
+                const auto it = std::find_if(string.begin(), string.end(), [](const auto ch) { return ch >= 0x30 && ch <= 0x7E; });
+                if (it == string.end())
                 {
-                    gotId = true;
-                    defaultPassthrough('@');
+                    return true;
+                }
+                gotId = true;
+                defaultPassthrough(L"@");
+                // Whatever follows the ID is passed through as usual.
+                string = string.substr(gsl::narrow_cast<size_t>(it - string.begin()) + 1);
+                if (string.empty())
+                {
+                    return true;
                 }
             }
-            else if (!defaultPassthrough(ch))
+            if (!defaultPassthrough(string))
             {
                 // Once the DECDLD sequence is finished, we also output an SCS
                 // sequence to map the character set into the G1 table.
                 const auto charset96 = charsetSize == DispatchTypes::DrcsCharsetSize::Size96;
-                engine.ActionPassThroughString(charset96 ? L"\033-@" : L"\033)@");
+                engine.ActionPassThroughString(charset96 ? L"\033-@" : L"\033)@", true);
             }
             return true;
         };
@@ -3215,45 +3227,48 @@ ITermDispatch::StringHandler AdaptDispatch::_RestoreColorTable()
         return _CreatePassthroughHandler();
     }
 
-    return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const auto ch) mutable {
-        if (ch >= L'0' && ch <= L'9')
-        {
-            parameter *= 10;
-            parameter += (ch - L'0');
-            parameter = std::min(parameter, MAX_PARAMETER_VALUE);
-        }
-        else if (ch == L';')
+    return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const std::wstring_view string) mutable {
+        for (const auto ch : string)
         {
-            if (parameters.size() < 5)
+            if (ch >= L'0' && ch <= L'9')
             {
-                parameters.push_back(parameter);
+                parameter *= 10;
+                parameter += (ch - L'0');
+                parameter = std::min(parameter, MAX_PARAMETER_VALUE);
             }
-            parameter = 0;
-        }
-        else if (ch == L'/' || ch == AsciiChars::ESC)
-        {
-            parameters.push_back(parameter);
-            const auto colorParameters = VTParameters{ parameters.data(), parameters.size() };
-            const auto colorNumber = colorParameters.at(0).value_or(0);
-            if (colorNumber < TextColor::TABLE_SIZE)
+            else if (ch == L';')
             {
-                const auto colorModel = DispatchTypes::ColorModel{ colorParameters.at(1) };
-                const auto x = colorParameters.at(2).value_or(0);
-                const auto y = colorParameters.at(3).value_or(0);
-                const auto z = colorParameters.at(4).value_or(0);
-                if (colorModel == DispatchTypes::ColorModel::HLS)
+                if (parameters.size() < 5)
                 {
-                    SetColorTableEntry(colorNumber, Utils::ColorFromHLS(x, y, z));
+                    parameters.push_back(parameter);
                 }
-                else if (colorModel == DispatchTypes::ColorModel::RGB)
+                parameter = 0;
+            }
+            else if (ch == L'/' || ch == AsciiChars::ESC)
+            {
+                parameters.push_back(parameter);
+                const auto colorParameters = VTParameters{ parameters.data(), parameters.size() };
+                const auto colorNumber = colorParameters.at(0).value_or(0);
+                if (colorNumber < TextColor::TABLE_SIZE)
                 {
-                    SetColorTableEntry(colorNumber, Utils::ColorFromRGB100(x, y, z));
+                    const auto colorModel = DispatchTypes::ColorModel{ colorParameters.at(1) };
+                    const auto x = colorParameters.at(2).value_or(0);
+                    const auto y = colorParameters.at(3).value_or(0);
+                    const auto z = colorParameters.at(4).value_or(0);
+                    if (colorModel == DispatchTypes::ColorModel::HLS)
+                    {
+                        SetColorTableEntry(colorNumber, Utils::ColorFromHLS(x, y, z));
+                    }
+                    else if (colorModel == DispatchTypes::ColorModel::RGB)
+                    {
+                        SetColorTableEntry(colorNumber, Utils::ColorFromRGB100(x, y, z));
+                    }
                 }
+                parameters.clear();
+                parameter = 0;
             }
-            parameters.clear();
-            parameter = 0;
         }
-        return (ch != AsciiChars::ESC);
+        return string.front() != AsciiChars::ESC;
     };
 }
 
@@ -3274,38 +3289,38 @@ ITermDispatch::StringHandler AdaptDispatch::RequestSetting()
     // say that 0 is for a valid response, and 1 is for an error. The correct
     // interpretation is documented in the DEC STD 070 reference.
     const auto idBuilder = std::make_shared<VTIDBuilder>();
-    return [=](const auto ch) {
-        if (ch >= '\x40' && ch <= '\x7e')
+    return [=](const std::wstring_view string) {
+        for (const auto ch : string)
         {
-            const auto id = idBuilder->Finalize(ch);
-            switch (id)
+            if (ch >= '\x40' && ch <= '\x7e')
             {
-            case VTID("m"):
-                _ReportSGRSetting();
-                break;
-            case VTID("r"):
-                _ReportDECSTBMSetting();
-                break;
-            case VTID("\"q"):
-                _ReportDECSCASetting();
-                break;
-            case VTID("*x"):
-                _ReportDECSACESetting();
-                break;
-            default:
-                _api.ReturnResponse(L"\033P0$r\033\\");
-                break;
+                const auto id = idBuilder->Finalize(ch);
+                switch (id)
+                {
+                case VTID("m"):
+                    _ReportSGRSetting();
+                    break;
+                case VTID("r"):
+                    _ReportDECSTBMSetting();
+                    break;
+                case VTID("\"q"):
+                    _ReportDECSCASetting();
+                    break;
+                case VTID("*x"):
+                    _ReportDECSACESetting();
+                    break;
+                default:
+                    _api.ReturnResponse(L"\033P0$r\033\\");
+                    break;
+                }
+                return false;
             }
-            return false;
-        }
-        else
-        {
-            if (ch >= '\x20' && ch <= '\x2f')
+            else if (ch >= '\x20' && ch <= '\x2f')
             {
                 idBuilder->AddIntermediate(ch);
             }
-            return true;
         }
+        return true;
     };
 }
 
@@ -3498,24 +3513,15 @@ ITermDispatch::StringHandler AdaptDispatch::_CreatePassthroughHandler()
         // And finally we create a StringHandler to receive the rest of the
         // sequence data, and pass it through to the connected terminal.
         auto& engine = stateMachine.Engine();
-        return [&, buffer = std::wstring{}](const auto ch) mutable {
-            // To make things more efficient, we buffer the string data before
-            // passing it through, only flushing if the buffer gets too large,
-            // or we're dealing with the last character in the current output
-            // fragment, or we've reached the end of the string.
-            const auto endOfString = ch == AsciiChars::ESC;
-            buffer += ch;
-            if (buffer.length() >= 4096 || stateMachine.IsProcessingLastCharacter() || endOfString)
-            {
-                // The end of the string is signaled with an escape, but for it
-                // to be a valid string terminator we need to add a backslash.
-                if (endOfString)
-                {
-                    buffer += L'\\';
-                }
-                engine.ActionPassThroughString(buffer);
-                buffer.clear();
-            }
+        return [&](const std::wstring_view string) {
+            // The state machine hands us the data string in chunks, which get
+            // split at any ignored control characters. We only append them to
+            // the pending output, and the state machine flushes it once it's
+            // done with the current output fragment. The end of the string is
+            // signaled with an escape, but for it to be a valid string
+            // terminator we need to add a backslash.
+            const auto endOfString = string.front() == AsciiChars::ESC;
+            engine.ActionPassThroughString(endOfString ? std::wstring_view{ L"\033\\" } : string, endOfString);
             return !endOfString;
         };
     }
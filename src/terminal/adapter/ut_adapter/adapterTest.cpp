@@ -1542,11 +1542,11 @@ public:
     {
         const auto requestSetting = [=](const std::wstring_view settingId = {}) {
             const auto stringHandler = _pDispatch->RequestSetting();
-            for (auto ch : settingId)
+            if (!settingId.empty())
             {
-                stringHandler(ch);
+                stringHandler(settingId);
             }
-            stringHandler(L'\033'); // String terminator
+            stringHandler(L"\033"); // String terminator
         };
 
         Log::Comment(L"Requesting DECSTBM margins (5 to 10).");
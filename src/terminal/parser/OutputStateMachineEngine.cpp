@@ -160,14 +160,17 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 //      we don't know what to do with it)
 // Arguments:
 // - string - string to dispatch.
+// - flush - false to only append the string to the connection's pending output.
+//      DCS data strings are passed through that way, one chunk at a time, and get
+//      flushed once the string ends or the current output fragment is processed.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
-bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view string)
+bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view string, const bool flush)
 {
     auto success = true;
     if (_pTtyConnection != nullptr)
     {
-        const auto hr = _pTtyConnection->WriteTerminalW(string);
+        const auto hr = flush ? _pTtyConnection->WriteTerminalW(string) : _pTtyConnection->AppendTerminalW(string);
         LOG_IF_FAILED(hr);
         success = SUCCEEDED(hr);
     }
@@ -5,6 +5,8 @@
 
 #include "stateMachine.hpp"
 
+#include <bit>
+
 #include "ascii.hpp"
 
 using namespace Microsoft::Console::VirtualTerminal;
@@ -379,6 +381,129 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 
 #pragma warning(pop)
 
+// Routine Description:
+// - Finds the next character in the given string for which _isActionableFromGround() is true.
+//   Plain text output consists almost exclusively of printable characters, which is why
+//   this function is vectorized to check 8 (SSE2, NEON) or 16 (AVX2) characters at a time.
+// Arguments:
+// - string - The string to search.
+// - offset - The index at which to start searching.
+// Return Value:
+// - The index of the next actionable character, or string.size() if there is none.
+static size_t _findActionableFromGround(const std::wstring_view string, const size_t offset) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    static_assert(sizeof(wchar_t) == sizeof(uint16_t), "The vectorized code broke. If you can't fix wchar_t, just remove the vectorized code.");
+
+    const auto beg = string.data();
+    const auto end = beg + string.size();
+    auto it = beg + std::min(offset, string.size());
+
+    // _isActionableFromGround() is true for C0 [0x00,0x1F], DEL (0x7F) and C1 [0x80,0x9F].
+    // The latter two form the contiguous range [0x7F,0x9F] and so we only need to check 2 ranges.
+    // A range check "lo <= x && x <= hi" can be turned into a single unsigned comparison "x - lo <= hi - lo",
+    // where the subtraction is allowed to wrap around. The vectorized code below uses this fact:
+    // 1. Load 8 or 16 characters at once
+    // 2. Check both ranges for all of them at once and OR the results together.
+    //    The result is either 0xffff or 0x0000 for each character.
+    //    SSE2 and AVX2 lack unsigned 16-bit comparisons, but "x <= hi" is equivalent to the
+    //    saturating subtraction "x - hi" being 0, which is what we use instead.
+    // 3. Extract a bitmask out of the comparison results
+    // 4. Use countr_zero to find the index of the first actionable character
+#if defined(__AVX2__)
+    const auto c0Limit = _mm256_set1_epi16(AsciiChars::US);
+    const auto c1Base = _mm256_set1_epi16(AsciiChars::DEL);
+    const auto c1Limit = _mm256_set1_epi16(L'\x9F' - AsciiChars::DEL);
+    const auto zero = _mm256_setzero_si256();
+
+    for (; end - it >= 16; it += 16)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)); // 1.
+        const auto c0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(chars, c0Limit), zero); // 2.
+        const auto c1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(chars, c1Base), c1Limit), zero);
+        // _mm256_movemask_epi8 returns 2 bits per 16-bit character. --> Divide the index by 2.
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(c0, c1))); // 3.
+        if (mask)
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + std::countr_zero(mask) / 2; // 4.
+        }
+    }
+#elif defined(_M_AMD64)
+    // This SSE2 variant is identical to the AVX2 one, but only processes 8 characters at a time.
+    const auto c0Limit = _mm_set1_epi16(AsciiChars::US);
+    const auto c1Base = _mm_set1_epi16(AsciiChars::DEL);
+    const auto c1Limit = _mm_set1_epi16(L'\x9F' - AsciiChars::DEL);
+    const auto zero = _mm_setzero_si128();
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it)); // 1.
+        const auto c0 = _mm_cmpeq_epi16(_mm_subs_epu16(chars, c0Limit), zero); // 2.
+        const auto c1 = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, c1Base), c1Limit), zero);
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(c0, c1))); // 3.
+        if (mask)
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + std::countr_zero(mask) / 2; // 4.
+        }
+    }
+#elif defined(_M_ARM64)
+    // NEON has unsigned comparisons, so we can use them directly. But it lacks a movemask
+    // equivalent. Instead we narrow the 16-bit results to 8 bits (vmovn), which results in
+    // exactly 64 bits that we can extract into an integer with 8 bits per character.
+    const auto c0Limit = vdupq_n_u16(AsciiChars::US);
+    const auto c1Base = vdupq_n_u16(AsciiChars::DEL);
+    const auto c1Limit = vdupq_n_u16(L'\x9F' - AsciiChars::DEL);
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = vld1q_u16(reinterpret_cast<const uint16_t*>(it)); // 1.
+        const auto c0 = vcleq_u16(chars, c0Limit); // 2.
+        const auto c1 = vcleq_u16(vsubq_u16(chars, c1Base), c1Limit);
+        const auto mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(vorrq_u16(c0, c1))), 0); // 3.
+        if (mask)
+        {
+            return gsl::narrow_cast<size_t>(it - beg) + std::countr_zero(mask) / 8; // 4.
+        }
+    }
+#endif
+
+    // Scalar fallback for the remaining characters (or all of them on other architectures).
+    for (; it != end; ++it)
+    {
+        if (_isActionableFromGround(*it))
+        {
+            break;
+        }
+    }
+
+    return gsl::narrow_cast<size_t>(it - beg);
+#pragma warning(pop)
+}
+
+// Routine Description:
+// - Finds the end of the run of characters that _EventDcsPassThrough() would pass to the
+//   DCS string handler unchanged. These are the C0 controls, except for CAN, SUB and ESC
+//   which terminate the string, and the characters in the range [0x20,0x7E].
+// Arguments:
+// - string - The string to search.
+// - offset - The index at which to start searching.
+// Return Value:
+// - The index of the first character that doesn't belong to the run, or string.size() if there is none.
+static size_t _findEndOfDcsPassThrough(const std::wstring_view string, size_t offset) noexcept
+{
+    for (; offset < string.size(); ++offset)
+    {
+        const auto wch = til::at(string, offset);
+        if (!_isC0Code(wch) && !_isDcsPassThroughValid(wch))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should immediately respond to a C0 control character.
 // Arguments:
@@ -594,7 +719,8 @@ void StateMachine::_ActionInterrupt()
     if (_state == VTStates::DcsPassThrough)
     {
         // The ESC signals the end of the data string.
-        _dcsStringHandler(AsciiChars::ESC);
+        static constexpr wchar_t esc = AsciiChars::ESC;
+        _dcsStringHandler({ &esc, 1 });
         _dcsStringHandler = nullptr;
     }
 }
@@ -613,16 +739,16 @@ void StateMachine::_ActionOscParam(const wchar_t wch) noexcept
 }
 
 // Routine Description:
-// - Stores this character as part of the OSC string
+// - Stores these characters as part of the OSC string
 // Arguments:
-// - wch - Character to dispatch.
+// - string - Characters to dispatch.
 // Return Value:
 // - <none>
-void StateMachine::_ActionOscPut(const wchar_t wch)
+void StateMachine::_ActionOscPut(const std::wstring_view string)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    _oscString.append(string);
 }
 
 // Routine Description:
@@ -687,6 +813,23 @@ void StateMachine::_ActionDcsDispatch(const wchar_t wch)
     }
 }
 
+// Routine Description:
+// - Passes a chunk of the DCS data string to the handler returned by the DcsDispatch action.
+//   If the handler doesn't want any more data, the remainder of the string will be ignored.
+// Arguments:
+// - string - Characters to dispatch.
+// Return Value:
+// - <none>
+void StateMachine::_ActionDcsPassThrough(const std::wstring_view string)
+{
+    _trace.TraceOnAction(L"DcsPassThrough");
+
+    if (!_dcsStringHandler(string))
+    {
+        _EnterDcsIgnore();
+    }
+}
+
 // Routine Description:
 // - Moves the state machine into the Ground state.
 //   This state is entered:
@@ -1359,7 +1502,7 @@ void StateMachine::_EventOscString(const wchar_t wch)
     else
     {
         // add this character to our OSC string
-        _ActionOscPut(wch);
+        _ActionOscPut({ &wch, 1 });
     }
 }
 
@@ -1660,10 +1803,7 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     _trace.TraceOnEvent(L"DcsPassThrough");
     if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
     {
-        if (!_dcsStringHandler(wch))
-        {
-            _EnterDcsIgnore();
-        }
+        _ActionDcsPassThrough({ &wch, 1 });
     }
     else
     {
@@ -1685,6 +1825,46 @@ void StateMachine::_EventSosPmApcString(const wchar_t /*wch*/) noexcept
     _ActionIgnore();
 }
 
+// Routine Description:
+// - DCS and OSC data strings (for instance soft fonts or clipboard contents) can be very long.
+//   Instead of feeding them through ProcessCharacter() one at a time, this finds the run of
+//   characters at the given offset that wouldn't change the current state and passes them on
+//   in one go. The characters that end the run are left for ProcessCharacter() to handle.
+// Arguments:
+// - string - The string being processed.
+// - offset - The index of the next character to be processed.
+// Return Value:
+// - The index of the first character that hasn't been processed yet. This is
+//   equal to offset if we aren't in a data string state or there is no run.
+size_t StateMachine::_ProcessDataString(const std::wstring_view string, const size_t offset)
+{
+    size_t end = offset;
+
+    if (_state == VTStates::DcsPassThrough)
+    {
+        end = _findEndOfDcsPassThrough(string, offset);
+        if (end > offset)
+        {
+            _trace.TraceOnEvent(L"DcsPassThrough");
+            _ActionDcsPassThrough(string.substr(offset, end - offset));
+        }
+    }
+    else if (_state == VTStates::OscString)
+    {
+        // The characters that end a run of OSC string data are the same as those that end a
+        // run of printable text in the ground state, except for DEL, which is collected.
+        // That's rare enough that we can leave it to ProcessCharacter().
+        end = _findActionableFromGround(string, offset);
+        if (end > offset)
+        {
+            _trace.TraceOnEvent(L"OscString");
+            _ActionOscPut(string.substr(offset, end - offset));
+        }
+    }
+
+    return end;
+}
+
 // Routine Description:
 // - Entry to the state machine. Takes characters one by one and processes them according to the state machine rules.
 // Arguments:
@@ -1799,7 +1979,7 @@ bool StateMachine::FlushToTerminal()
         // We always want to clear the sequence, even if we failed, so we don't accumulate bad state
         // and dump it out elsewhere later.
         success = _SafeExecute([=]() {
-            return _engine->ActionPassThroughString(*_cachedSequence);
+            return _engine->ActionPassThroughString(*_cachedSequence, true);
         });
         _cachedSequence.reset();
     }
@@ -1811,7 +1991,7 @@ bool StateMachine::FlushToTerminal()
         // However, if we're here, then the processing of pwchChar triggered the
         //      engine to request the entire sequence get passed through, including pwchCurr.
         success = _SafeExecute([=]() {
-            return _engine->ActionPassThroughString(_CurrentRun());
+            return _engine->ActionPassThroughString(_CurrentRun(), true);
         });
     }
 
@@ -1846,8 +2026,13 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         if (_processingIndividually)
         {
-            // Note whether we're dealing with the last character in the buffer.
-            _processingLastCharacter = (current + 1 >= string.size());
+            // Data strings are passed on in bulk, up to the next character that might end them.
+            if (const auto end = _ProcessDataString(string, current); end > current)
+            {
+                current = end;
+                continue;
+            }
+
             // If we're processing characters individually, send it to the state machine.
             ProcessCharacter(til::at(string, current));
             ++current;
@@ -1859,24 +2044,21 @@ void StateMachine::ProcessString(const std::wstring_view string)
         }
         else
         {
-            if (_isActionableFromGround(til::at(string, current))) // If the current char is the start of an escape sequence, or should be executed in ground state...
+            // Find the next character that is the start of an escape sequence or should be executed in ground state.
+            // Everything leading up to it is a printable run and can be printed all at once.
+            current = _findActionableFromGround(string, current);
+
+            if (current < string.size())
             {
-                if (_runSize > 0)
+                if (current > start)
                 {
-                    // Because the run above is composed INCLUDING current, we must
-                    // trim it off here since we just determined it's actionable
-                    // and only pass through everything before it.
-                    _runSize -= 1;
-                    _ActionPrintString(_CurrentRun()); // ... print all the chars leading up to it as part of the run...
+                    // The actionable character itself isn't part of the run, so we only pass through everything before it.
+                    _runSize = current - start;
+                    _ActionPrintString(_CurrentRun());
                 }
 
                 _processingIndividually = true; // begin processing future characters individually...
                 start = current;
-                continue;
-            }
-            else
-            {
-                ++current; // Otherwise, add this char to the current run to be printed.
             }
         }
     }
@@ -1926,7 +2108,6 @@ void StateMachine::ProcessString(const std::wstring_view string)
         {
             // Reset our state, and put all but the last char in again.
             ResetState();
-            _processingLastCharacter = false;
             // Chars to flush are [pwchSequenceStart, pwchCurr)
             auto wchIter = run.cbegin();
             while (wchIter < run.cend() - 1)
@@ -1935,7 +2116,6 @@ void StateMachine::ProcessString(const std::wstring_view string)
                 wchIter++;
             }
             // Manually execute the last char [pwchCurr]
-            _processingLastCharacter = true;
             switch (_state)
             {
             case VTStates::Ground:
@@ -1981,19 +2161,15 @@ void StateMachine::ProcessString(const std::wstring_view string)
             cachedSequence.append(run);
         }
     }
-}
 
-// Routine Description:
-// - Determines whether the character being processed is the last in the
-//   current output fragment, or there are more still to come. Other parts
-//   of the framework can use this information to work more efficiently.
-// Arguments:
-// - <none>
-// Return Value:
-// - True if we're processing the last character. False if not.
-bool StateMachine::IsProcessingLastCharacter() const noexcept
-{
-    return _processingLastCharacter;
+    // DCS data strings are passed through without flushing each chunk. If the
+    // string continues in the next output fragment, flush what we've got so far.
+    if (_state == VTStates::DcsPassThrough)
+    {
+        _SafeExecute([=]() {
+            return _engine->ActionPassThroughString({}, true);
+        });
+    }
 }
 
 // Routine Description:
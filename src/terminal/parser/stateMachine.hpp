@@ -59,7 +59,6 @@ namespace Microsoft::Console::VirtualTerminal
 
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
-        bool IsProcessingLastCharacter() const noexcept;
 
         void ResetState() noexcept;
 
@@ -86,10 +85,11 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionParam(const wchar_t wch);
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
-        void _ActionOscPut(const wchar_t wch);
+        void _ActionOscPut(const std::wstring_view string);
         void _ActionOscDispatch(const wchar_t wch);
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsDispatch(const wchar_t wch);
+        void _ActionDcsPassThrough(const std::wstring_view string);
 
         void _ActionClear();
         void _ActionIgnore() noexcept;
@@ -135,6 +135,8 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventDcsPassThrough(const wchar_t wch);
         void _EventSosPmApcString(const wchar_t wch) noexcept;
 
+        size_t _ProcessDataString(const std::wstring_view string, const size_t offset);
+
         void _AccumulateTo(const wchar_t wch, VTInt& value) noexcept;
 
         template<typename TLambda>
@@ -191,6 +193,8 @@ namespace Microsoft::Console::VirtualTerminal
         std::vector<VTParameter> _parameters;
         bool _parameterLimitReached;
 
+        // Accumulates the OSC data string. It's cleared but not freed between sequences,
+        // so that frequent OSC sequences don't need to allocate each time.
         std::wstring _oscString;
         VTInt _oscParameter;
 
@@ -201,6 +205,5 @@ namespace Microsoft::Console::VirtualTerminal
         // This is tracked per state machine instance so that separate calls to Process*
         //   can start and finish a sequence.
         bool _processingIndividually;
-        bool _processingLastCharacter;
     };
 }
@@ -32,12 +32,15 @@ public:
     {
         printed.clear();
         passedThrough.clear();
+        passThroughFlushes = 0;
         executed.clear();
         csiId = 0;
         csiParams.clear();
         dcsId = 0;
         dcsParams.clear();
         dcsDataString.clear();
+        dcsDataChunks = 0;
+        oscString.clear();
     }
 
     bool ActionExecute(const wchar_t wch) override
@@ -54,9 +57,13 @@ public:
         return true;
     };
 
-    bool ActionPassThroughString(const std::wstring_view string) override
+    bool ActionPassThroughString(const std::wstring_view string, const bool flush) override
     {
         passedThrough += string;
+        if (flush)
+        {
+            passThroughFlushes++;
+        }
         return true;
     };
 
@@ -70,8 +77,9 @@ public:
 
     bool ActionOscDispatch(const wchar_t /* wch */,
                            const size_t /* parameter */,
-                           const std::wstring_view /* string */) override
+                           const std::wstring_view string) override
     {
+        oscString = string;
         if (pfnFlushToTerminal)
         {
             pfnFlushToTerminal();
@@ -110,7 +118,12 @@ public:
             dcsParams.push_back(parameters.at(i).value_or(0));
         }
         dcsDataString.clear();
-        return [=](const auto ch) { dcsDataString += ch; return true; };
+        dcsDataChunks = 0;
+        return [=](const auto string) {
+            dcsDataString += string;
+            dcsDataChunks++;
+            return true;
+        };
     }
 
     // These will only be populated if ActionCsiDispatch is called.
@@ -122,6 +135,7 @@ public:
 
     // Passed through string.
     std::wstring passedThrough;
+    size_t passThroughFlushes = 0;
 
     // Printed string.
     std::wstring printed;
@@ -133,6 +147,10 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+    size_t dcsDataChunks = 0;
+
+    // This will only be populated if ActionOscDispatch is called.
+    std::wstring oscString;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -154,9 +172,12 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(BulkTextPrintStopsAtActionableCharacters);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+    TEST_METHOD(DataStringsProcessedInBulk);
+    TEST_METHOD(DcsPassThroughFlushedOncePerWrite);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachOther()
@@ -229,6 +250,66 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::BulkTextPrintStopsAtActionableCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The search for the end of a printable run processes 8 or 16 characters at a time.
+    // Place the character we're testing at every position relative to those chunks.
+    static constexpr size_t length = 40;
+
+    Log::Comment(L"C0 and DEL are executed and end the printable run.");
+    for (const auto ch : { L'\x00', L'\x0a', L'\x1f', L'\x7f' })
+    {
+        for (size_t pos = 0; pos < length; pos++)
+        {
+            std::wstring str(length, L'a');
+            str[pos] = ch;
+
+            engine.ResetTestState();
+            machine.ProcessString(str);
+
+            VERIFY_ARE_EQUAL(std::wstring(length - 1, L'a'), engine.printed);
+            VERIFY_ARE_EQUAL(std::wstring(1, ch), engine.executed);
+        }
+    }
+
+    Log::Comment(L"C1 control characters end the printable run and are processed individually.");
+    for (const auto ch : { L'\x80', L'\x9f' })
+    {
+        for (size_t pos = 0; pos < length; pos++)
+        {
+            std::wstring str(length, L'a');
+            str[pos] = ch;
+
+            engine.ResetTestState();
+            machine.ProcessString(str);
+
+            VERIFY_ARE_EQUAL(std::wstring(length - 1, L'a'), engine.printed);
+            VERIFY_ARE_EQUAL(L"", engine.executed);
+        }
+    }
+
+    Log::Comment(L"Characters just outside of the actionable ranges are part of the printable run.");
+    for (const auto ch : { L'\x20', L'\x7e', L'\xa0', L'\x100', L'\x11f', L'\x17f', L'\x19f', L'\xffff' })
+    {
+        for (size_t pos = 0; pos < length; pos++)
+        {
+            std::wstring str(length, L'a');
+            str[pos] = ch;
+
+            engine.ResetTestState();
+            machine.ProcessString(str);
+
+            VERIFY_ARE_EQUAL(str, engine.printed);
+            VERIFY_ARE_EQUAL(L"", engine.executed);
+        }
+    }
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
@@ -337,3 +418,54 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::DataStringsProcessedInBulk()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    const std::wstring data(10000, L'#');
+
+    Log::Comment(L"A DCS data string is passed to the handler in chunks, split at ignored characters.");
+    machine.ProcessString(L"\033P1;2;3|" + data + L"\x7f" + data + L"\033\\");
+    VERIFY_ARE_EQUAL(data + data + L"\033", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(3u, engine.dcsDataChunks);
+
+    Log::Comment(L"A DCS data string split across writes is passed on one chunk per write.");
+    machine.ProcessString(L"\033P1;2;3|" + data);
+    machine.ProcessString(data);
+    machine.ProcessString(L"\033\\");
+    VERIFY_ARE_EQUAL(data + data + L"\033", engine.dcsDataString);
+    VERIFY_ARE_EQUAL(3u, engine.dcsDataChunks);
+
+    Log::Comment(L"An OSC data string is collected in bulk, including DEL but without ignored controls.");
+    machine.ProcessString(L"\033]52;" + data + L"\x7f\x01" + data + L"\a");
+    VERIFY_ARE_EQUAL(data + L"\x7f" + data, engine.oscString);
+
+    Log::Comment(L"The characters following the sequences are printed.");
+    machine.ProcessString(L"printed text");
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+}
+
+void StateMachineTest::DcsPassThroughFlushedOncePerWrite()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    Log::Comment(L"A write that ends inside a DCS data string flushes the pass through once.");
+    machine.ProcessString(L"\033P1;2;3|data\x7fstring");
+    VERIFY_ARE_EQUAL(2u, engine.dcsDataChunks);
+    VERIFY_ARE_EQUAL(1u, engine.passThroughFlushes);
+    machine.ProcessString(L"more\x7f");
+    VERIFY_ARE_EQUAL(2u, engine.passThroughFlushes);
+
+    Log::Comment(L"Once the string is terminated, writes don't flush anymore.");
+    machine.ProcessString(L"\033\\");
+    machine.ProcessString(L"printed text");
+    VERIFY_ARE_EQUAL(2u, engine.passThroughFlushes);
+    VERIFY_ARE_EQUAL(L"", engine.passedThrough);
+}
@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <til/lru_map.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class LruMapTests
+{
+    TEST_CLASS(LruMapTests);
+
+    using map_type = til::lru_map<std::wstring, int>;
+
+    static std::vector<std::wstring> popAll(map_type& map)
+    {
+        std::vector<std::wstring> keys;
+        map.pop_oldest(map.size(), [&](auto& entry) {
+            keys.emplace_back(std::move(entry.first));
+        });
+        return keys;
+    }
+
+    TEST_METHOD(InsertAndFind)
+    {
+        map_type map;
+        VERIFY_IS_TRUE(map.empty());
+        VERIFY_IS_TRUE(map.find(L"a") == map.end());
+
+        const auto a = map.insert(L"a", 1);
+        const auto b = map.insert(L"b", 2);
+        VERIFY_ARE_EQUAL(2u, map.size());
+        VERIFY_ARE_EQUAL(L"a", a->first);
+        VERIFY_ARE_EQUAL(2, b->second);
+
+        VERIFY_IS_TRUE(map.find(L"a") == a);
+        VERIFY_IS_TRUE(map.find(L"b") == b);
+        VERIFY_IS_TRUE(map.find(L"c") == map.end());
+    }
+
+    TEST_METHOD(LeastRecentlyUsedOrder)
+    {
+        map_type map;
+        map.insert(L"a", 1);
+        const auto b = map.insert(L"b", 2);
+        map.insert(L"c", 3);
+        map.insert(L"d", 4);
+
+        // Both find() and make_newest() turn an entry into the most recently used one.
+        map.find(L"a");
+        map.make_newest(b);
+
+        const std::vector<std::wstring> expected{ L"c", L"d", L"a", L"b" };
+        VERIFY_ARE_EQUAL(expected, popAll(map));
+        VERIFY_IS_TRUE(map.empty());
+    }
+
+    TEST_METHOD(PopOldestBatch)
+    {
+        map_type map;
+        for (auto i = 0; i < 10; ++i)
+        {
+            map.insert(std::to_wstring(i), i);
+        }
+
+        std::vector<int> values;
+        VERIFY_ARE_EQUAL(3u, map.pop_oldest(3, [&](auto& entry) { values.emplace_back(entry.second); }));
+        VERIFY_ARE_EQUAL((std::vector<int>{ 0, 1, 2 }), values);
+        VERIFY_ARE_EQUAL(7u, map.size());
+        VERIFY_IS_TRUE(map.find(L"2") == map.end());
+        VERIFY_IS_TRUE(map.find(L"3") != map.end());
+
+        // Asking for more entries than there are evicts all of them.
+        VERIFY_ARE_EQUAL(7u, map.pop_oldest(100, [](auto&) {}));
+        VERIFY_IS_TRUE(map.empty());
+    }
+
+    TEST_METHOD(IteratorsSurviveGrowth)
+    {
+        til::lru_map<int, int> map;
+        std::vector<til::lru_map<int, int>::iterator> iterators;
+
+        for (auto i = 0; i < 1000; ++i)
+        {
+            iterators.emplace_back(map.insert(int{ i }, i * 2));
+        }
+
+        for (auto i = 0; i < 1000; ++i)
+        {
+            const auto& it = til::at(iterators, i);
+            VERIFY_ARE_EQUAL(i, it->first);
+            VERIFY_ARE_EQUAL(i * 2, it->second);
+            VERIFY_IS_TRUE(map.find(i) == it);
+        }
+    }
+
+    TEST_METHOD(ReinsertAfterEviction)
+    {
+        // All keys collide, which forces every lookup through the probe sequence
+        // and makes eviction shift the remaining entries back into the freed slots.
+        struct collide
+        {
+            size_t operator()(int) const noexcept
+            {
+                return 0;
+            }
+        };
+
+        til::lru_map<int, int, collide> map;
+        for (auto i = 0; i < 8; ++i)
+        {
+            map.insert(int{ i }, i);
+        }
+
+        for (auto round = 0; round < 100; ++round)
+        {
+            auto evicted = -1;
+            map.pop_oldest(1, [&](auto& entry) { evicted = entry.first; });
+            VERIFY_ARE_EQUAL(round, evicted);
+            VERIFY_IS_TRUE(map.find(evicted) == map.end());
+
+            map.insert(round + 8, round + 8);
+            for (auto i = round + 1; i <= round + 8; ++i)
+            {
+                VERIFY_IS_TRUE(map.find(i) != map.end());
+            }
+        }
+
+        VERIFY_ARE_EQUAL(8u, map.size());
+    }
+
+    TEST_METHOD(Move)
+    {
+        map_type a;
+        a.insert(L"a", 1);
+
+        auto b = std::move(a);
+        VERIFY_IS_TRUE(a.empty());
+        VERIFY_IS_TRUE(a.find(L"a") == a.end());
+        VERIFY_ARE_EQUAL(1, b.find(L"a")->second);
+
+        a = std::move(b);
+        VERIFY_IS_TRUE(b.empty());
+        VERIFY_ARE_EQUAL(1u, a.size());
+    }
+};
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <random>
+
+#include <til/shelf_packer.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ShelfPackerTests
+{
+    TEST_CLASS(ShelfPackerTests);
+
+    static til::point allocate(til::shelf_packer& packer, const til::size size)
+    {
+        const auto pos = packer.allocate(size);
+        VERIFY_IS_TRUE(pos.has_value());
+        return pos.value_or(til::point{ -1, -1 });
+    }
+
+    TEST_METHOD(AllocateRowByRow)
+    {
+        til::shelf_packer packer{ { 30, 40 } };
+
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), allocate(packer, { 10, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 10, 0 }), allocate(packer, { 20, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 0, 20 }), allocate(packer, { 10, 20 }));
+        VERIFY_ARE_EQUAL(2u, packer.shelf_count());
+
+        // Neither fits into the remaining 20x20 gap.
+        VERIFY_IS_FALSE(packer.allocate({ 30, 10 }).has_value());
+        VERIFY_IS_FALSE(packer.allocate({ 10, 30 }).has_value());
+        VERIFY_IS_FALSE(packer.allocate({ 0, 10 }).has_value());
+    }
+
+    TEST_METHOD(ShelvesByHeight)
+    {
+        til::shelf_packer packer{ { 100, 100 } };
+
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), allocate(packer, { 10, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 0, 20 }), allocate(packer, { 10, 30 }));
+        // Rectangles go on the shelf that matches their height best.
+        VERIFY_ARE_EQUAL((til::point{ 10, 0 }), allocate(packer, { 10, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 10, 20 }), allocate(packer, { 10, 30 }));
+        // A shorter rectangle gets its own shelf while there's room for it...
+        VERIFY_ARE_EQUAL((til::point{ 0, 50 }), allocate(packer, { 10, 10 }));
+        VERIFY_ARE_EQUAL((til::point{ 0, 60 }), allocate(packer, { 100, 40 }));
+        // ...and otherwise makes do with a taller one.
+        VERIFY_ARE_EQUAL((til::point{ 20, 0 }), allocate(packer, { 10, 15 }));
+    }
+
+    TEST_METHOD(DeallocateCoalesces)
+    {
+        til::shelf_packer packer{ { 30, 20 } };
+
+        const auto a = allocate(packer, { 10, 20 });
+        const auto b = allocate(packer, { 10, 20 });
+        allocate(packer, { 10, 20 });
+        VERIFY_IS_FALSE(packer.allocate({ 10, 20 }).has_value());
+
+        packer.deallocate({ b, til::size{ 10, 20 } });
+        packer.deallocate({ a, til::size{ 10, 20 } });
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), allocate(packer, { 20, 20 }));
+    }
+
+    TEST_METHOD(EmptyShelvesAreReused)
+    {
+        til::shelf_packer packer{ { 100, 60 } };
+
+        const auto tall = allocate(packer, { 100, 40 });
+        VERIFY_ARE_EQUAL((til::point{ 0, 40 }), allocate(packer, { 100, 20 }));
+        packer.deallocate({ tall, til::size{ 100, 40 } });
+
+        // The empty 40px shelf is split up into two 20px ones.
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), allocate(packer, { 50, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 0, 20 }), allocate(packer, { 100, 20 }));
+        VERIFY_ARE_EQUAL((til::point{ 50, 0 }), allocate(packer, { 50, 20 }));
+        VERIFY_ARE_EQUAL(3u, packer.shelf_count());
+    }
+
+    TEST_METHOD(Grow)
+    {
+        til::shelf_packer packer{ { 100, 20 } };
+
+        VERIFY_ARE_EQUAL((til::point{ 0, 0 }), allocate(packer, { 100, 20 }));
+        VERIFY_IS_FALSE(packer.allocate({ 10, 20 }).has_value());
+
+        packer.grow({ 200, 20 });
+        VERIFY_ARE_EQUAL((til::point{ 100, 0 }), allocate(packer, { 10, 20 }));
+
+        packer.grow({ 200, 40 });
+        VERIFY_ARE_EQUAL((til::point{ 0, 20 }), allocate(packer, { 200, 20 }));
+    }
+
+    TEST_METHOD(Occupancy)
+    {
+        til::shelf_packer packer{ { 100, 100 } };
+        VERIFY_ARE_EQUAL(0.0, packer.occupancy());
+
+        const auto a = allocate(packer, { 50, 50 });
+        allocate(packer, { 50, 50 });
+        VERIFY_ARE_EQUAL(5000u, packer.allocated_area());
+        VERIFY_ARE_EQUAL(0.5, packer.occupancy());
+
+        packer.deallocate({ a, til::size{ 50, 50 } });
+        VERIFY_ARE_EQUAL(2500u, packer.allocated_area());
+        VERIFY_ARE_EQUAL(0.25, packer.occupancy());
+    }
+
+    TEST_METHOD(RandomAllocations)
+    {
+        // Allocates and deallocates rectangles at random and checks that they never overlap.
+        // Once everything is deallocated, all shelves should have been merged away.
+        static constexpr til::size area{ 256, 256 };
+
+        til::shelf_packer packer{ area };
+        std::vector<bool> used(area.area<size_t>());
+        std::vector<til::rect> rects;
+        std::mt19937 rng{ 1337 };
+
+        const auto mark = [&](const til::rect& rect, bool value) {
+            for (auto y = rect.top; y < rect.bottom; ++y)
+            {
+                for (auto x = rect.left; x < rect.right; ++x)
+                {
+                    const auto idx = gsl::narrow_cast<size_t>(y * area.width + x);
+                    VERIFY_ARE_NOT_EQUAL(value, static_cast<bool>(used[idx]));
+                    used[idx] = value;
+                }
+            }
+        };
+
+        for (auto i = 0; i < 2000; ++i)
+        {
+            if (rects.empty() || rng() % 3 != 0)
+            {
+                const til::size size{ 10 * gsl::narrow_cast<til::CoordType>(1 + rng() % 4), gsl::narrow_cast<til::CoordType>(10 + rng() % 20) };
+                if (const auto pos = packer.allocate(size))
+                {
+                    const til::rect rect{ *pos, size };
+                    VERIFY_IS_TRUE(rect.right <= area.width && rect.bottom <= area.height);
+                    mark(rect, true);
+                    rects.emplace_back(rect);
+                }
+            }
+            else
+            {
+                const auto it = rects.begin() + gsl::narrow_cast<ptrdiff_t>(rng() % rects.size());
+                mark(*it, false);
+                packer.deallocate(*it);
+                rects.erase(it);
+            }
+        }
+
+        for (const auto& rect : rects)
+        {
+            packer.deallocate(rect);
+        }
+
+        VERIFY_ARE_EQUAL(0u, packer.allocated_area());
+        VERIFY_ARE_EQUAL(0u, packer.shelf_count());
+    }
+};
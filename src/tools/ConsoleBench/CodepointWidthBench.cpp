@@ -0,0 +1,93 @@
+// TEST TOOL ConsoleBench
+// Measures how fast CodepointWidthDetector classifies the glyphs of CJK, emoji and other text.
+// Wide and narrow codepoints are looked up in the two-level table generated from the Unicode
+// width ranges at compile time. Ambiguous ones (here: Greek) are asked of the font via the fallback,
+// whose results are cached per codepoint until the font changes.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../types/inc/CodepointWidthDetector.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr size_t corpusLength = 1024 * 1024;
+
+    // Greek capital letters are ambiguous width, like a lot of the Cyrillic and box drawing characters.
+    std::wstring generateAmbiguousCorpus()
+    {
+        std::wstring text;
+        text.reserve(corpusLength);
+        for (size_t i = 0; text.size() < corpusLength; ++i)
+        {
+            text.push_back(gsl::narrow_cast<wchar_t>(0x391 + i % 17));
+        }
+        return text;
+    }
+
+    // Splits `text` into its codepoints, like the TextBuffer does before it asks for their width.
+    std::vector<std::wstring_view> splitGlyphs(const std::wstring_view text)
+    {
+        std::vector<std::wstring_view> glyphs;
+        glyphs.reserve(text.size());
+
+        for (size_t i = 0; i < text.size();)
+        {
+            const auto length = IS_HIGH_SURROGATE(text[i]) && i + 1 < text.size() ? 2 : 1;
+            glyphs.emplace_back(text.substr(i, length));
+            i += length;
+        }
+
+        return glyphs;
+    }
+
+    void benchmark(const std::string_view label, const CodepointWidthDetector& detector, const std::vector<std::wstring_view>& glyphs, const bool fontChanges)
+    {
+        size_t wide = 0;
+        const auto classify = [&]() {
+            wide = 0;
+            for (const auto& glyph : glyphs)
+            {
+                wide += detector.GetWidth(glyph) == CodepointWidth::Wide;
+            }
+        };
+
+        const auto duration = Measure([&]() {
+            if (fontChanges)
+            {
+                detector.NotifyFontChanged();
+            }
+            classify();
+        });
+
+        ReportValue(fmt::format("{} glyphs/s", label), glyphs.size() / duration / 1e6, "M");
+        ReportValue(fmt::format("{} wide", label), 100.0 * wide / glyphs.size(), "%");
+    }
+
+    void benchmarkCodepointWidth()
+    {
+        CodepointWidthDetector plain;
+        CodepointWidthDetector withFallback;
+        // Stands in for the renderer's IsGlyphWideByFont(), which is a lot more expensive.
+        withFallback.SetFallbackMethod([](const std::wstring_view glyph) {
+            return glyph.front() % 2 == 0;
+        });
+
+        for (const auto corpus : AllCorpora)
+        {
+            const auto text = GenerateCorpus(corpus, corpusLength);
+            const auto glyphs = splitGlyphs(text);
+            benchmark(CorpusName(corpus), plain, glyphs, false);
+        }
+
+        const auto text = generateAmbiguousCorpus();
+        const auto glyphs = splitGlyphs(text);
+        benchmark("ambiguous", plain, glyphs, false);
+        benchmark("ambiguous with fallback", withFallback, glyphs, false);
+        benchmark("ambiguous with fallback and font change", withFallback, glyphs, true);
+    }
+
+    const Registration registration{ "Types/CodepointWidth", &benchmarkCodepointWidth };
+}
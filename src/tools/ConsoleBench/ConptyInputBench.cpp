@@ -0,0 +1,225 @@
+// TEST TOOL ConsoleBench
+// Measures how fast a large paste makes it through ConPTY's input path: Reading from the input pipe,
+// UTF-8 conversion, the InputStateMachineEngine and writing the resulting key events to the input buffer.
+// It compares the way VtInputThread used to read (256 byte reads, one input buffer write per dispatched
+// string or key) with the current one (large reads that drain the pipe, one input buffer write per read).
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../terminal/adapter/IInteractDispatch.hpp"
+#include "../../terminal/parser/InputStateMachineEngine.hpp"
+#include "../../terminal/parser/stateMachine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::VirtualTerminal;
+
+// The InputStateMachineEngine depends on these, which are usually provided by the
+// interactivity library. Since we don't run on OneCore, we don't need its shims.
+extern "C" UINT OneCoreSafeMapVirtualKeyW(_In_ UINT uCode, _In_ UINT uMapType)
+{
+    return MapVirtualKeyW(uCode, uMapType);
+}
+
+extern "C" SHORT OneCoreSafeVkKeyScanW(_In_ WCHAR ch)
+{
+    return VkKeyScanW(ch);
+}
+
+namespace
+{
+    constexpr size_t pasteLength = 10 * 1024 * 1024;
+    // The terminal writes a paste into the pipe in pieces about this large.
+    constexpr size_t writeSize = 4 * 1024;
+    constexpr DWORD unbatchedReadSize = 256;
+    constexpr DWORD batchedReadSize = 64 * 1024;
+
+    // Stands in for conhost's InputBuffer: Every write acquires its lock and signals
+    // its input event to wake up readers. The events are consumed right away, as if by a client.
+    struct InputQueue
+    {
+        void Write(std::deque<std::unique_ptr<IInputEvent>>& inputEvents)
+        {
+            {
+                const std::lock_guard guard{ lock };
+                events += inputEvents.size();
+                ++writes;
+            }
+            wake.SetEvent();
+            inputEvents.clear();
+        }
+
+        std::mutex lock;
+        wil::unique_event wake{ wil::EventOptions::ManualReset };
+        size_t events = 0;
+        size_t writes = 0;
+    };
+
+    // Turns the parsed input into key events the same way InteractDispatch does.
+    class PasteDispatch final : public IInteractDispatch
+    {
+    public:
+        explicit PasteDispatch(InputQueue& queue) noexcept :
+            _queue{ queue } {}
+
+        bool WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override
+        {
+            if (_batching)
+            {
+                std::move(inputEvents.begin(), inputEvents.end(), std::back_inserter(_pending));
+                inputEvents.clear();
+                return true;
+            }
+
+            _queue.Write(inputEvents);
+            return true;
+        }
+
+        bool WriteCtrlKey(const KeyEvent& event) override
+        {
+            Flush();
+            std::deque<std::unique_ptr<IInputEvent>> inputEvents;
+            inputEvents.push_back(std::make_unique<KeyEvent>(event));
+            _queue.Write(inputEvents);
+            return true;
+        }
+
+        bool WriteString(const std::wstring_view string) override
+        {
+            std::deque<std::unique_ptr<IInputEvent>> inputEvents;
+            for (const auto wch : string)
+            {
+                inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, wch, 0));
+                inputEvents.push_back(std::make_unique<KeyEvent>(false, 1ui16, 0ui16, 0ui16, wch, 0));
+            }
+            return WriteInput(inputEvents);
+        }
+
+        bool WindowManipulation(const DispatchTypes::WindowManipulationType, const VTParameter, const VTParameter) noexcept override { return true; }
+        bool MoveCursor(const VTInt, const VTInt) noexcept override { return true; }
+        bool IsVtInputEnabled() const noexcept override { return false; }
+        bool FocusChanged(const bool) const noexcept override { return true; }
+
+        void SetBatching(const bool batching)
+        {
+            _batching = batching;
+            if (!batching)
+            {
+                Flush();
+            }
+        }
+
+        void Flush()
+        {
+            if (!_pending.empty())
+            {
+                _queue.Write(_pending);
+            }
+        }
+
+    private:
+        InputQueue& _queue;
+        std::deque<std::unique_ptr<IInputEvent>> _pending;
+        bool _batching = false;
+    };
+
+    // Reads the paste the way VtInputThread::DoReadInput() does, with or without batching.
+    struct InputReader
+    {
+        explicit InputReader(InputQueue& queue) :
+            machine{ [&]() {
+                auto dispatch = std::make_unique<PasteDispatch>(queue);
+                this->dispatch = dispatch.get();
+                return std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+            }() }
+        {
+        }
+
+        void Handle(const std::string_view input, const bool batched)
+        {
+            // Stands in for the console lock.
+            const std::lock_guard guard{ lock };
+            THROW_IF_FAILED(til::u8u16(input, text, state));
+
+            dispatch->SetBatching(batched);
+            machine.ProcessString(text);
+            dispatch->SetBatching(false);
+        }
+
+        void ReadUnbatched(const HANDLE pipe)
+        {
+            std::array<char, unbatchedReadSize> buffer;
+            DWORD read = 0;
+
+            while (ReadFile(pipe, buffer.data(), unbatchedReadSize, &read, nullptr) && read != 0)
+            {
+                Handle({ buffer.data(), read }, false);
+            }
+        }
+
+        void ReadBatched(const HANDLE pipe)
+        {
+            const auto buffer = std::make_unique<char[]>(batchedReadSize);
+            DWORD read = 0;
+
+            while (ReadFile(pipe, buffer.get(), batchedReadSize, &read, nullptr) && read != 0)
+            {
+                while (read < batchedReadSize)
+                {
+                    DWORD available = 0;
+                    DWORD more = 0;
+                    if (!PeekNamedPipe(pipe, nullptr, 0, nullptr, &available, nullptr) || available == 0 ||
+                        !ReadFile(pipe, buffer.get() + read, std::min(available, batchedReadSize - read), &more, nullptr) || more == 0)
+                    {
+                        break;
+                    }
+                    read += more;
+                }
+
+                Handle({ buffer.get(), read }, true);
+            }
+        }
+
+        std::mutex lock;
+        PasteDispatch* dispatch = nullptr;
+        StateMachine machine;
+        til::u8state state;
+        std::wstring text;
+    };
+
+    void benchmark(const std::string_view label, const std::string_view paste, const size_t chars, const bool batched)
+    {
+        InputQueue queue;
+        InputReader reader{ queue };
+
+        const auto duration = Measure([&]() {
+            ReplayThroughPipe(paste, writeSize, [&](const HANDLE pipe) {
+                batched ? reader.ReadBatched(pipe) : reader.ReadUnbatched(pipe);
+            });
+        });
+
+        ReportThroughput(label, paste.size(), duration);
+        ReportValue(fmt::format("{} chars/s", label), static_cast<double>(chars) / duration / 1e6, "M");
+
+        // The number of times the input buffer is written to for a single paste.
+        InputQueue countQueue;
+        InputReader countReader{ countQueue };
+        ReplayThroughPipe(paste, writeSize, [&](const HANDLE pipe) {
+            batched ? countReader.ReadBatched(pipe) : countReader.ReadUnbatched(pipe);
+        });
+        ReportValue(fmt::format("{} input buffer writes", label), static_cast<double>(countQueue.writes), "");
+    }
+
+    void benchmarkConptyInput()
+    {
+        // Pasted text uses carriage returns as line endings, which the engine turns into Enter key presses.
+        auto text = GenerateCorpus(Corpus::Ascii, pasteLength);
+        std::replace(text.begin(), text.end(), L'\n', L'\r');
+        const auto paste = til::u16u8(text);
+
+        benchmark("10 MB paste unbatched", paste, text.size(), false);
+        benchmark("10 MB paste batched", paste, text.size(), true);
+    }
+
+    const Registration registration{ "Conpty/Input", &benchmarkConptyInput };
+}
@@ -0,0 +1,173 @@
+// TEST TOOL ConsoleBench
+// Replays a VT stream through a local pipe and compares the two ways ConptyConnection has read its output:
+// * serial: 4 KiB reads, each one converted from UTF-8 and parsed on the reading thread.
+// * pipelined: 64 KiB reads into a ring of buffers, handed to a parse thread via til::spsc,
+//   which converts and parses all chunks that are ready under a single lock acquisition.
+// By default a generated log is replayed. To replay a captured stream instead (for instance
+// the raw output of a ConPTY session), point the CONSOLEBENCH_VT_CAPTURE environment variable at it.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+#include "NullEngine.hpp"
+
+#include <til/spsc.h>
+
+#include "../../terminal/parser/stateMachine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::VirtualTerminal;
+
+namespace
+{
+    constexpr size_t corpusLength = 16 * 1024 * 1024;
+    // conhost flushes its output in pieces about this large.
+    constexpr size_t writeSize = 4 * 1024;
+    constexpr size_t serialReadSize = 4 * 1024;
+    constexpr size_t pipelinedChunkSize = 64 * 1024;
+    constexpr uint32_t pipelinedChunkCount = 4;
+
+    // Stands in for the terminal: Every call acquires its lock once and parses the given text.
+    struct Sink
+    {
+        void operator()(const std::wstring_view text)
+        {
+            const std::lock_guard guard{ lock };
+            machine.ProcessString(text);
+            ++calls;
+        }
+
+        std::mutex lock;
+        StateMachine machine{ std::make_unique<NullEngine>() };
+        size_t calls = 0;
+    };
+
+    struct Chunk
+    {
+        char* data = nullptr;
+        DWORD size = 0;
+    };
+
+    void readSerial(const HANDLE pipe, Sink& sink)
+    {
+        std::array<char, serialReadSize> buffer;
+        til::u8state state;
+        std::wstring text;
+
+        while (true)
+        {
+            DWORD read{};
+            if (!ReadFile(pipe, buffer.data(), gsl::narrow_cast<DWORD>(buffer.size()), &read, nullptr) || read == 0)
+            {
+                break;
+            }
+
+            THROW_IF_FAILED(til::u8u16(std::string_view{ buffer.data(), read }, text, state));
+            sink(text);
+        }
+    }
+
+    void parsePipelined(const til::spsc::consumer<Chunk>& chunks, const til::spsc::producer<char*>& freeBuffers, Sink& sink)
+    {
+        std::array<Chunk, pipelinedChunkCount> batch{};
+        til::u8state state;
+        std::wstring text;
+        std::wstring chunkText;
+
+        while (true)
+        {
+            const auto [count, alive] = chunks.pop_n(til::spsc::block_initially, batch.begin(), batch.size());
+
+            text.clear();
+            for (const auto& chunk : gsl::make_span(batch.data(), count))
+            {
+                THROW_IF_FAILED(til::u8u16(std::string_view{ chunk.data, chunk.size }, chunkText, state));
+                freeBuffers.emplace(chunk.data);
+                text.append(chunkText);
+            }
+
+            if (!text.empty())
+            {
+                sink(text);
+            }
+
+            if (!alive)
+            {
+                break;
+            }
+        }
+    }
+
+    void readPipelined(const HANDLE pipe, Sink& sink)
+    {
+        const auto buffers = std::make_unique<char[]>(pipelinedChunkSize * pipelinedChunkCount);
+        auto [chunkProducer, chunkConsumer] = til::spsc::channel<Chunk>(pipelinedChunkCount);
+        auto [freeProducer, freeConsumer] = til::spsc::channel<char*>(pipelinedChunkCount);
+
+        for (size_t i = 0; i < pipelinedChunkCount; ++i)
+        {
+            freeProducer.emplace(buffers.get() + i * pipelinedChunkSize);
+        }
+
+        std::thread parser{ [&sink, chunks = std::move(chunkConsumer), freeBuffers = std::move(freeProducer)]() {
+            parsePipelined(chunks, freeBuffers, sink);
+        } };
+
+        {
+            const auto chunks = std::move(chunkProducer);
+
+            while (const auto buffer = freeConsumer.pop())
+            {
+                DWORD read{};
+                if (!ReadFile(pipe, *buffer, gsl::narrow_cast<DWORD>(pipelinedChunkSize), &read, nullptr) || read == 0)
+                {
+                    break;
+                }
+
+                if (!chunks.emplace(Chunk{ *buffer, read }))
+                {
+                    break;
+                }
+            }
+        }
+
+        parser.join();
+    }
+
+    void benchmark(const std::string_view label, const std::string_view data)
+    {
+        Sink serialSink;
+        Sink pipelinedSink;
+
+        const auto serial = Measure([&]() { ReplayThroughPipe(data, writeSize, [&](const HANDLE pipe) { readSerial(pipe, serialSink); }); });
+        const auto pipelined = Measure([&]() { ReplayThroughPipe(data, writeSize, [&](const HANDLE pipe) { readPipelined(pipe, pipelinedSink); }); });
+
+        ReportThroughput(fmt::format("{} serial", label), data.size(), serial);
+        ReportThroughput(fmt::format("{} pipelined", label), data.size(), pipelined);
+        ReportValue(fmt::format("{} speedup", label), serial / pipelined, "x");
+
+        // The number of times the terminal's lock is acquired for a single replay.
+        Sink serialCount;
+        Sink pipelinedCount;
+        ReplayThroughPipe(data, writeSize, [&](const HANDLE pipe) { readSerial(pipe, serialCount); });
+        ReplayThroughPipe(data, writeSize, [&](const HANDLE pipe) { readPipelined(pipe, pipelinedCount); });
+        ReportValue(fmt::format("{} serial lock acquisitions", label), static_cast<double>(serialCount.calls), "");
+        ReportValue(fmt::format("{} pipelined lock acquisitions", label), static_cast<double>(pipelinedCount.calls), "");
+    }
+
+    void benchmarkConptyPipe()
+    {
+        std::array<wchar_t, MAX_PATH> path{};
+        if (GetEnvironmentVariableW(L"CONSOLEBENCH_VT_CAPTURE", path.data(), gsl::narrow_cast<DWORD>(path.size())) != 0)
+        {
+            benchmark("capture", LoadFile(path.data()));
+            return;
+        }
+
+        for (const auto corpus : AllCorpora)
+        {
+            benchmark(fmt::format("{} log", CorpusName(corpus)), til::u16u8(GenerateCorpus(corpus, corpusLength)));
+        }
+    }
+
+    const Registration registration{ "Conpty/Pipe", &benchmarkConptyPipe };
+}
@@ -0,0 +1,176 @@
+// TEST TOOL ConsoleBench
+// Measures how many bytes ConPTY's XtermEngine sends to the terminal when an application like `top`
+// rewrites its whole screen every frame, while only a few numbers on it change.
+// It compares repainting every invalidated cell (the way VtEngine used to work) with
+// painting only the cells that differ from the shadow frame of what the terminal already displays.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../renderer/vt/XtermEngine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+namespace
+{
+    constexpr til::CoordType screenWidth = 120;
+    constexpr til::CoordType screenHeight = 30;
+    constexpr size_t frameCount = 1000;
+    // The chance that a process' CPU usage changes from one frame to the next, in percent.
+    constexpr int changeChance = 25;
+
+    using Frame = std::vector<std::wstring>;
+
+    // Paints every invalidated cell, unless `diff` is set, in which case it
+    // defers to XtermEngine, which only paints the cells that changed.
+    class WireEngine final : public XtermEngine
+    {
+    public:
+        WireEngine(wil::unique_hfile pipe, const bool diff) :
+            XtermEngine{ std::move(pipe), Viewport::FromDimensions({ screenWidth, screenHeight }), false },
+            _diff{ diff }
+        {
+        }
+
+        [[nodiscard]] HRESULT PaintBufferLine(const gsl::span<const Cluster> clusters,
+                                              const til::point coord,
+                                              const bool trimLeft,
+                                              const bool lineWrapped) noexcept override
+        {
+            return _diff ?
+                       XtermEngine::PaintBufferLine(clusters, coord, trimLeft, lineWrapped) :
+                       _PaintUtf8BufferLine(clusters, coord, lineWrapped);
+        }
+
+    private:
+        bool _diff;
+    };
+
+    std::wstring padRow(const std::string_view text)
+    {
+        std::wstring row(gsl::narrow_cast<size_t>(screenWidth), L' ');
+        std::copy_n(text.begin(), std::min(text.size(), row.size()), row.begin());
+        return row;
+    }
+
+    // Generates the screens of a `top`-like application: A header with a clock and the
+    // load average, followed by a table of processes whose CPU usage fluctuates.
+    std::vector<Frame> generateFrames()
+    {
+        struct Process
+        {
+            int pid;
+            int virt;
+            int res;
+            int cpu;
+            int time;
+        };
+
+        std::mt19937 rng{ 1337 };
+        std::uniform_int_distribution percent{ 0, 99 };
+        std::vector<Process> processes;
+        for (til::CoordType y = 5; y < screenHeight; ++y)
+        {
+            processes.push_back({ 1000 + y * 37, 100000 + percent(rng) * 4096, 2000 + percent(rng) * 64, percent(rng) * 10, 0 });
+        }
+
+        std::vector<Frame> frames;
+        frames.reserve(frameCount);
+
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            auto total = 0;
+            for (auto& p : processes)
+            {
+                if (percent(rng) < changeChance)
+                {
+                    p.cpu = percent(rng) * 10;
+                }
+                p.time += p.cpu;
+                total += p.cpu;
+            }
+
+            Frame frame;
+            frame.push_back(padRow(fmt::format("top - 12:{:02}:{:02} up 3 days,  4:27,  2 users,  load average: {:.2f}, 0.97, 0.88", i / 60 % 60, i % 60, total / 1000.0)));
+            frame.push_back(padRow("Tasks: 312 total,   1 running, 311 sleeping,   0 stopped,   0 zombie"));
+            frame.push_back(padRow(fmt::format("%Cpu(s): {:4.1f} us,  1.2 sy,  0.0 ni, {:4.1f} id,  0.0 wa,  0.0 hi,  0.1 si,  0.0 st", total / 250.0, 100.0 - total / 250.0)));
+            frame.push_back(padRow({}));
+            frame.push_back(padRow("    PID USER      PR  NI    VIRT    RES  S  %CPU  %MEM     TIME+ COMMAND"));
+            for (const auto& p : processes)
+            {
+                frame.push_back(padRow(fmt::format("{:>7} user      20   0 {:>7} {:>6}  S {:>5.1f}   0.4 {:>3}:{:02}.{:02} process-{}", p.pid, p.virt, p.res, p.cpu / 10.0, p.time / 6000, p.time / 100 % 60, p.time % 100, p.pid)));
+            }
+            frames.emplace_back(std::move(frame));
+        }
+
+        return frames;
+    }
+
+    // Paints all frames and returns the number of bytes that were sent to the terminal.
+    size_t paintFrames(const std::vector<Frame>& frames, const bool diff)
+    {
+        wil::unique_hfile reader;
+        wil::unique_hfile writer;
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(reader.addressof(), writer.addressof(), nullptr, 0));
+
+        size_t bytes = 0;
+        std::thread drain{ [&]() {
+            const auto buffer = std::make_unique<char[]>(64 * 1024);
+            DWORD read = 0;
+            while (ReadFile(reader.get(), buffer.get(), 64 * 1024, &read, nullptr) && read != 0)
+            {
+                bytes += read;
+            }
+        } };
+
+        {
+            WireEngine engine{ std::move(writer), diff };
+            std::vector<Cluster> clusters;
+            const til::rect everything{ 0, 0, screenWidth, screenHeight };
+
+            for (const auto& frame : frames)
+            {
+                THROW_IF_FAILED(engine.Invalidate(&everything));
+                THROW_IF_FAILED(engine.StartPaint());
+
+                for (til::CoordType y = 0; y < screenHeight; ++y)
+                {
+                    const auto& row = til::at(frame, y);
+                    clusters.clear();
+                    for (size_t x = 0; x < row.size(); ++x)
+                    {
+                        clusters.emplace_back(std::wstring_view{ row }.substr(x, 1), 1);
+                    }
+                    THROW_IF_FAILED(engine.PaintBufferLine({ clusters.data(), clusters.size() }, { 0, y }, false, false));
+                }
+
+                THROW_IF_FAILED(engine.EndPaint());
+            }
+        }
+
+        drain.join();
+        return bytes;
+    }
+
+    void benchmarkConptyRepaint()
+    {
+        const auto frames = generateFrames();
+        const auto frameTotal = static_cast<double>(frames.size());
+
+        const auto fullBytes = paintFrames(frames, false);
+        const auto diffBytes = paintFrames(frames, true);
+        ReportValue("top full repaint bytes/frame", static_cast<double>(fullBytes) / frameTotal, "B");
+        ReportValue("top shadow frame bytes/frame", static_cast<double>(diffBytes) / frameTotal, "B");
+        ReportValue("top reduction", static_cast<double>(fullBytes) / static_cast<double>(diffBytes), "x");
+
+        // Diffing against the shadow frame shouldn't cost more than it saves in writing.
+        const auto full = Measure([&]() { paintFrames(frames, false); });
+        const auto diff = Measure([&]() { paintFrames(frames, true); });
+        ReportValue("top full repaint frames/s", frameTotal / full / 1e3, "k");
+        ReportValue("top shadow frame frames/s", frameTotal / diff / 1e3, "k");
+    }
+
+    const Registration registration{ "Conpty/Repaint", &benchmarkConptyRepaint };
+}
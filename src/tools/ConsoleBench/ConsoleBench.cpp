@@ -0,0 +1,156 @@
+// TEST TOOL ConsoleBench
+// Micro-benchmarks for the console and terminal core (TextBuffer, parser, renderer, ...).
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+using namespace ConsoleBench;
+
+static std::vector<Benchmark>& benchmarks() noexcept
+{
+    // Function-local static to avoid the static initialization order fiasco
+    // with the Registration instances spread over the other translation units.
+    static std::vector<Benchmark> s_benchmarks;
+    return s_benchmarks;
+}
+
+Registration::Registration(std::string_view name, BenchmarkFunc func)
+{
+    benchmarks().emplace_back(Benchmark{ name, func });
+}
+
+const std::vector<Benchmark>& ConsoleBench::GetBenchmarks() noexcept
+{
+    return benchmarks();
+}
+
+std::string_view ConsoleBench::CorpusName(Corpus corpus) noexcept
+{
+    switch (corpus)
+    {
+    case Corpus::Ascii:
+        return "ASCII";
+    case Corpus::Cjk:
+        return "CJK";
+    case Corpus::Emoji:
+        return "Emoji";
+    default:
+        return "?";
+    }
+}
+
+std::wstring ConsoleBench::GenerateCorpus(Corpus corpus, size_t length, bool lineFeeds)
+{
+    // A fixed seed ensures that runs are comparable with each other.
+    std::mt19937_64 rng{ 0x5eed };
+    std::wstring text;
+    text.reserve(length + 1);
+
+    size_t glyphs = 0;
+    while (text.size() < length)
+    {
+        if (lineFeeds && ++glyphs % 100 == 0)
+        {
+            text.push_back(L'\n');
+            continue;
+        }
+
+        switch (corpus)
+        {
+        case Corpus::Ascii:
+            // Printable ASCII [0x20, 0x7E].
+            text.push_back(static_cast<wchar_t>(0x20 + rng() % 95));
+            break;
+        case Corpus::Cjk:
+            // CJK Unified Ideographs [U+4E00, U+9FFF].
+            text.push_back(static_cast<wchar_t>(0x4E00 + rng() % 0x5200));
+            break;
+        case Corpus::Emoji:
+        {
+            // Supplemental Symbols and Pictographs [U+1F900, U+1F9FF] encoded as surrogate pairs.
+            const auto codepoint = 0x1F900 + static_cast<uint32_t>(rng() % 0x100) - 0x10000;
+            text.push_back(static_cast<wchar_t>(0xD800 + (codepoint >> 10)));
+            text.push_back(static_cast<wchar_t>(0xDC00 + (codepoint & 0x3FF)));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    text.resize(length);
+    return text;
+}
+
+double ConsoleBench::Now() noexcept
+{
+    using clock = std::chrono::steady_clock;
+    static const auto epoch = clock::now();
+    return std::chrono::duration<double>(clock::now() - epoch).count();
+}
+
+void ConsoleBench::ReportThroughput(std::string_view label, size_t bytes, double seconds)
+{
+    const auto megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    fmt::print("  {:<48} {:>10.2f} MB/s {:>10.3f} ms\n", label, megabytes / seconds, seconds * 1e3);
+}
+
+void ConsoleBench::ReportValue(std::string_view label, double value, std::string_view unit)
+{
+    fmt::print("  {:<48} {:>10.2f} {}\n", label, value, unit);
+}
+
+std::string ConsoleBench::LoadFile(const wchar_t* path)
+{
+    const wil::unique_hfile file{ CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    THROW_LAST_ERROR_IF(!file);
+
+    LARGE_INTEGER size{};
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &size));
+
+    std::string data(gsl::narrow<size_t>(size.QuadPart), '\0');
+    size_t offset = 0;
+
+    while (offset < data.size())
+    {
+        DWORD read{};
+        THROW_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), data.data() + offset, gsl::narrow_cast<DWORD>(std::min<size_t>(data.size() - offset, 1024 * 1024)), &read, nullptr));
+        if (read == 0)
+        {
+            break;
+        }
+        offset += read;
+    }
+
+    data.resize(offset);
+    return data;
+}
+
+void ConsoleBench::ReplayThroughPipe(std::string_view data, size_t writeSize, const std::function<void(HANDLE)>& read)
+{
+    wil::unique_hfile readPipe;
+    wil::unique_hfile writePipe;
+    THROW_IF_WIN32_BOOL_FALSE(CreatePipe(readPipe.addressof(), writePipe.addressof(), nullptr, 128 * 1024));
+
+    std::thread writer{ [&]() {
+        for (size_t i = 0; i < data.size(); i += writeSize)
+        {
+            const auto chunk = data.substr(i, writeSize);
+            DWORD written{};
+            if (!WriteFile(writePipe.get(), chunk.data(), gsl::narrow_cast<DWORD>(chunk.size()), &written, nullptr))
+            {
+                break;
+            }
+        }
+        // Closing our end of the pipe makes the reader's ReadFile() fail with ERROR_BROKEN_PIPE.
+        writePipe.reset();
+    } };
+
+    // If `read` exits early, closing the read end unblocks the writer.
+    const auto cleanup = wil::scope_exit([&]() {
+        readPipe.reset();
+        writer.join();
+    });
+
+    read(readPipe.get());
+}
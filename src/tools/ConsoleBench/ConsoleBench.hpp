@@ -0,0 +1,77 @@
+// TEST TOOL ConsoleBench
+// Micro-benchmarks for the console and terminal core (TextBuffer, parser, renderer, ...).
+// Every benchmark registers itself via a static ConsoleBench::Registration and is run by main.cpp,
+// optionally filtered by a substring of its name given on the command line. For instance:
+//   ConsoleBench.exe TextBuffer
+
+#pragma once
+
+namespace ConsoleBench
+{
+    using BenchmarkFunc = void (*)();
+
+    struct Benchmark
+    {
+        std::string_view name;
+        BenchmarkFunc func;
+    };
+
+    // Registers a benchmark at static initialization time. Use it like this:
+    //   static const ConsoleBench::Registration registration{ "TextBuffer/Write", &myBenchmark };
+    struct Registration
+    {
+        Registration(std::string_view name, BenchmarkFunc func);
+    };
+
+    const std::vector<Benchmark>& GetBenchmarks() noexcept;
+
+    enum class Corpus
+    {
+        Ascii,
+        Cjk,
+        Emoji,
+    };
+
+    inline constexpr std::array AllCorpora{ Corpus::Ascii, Corpus::Cjk, Corpus::Emoji };
+
+    std::string_view CorpusName(Corpus corpus) noexcept;
+    // Generates `length` UTF-16 code units of printable text, containing
+    // a line feed approximately every 100 glyphs to simulate log output.
+    std::wstring GenerateCorpus(Corpus corpus, size_t length, bool lineFeeds = true);
+
+    // Returns the number of seconds that have passed since an arbitrary epoch.
+    double Now() noexcept;
+
+    // Runs `func` repeatedly for at least `minDuration` seconds (after 1 warmup iteration)
+    // and returns the average number of seconds a single iteration took.
+    template<typename Func>
+    double Measure(Func&& func, const double minDuration = 1.0)
+    {
+        func();
+
+        size_t iterations = 0;
+        const auto beg = Now();
+        auto end = beg;
+
+        do
+        {
+            func();
+            ++iterations;
+            end = Now();
+        } while (end - beg < minDuration);
+
+        return (end - beg) / static_cast<double>(iterations);
+    }
+
+    // Prints the throughput of processing `bytes` of input in `seconds` as MB/s.
+    void ReportThroughput(std::string_view label, size_t bytes, double seconds);
+    // Prints an arbitrary value with its unit, for measurements that aren't throughputs.
+    void ReportValue(std::string_view label, double value, std::string_view unit);
+
+    // Reads the entire file at `path`, for instance a VT stream captured from a real application.
+    std::string LoadFile(const wchar_t* path);
+
+    // Writes `data` into a new pipe from a background thread in pieces of `writeSize` bytes,
+    // while `read` consumes the read end of the pipe on the calling thread.
+    void ReplayThroughPipe(std::string_view data, size_t writeSize, const std::function<void(HANDLE)>& read);
+}
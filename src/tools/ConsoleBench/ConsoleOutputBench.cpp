@@ -0,0 +1,77 @@
+// TEST TOOL ConsoleBench
+// Measures ReadConsoleOutputW and WriteConsoleOutputW through the public API of the console this benchmark runs in,
+// the way screen scrapers and TUI frameworks use them: Reading and writing back the entire screen over and over.
+// Run it in the conhost build you want to measure (for instance with and without a change to directio.cpp).
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr SHORT screenWidth = 120;
+    constexpr SHORT screenHeight = 30;
+
+    // Generates a screen of text in a handful of colors, like a file manager or an editor would display.
+    std::vector<CHAR_INFO> generateScreen()
+    {
+        constexpr std::array<WORD, 4> colors{
+            FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | BACKGROUND_BLUE,
+            FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY | BACKGROUND_BLUE,
+            FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY | BACKGROUND_BLUE,
+            BACKGROUND_RED | BACKGROUND_GREEN | BACKGROUND_BLUE,
+        };
+
+        const auto text = GenerateCorpus(Corpus::Ascii, screenWidth * screenHeight, false);
+        std::vector<CHAR_INFO> screen(text.size());
+
+        for (size_t i = 0; i < screen.size(); ++i)
+        {
+            auto& ci = til::at(screen, i);
+            ci.Char.UnicodeChar = til::at(text, i);
+            // Each row consists of a few columns, each in its own color.
+            ci.Attributes = til::at(colors, i % screenWidth / 30);
+        }
+
+        return screen;
+    }
+
+    void benchmarkConsoleOutput()
+    {
+        DWORD mode = 0;
+        if (!GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode))
+        {
+            fmt::print("  skipped: stdout isn't a console\n");
+            return;
+        }
+
+        const wil::unique_hfile output{ CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, CONSOLE_TEXTMODE_BUFFER, nullptr) };
+        THROW_LAST_ERROR_IF(!output || output.get() == INVALID_HANDLE_VALUE);
+
+        auto screen = generateScreen();
+        const COORD size{ screenWidth, screenHeight };
+        constexpr SMALL_RECT fullScreen{ 0, 0, screenWidth - 1, screenHeight - 1 };
+
+        const auto write = Measure([&]() {
+            auto rect = fullScreen;
+            THROW_IF_WIN32_BOOL_FALSE(WriteConsoleOutputW(output.get(), screen.data(), size, {}, &rect));
+        });
+        const auto read = Measure([&]() {
+            auto rect = fullScreen;
+            THROW_IF_WIN32_BOOL_FALSE(ReadConsoleOutputW(output.get(), screen.data(), size, {}, &rect));
+        });
+        const auto roundtrip = Measure([&]() {
+            auto rect = fullScreen;
+            THROW_IF_WIN32_BOOL_FALSE(ReadConsoleOutputW(output.get(), screen.data(), size, {}, &rect));
+            rect = fullScreen;
+            THROW_IF_WIN32_BOOL_FALSE(WriteConsoleOutputW(output.get(), screen.data(), size, {}, &rect));
+        });
+
+        ReportValue("120x30 WriteConsoleOutputW calls/s", 1.0 / write / 1e3, "k");
+        ReportValue("120x30 ReadConsoleOutputW calls/s", 1.0 / read / 1e3, "k");
+        ReportValue("120x30 read+write round trips/s", 1.0 / roundtrip / 1e3, "k");
+    }
+
+    const Registration registration{ "Output/ConsoleOutput", &benchmarkConsoleOutput };
+}
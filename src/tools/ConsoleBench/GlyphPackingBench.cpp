@@ -0,0 +1,159 @@
+// TEST TOOL ConsoleBench
+// Measures how well AtlasEngine's glyph atlas is packed, when the text is a mix of ASCII, CJK, emoji and
+// ligatures which span 1 to 4 cells each. It compares allocating each cell of a glyph as its own tile
+// (the way TileAllocator used to work) with allocating contiguous runs of tiles via til::shelf_packer.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include <til/lru_map.h>
+#include <til/shelf_packer.h>
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr size_t lookupCount = 1000000;
+    constexpr til::size tileSize{ 10, 20 };
+    // About 5000 tiles, which is less than the workload below needs to cache all of its glyphs.
+    constexpr til::size atlasSize{ 1024, 1024 };
+
+    struct GlyphClass
+    {
+        uint32_t first;
+        uint32_t count;
+        til::CoordType cellCount;
+        double weight;
+    };
+
+    // Glyph IDs are made up, but distinct between classes.
+    constexpr std::array glyphClasses{
+        GlyphClass{ 0, 95, 1, 60 }, // ASCII
+        GlyphClass{ 1000, 3000, 2, 25 }, // CJK
+        GlyphClass{ 10000, 1000, 2, 10 }, // Emoji
+        GlyphClass{ 20000, 40, 3, 3 }, // Ligatures like "===" or "-->"
+        GlyphClass{ 21000, 10, 4, 2 }, // Ligatures like "<!--"
+    };
+
+    struct Glyph
+    {
+        uint32_t id;
+        til::CoordType cellCount;
+    };
+
+    std::vector<Glyph> generateLookups()
+    {
+        std::mt19937 rng{ 1337 };
+        std::vector<double> weights;
+        for (const auto& c : glyphClasses)
+        {
+            weights.emplace_back(c.weight);
+        }
+        std::discrete_distribution<size_t> classDist{ weights.begin(), weights.end() };
+
+        std::vector<Glyph> lookups;
+        lookups.reserve(lookupCount);
+        for (size_t i = 0; i < lookupCount; ++i)
+        {
+            const auto& c = til::at(glyphClasses, classDist(rng));
+            lookups.push_back({ c.first + gsl::narrow_cast<uint32_t>(rng() % c.count), c.cellCount });
+        }
+        return lookups;
+    }
+
+    struct Stats
+    {
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t drawCalls = 0;
+        double occupancy = 0;
+    };
+
+    // A glyph cache in the style of AtlasEngine: On a miss the glyph is allocated in the atlas and drawn,
+    // evicting the least recently used glyphs until there's room for it.
+    Stats simulate(const std::vector<Glyph>& lookups, const bool runs)
+    {
+        til::shelf_packer packer{ atlasSize };
+        til::lru_map<uint32_t, std::vector<til::rect>> cache;
+        Stats stats;
+        double occupancySum = 0;
+
+        const auto evict = [&]() {
+            // TileHashMap::popOldestTiles() evicts up to 8 entries, but at most an 8th of all of them.
+            cache.pop_oldest(std::clamp<size_t>(cache.size() / 8, 1, 8), [&](auto& entry) {
+                for (const auto& rect : entry.second)
+                {
+                    packer.deallocate(rect);
+                }
+                ++stats.evictions;
+            });
+        };
+
+        // Allocates a run of `run` tiles. Like TileAllocator it evicts entries once
+        // and then settles for a shorter run if the atlas is still too fragmented.
+        const auto allocateRun = [&](til::CoordType& run) {
+            auto evicted = false;
+
+            for (;;)
+            {
+                const til::size size{ run * tileSize.width, tileSize.height };
+                if (const auto pos = packer.allocate(size))
+                {
+                    return til::rect{ *pos, size };
+                }
+                if (run > 1 && evicted)
+                {
+                    run = (run + 1) / 2;
+                    continue;
+                }
+                evict();
+                evicted = true;
+            }
+        };
+
+        for (const auto& glyph : lookups)
+        {
+            if (cache.find(glyph.id) != cache.end())
+            {
+                continue;
+            }
+
+            std::vector<til::rect> rects;
+            for (til::CoordType i = 0; i < glyph.cellCount;)
+            {
+                auto run = runs ? glyph.cellCount - i : 1;
+                rects.emplace_back(allocateRun(run));
+                i += run;
+            }
+
+            ++stats.misses;
+            stats.drawCalls += rects.size();
+            occupancySum += packer.occupancy();
+            cache.insert(uint32_t{ glyph.id }, std::move(rects));
+        }
+
+        stats.occupancy = occupancySum / static_cast<double>(std::max<size_t>(1, stats.misses));
+        return stats;
+    }
+
+    void benchmark(const std::string_view label, const std::vector<Glyph>& lookups, const bool runs)
+    {
+        const auto stats = simulate(lookups, runs);
+        ReportValue(fmt::format("{} hit rate", label), 100.0 - static_cast<double>(stats.misses) * 100.0 / static_cast<double>(lookups.size()), "%");
+        ReportValue(fmt::format("{} evictions", label), static_cast<double>(stats.evictions), "");
+        ReportValue(fmt::format("{} draw calls/glyph", label), static_cast<double>(stats.drawCalls) / static_cast<double>(stats.misses), "");
+        ReportValue(fmt::format("{} average occupancy", label), stats.occupancy * 100.0, "%");
+
+        const auto duration = Measure([&]() { simulate(lookups, runs); });
+        ReportValue(fmt::format("{} lookups/s", label), static_cast<double>(lookups.size()) / duration / 1e6, "M");
+    }
+
+    void benchmarkGlyphPacking()
+    {
+        const auto lookups = generateLookups();
+        benchmark("tiles", lookups, false);
+        benchmark("shelf runs", lookups, true);
+    }
+
+    const Registration registration{ "Atlas/GlyphPacking", &benchmarkGlyphPacking };
+}
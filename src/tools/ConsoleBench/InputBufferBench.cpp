@@ -0,0 +1,137 @@
+// TEST TOOL ConsoleBench
+// Measures the console's input buffer through the public API of the console this benchmark runs in:
+// * A 1M character paste, written as key down/up records in large batches and read back out.
+// * A flood of mouse move records, written one at a time, which the input buffer coalesces.
+// Run it in the conhost build you want to measure (for instance with and without a change to InputBuffer).
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr size_t pasteLength = 1024 * 1024;
+    constexpr size_t mouseMoveCount = 1024 * 1024;
+    // The terminal and the clipboard code write pastes in batches about this large.
+    constexpr size_t writeBatchSize = 4 * 1024;
+    constexpr size_t readBatchSize = 4 * 1024;
+
+    std::vector<INPUT_RECORD> generatePaste()
+    {
+        const auto text = GenerateCorpus(Corpus::Ascii, pasteLength, false);
+        std::vector<INPUT_RECORD> records;
+        records.reserve(text.size() * 2);
+
+        for (const auto wch : text)
+        {
+            INPUT_RECORD record{};
+            record.EventType = KEY_EVENT;
+            record.Event.KeyEvent.bKeyDown = TRUE;
+            record.Event.KeyEvent.wRepeatCount = 1;
+            record.Event.KeyEvent.uChar.UnicodeChar = wch;
+            records.push_back(record);
+            record.Event.KeyEvent.bKeyDown = FALSE;
+            records.push_back(record);
+        }
+
+        return records;
+    }
+
+    void writeAll(const HANDLE input, const std::vector<INPUT_RECORD>& records, const size_t batchSize)
+    {
+        for (size_t i = 0; i < records.size(); i += batchSize)
+        {
+            const auto count = gsl::narrow_cast<DWORD>(std::min(batchSize, records.size() - i));
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteConsoleInputW(input, records.data() + i, count, &written));
+        }
+    }
+
+    size_t readAll(const HANDLE input, std::vector<INPUT_RECORD>& buffer)
+    {
+        size_t total = 0;
+
+        for (;;)
+        {
+            DWORD available = 0;
+            THROW_IF_WIN32_BOOL_FALSE(GetNumberOfConsoleInputEvents(input, &available));
+            if (available == 0)
+            {
+                return total;
+            }
+
+            DWORD read = 0;
+            THROW_IF_WIN32_BOOL_FALSE(ReadConsoleInputW(input, buffer.data(), gsl::narrow_cast<DWORD>(buffer.size()), &read));
+            total += read;
+        }
+    }
+
+    void benchmarkPaste(const HANDLE input)
+    {
+        const auto records = generatePaste();
+        std::vector<INPUT_RECORD> buffer(readBatchSize);
+
+        const auto write = Measure([&]() {
+            writeAll(input, records, writeBatchSize);
+            THROW_IF_WIN32_BOOL_FALSE(FlushConsoleInputBuffer(input));
+        });
+        const auto roundtrip = Measure([&]() {
+            writeAll(input, records, writeBatchSize);
+            readAll(input, buffer);
+        });
+
+        const auto count = static_cast<double>(records.size());
+        ReportValue("1M char paste write records/s", count / write / 1e6, "M");
+        ReportValue("1M char paste write+read records/s", count / roundtrip / 1e6, "M");
+    }
+
+    void benchmarkMouseFlood(const HANDLE input)
+    {
+        std::vector<INPUT_RECORD> records(mouseMoveCount);
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            auto& record = til::at(records, i);
+            record.EventType = MOUSE_EVENT;
+            record.Event.MouseEvent.dwMousePosition = { gsl::narrow_cast<SHORT>(i % 120), gsl::narrow_cast<SHORT>(i / 120 % 30) };
+            record.Event.MouseEvent.dwEventFlags = MOUSE_MOVED;
+        }
+
+        std::vector<INPUT_RECORD> buffer(readBatchSize);
+        size_t stored = 0;
+
+        // Mouse moves are written one at a time, the way the window procedure forwards them.
+        const auto duration = Measure([&]() {
+            writeAll(input, records, 1);
+            stored = readAll(input, buffer);
+        });
+
+        ReportValue("mouse move flood records/s", static_cast<double>(records.size()) / duration / 1e6, "M");
+        ReportValue("mouse move flood records stored", static_cast<double>(stored), "");
+    }
+
+    void benchmarkInputBuffer()
+    {
+        const auto input = GetStdHandle(STD_INPUT_HANDLE);
+        DWORD mode = 0;
+        if (!GetConsoleMode(input, &mode))
+        {
+            fmt::print("  skipped: stdin isn't a console\n");
+            return;
+        }
+
+        // Neither translate the records into VT sequences nor let line input
+        // processing act on them. Mouse input must be enabled for mouse records.
+        THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(input, ENABLE_MOUSE_INPUT | ENABLE_EXTENDED_FLAGS));
+        const auto restore = wil::scope_exit([&]() {
+            FlushConsoleInputBuffer(input);
+            SetConsoleMode(input, mode);
+        });
+
+        THROW_IF_WIN32_BOOL_FALSE(FlushConsoleInputBuffer(input));
+        benchmarkPaste(input);
+        benchmarkMouseFlood(input);
+    }
+
+    const Registration registration{ "Input/Buffer", &benchmarkInputBuffer };
+}
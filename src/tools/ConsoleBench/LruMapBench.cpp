@@ -0,0 +1,161 @@
+// TEST TOOL ConsoleBench
+// Measures the glyph cache lookups AtlasEngine performs for every cell it paints.
+// It compares a LRU map built from a std::list and a std::unordered_set of its iterators
+// (the way AtlasEngine's TileHashMap used to work) with til::lru_map.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include <til/lru_map.h>
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr size_t lookupCount = 1000000;
+    // The number of distinct glyphs in the corpus and the number of glyphs that fit into the cache.
+    constexpr size_t glyphCount = 4096;
+    constexpr size_t cacheCapacity = 1024;
+
+    struct ListHasher
+    {
+        using is_transparent = int;
+        using iterator = std::list<std::pair<std::wstring, size_t>>::iterator;
+
+        size_t operator()(const std::wstring& v) const noexcept
+        {
+            return std::hash<std::wstring>{}(v);
+        }
+
+        size_t operator()(const iterator& v) const noexcept
+        {
+            return operator()(v->first);
+        }
+    };
+
+    struct ListEq
+    {
+        using is_transparent = int;
+        using iterator = ListHasher::iterator;
+
+        bool operator()(const std::wstring& a, const iterator& b) const noexcept
+        {
+            return a == b->first;
+        }
+
+        bool operator()(const iterator& a, const iterator& b) const noexcept
+        {
+            return operator()(a->first, b);
+        }
+    };
+
+    // Stands in for the old TileHashMap.
+    struct ListLru
+    {
+        bool lookup(const std::wstring& key)
+        {
+            const auto it = map.find(key);
+            if (it != map.end())
+            {
+                lru.splice(lru.begin(), lru, *it);
+                return true;
+            }
+
+            if (lru.size() == cacheCapacity)
+            {
+                map.erase(std::prev(lru.end()));
+                lru.pop_back();
+            }
+
+            lru.emplace_front(key, lru.size());
+            map.emplace(lru.begin());
+            return false;
+        }
+
+        std::list<std::pair<std::wstring, size_t>> lru;
+        std::unordered_set<ListHasher::iterator, ListHasher, ListEq> map;
+    };
+
+    struct TilLru
+    {
+        bool lookup(const std::wstring& key)
+        {
+            if (map.find(key) != map.end())
+            {
+                return true;
+            }
+
+            if (map.size() == cacheCapacity)
+            {
+                map.pop_oldest(1, [](auto&) {});
+            }
+
+            map.insert(std::wstring{ key }, map.size());
+            return false;
+        }
+
+        til::lru_map<std::wstring, size_t> map;
+    };
+
+    // Terminal output is dominated by a few glyphs (mostly ASCII), with a long tail
+    // of rarer ones, which is approximated by a Zipf-like distribution over `glyphCount` glyphs.
+    std::vector<std::wstring> generateLookups()
+    {
+        std::vector<std::wstring> glyphs;
+        glyphs.reserve(glyphCount);
+        for (size_t i = 0; i < glyphCount; ++i)
+        {
+            glyphs.emplace_back(1, static_cast<wchar_t>(0x20 + i));
+        }
+
+        std::vector<double> weights;
+        weights.reserve(glyphCount);
+        for (size_t i = 0; i < glyphCount; ++i)
+        {
+            weights.emplace_back(1.0 / static_cast<double>(i + 1));
+        }
+
+        std::mt19937 rng{ 1337 };
+        std::discrete_distribution<size_t> dist{ weights.begin(), weights.end() };
+        std::vector<std::wstring> lookups;
+        lookups.reserve(lookupCount);
+        for (size_t i = 0; i < lookupCount; ++i)
+        {
+            lookups.emplace_back(til::at(glyphs, dist(rng)));
+        }
+        return lookups;
+    }
+
+    template<typename Lru>
+    void benchmark(const std::string_view label, const std::vector<std::wstring>& lookups)
+    {
+        size_t hits = 0;
+        {
+            Lru lru;
+            for (const auto& key : lookups)
+            {
+                hits += lru.lookup(key);
+            }
+        }
+
+        const auto duration = Measure([&]() {
+            Lru lru;
+            for (const auto& key : lookups)
+            {
+                lru.lookup(key);
+            }
+        });
+
+        ReportValue(fmt::format("{} lookups/s", label), static_cast<double>(lookups.size()) / duration / 1e6, "M");
+        ReportValue(fmt::format("{} hit rate", label), static_cast<double>(hits) * 100.0 / static_cast<double>(lookups.size()), "%");
+    }
+
+    void benchmarkLruMap()
+    {
+        const auto lookups = generateLookups();
+        benchmark<ListLru>("std::list + std::unordered_set", lookups);
+        benchmark<TilLru>("til::lru_map", lookups);
+    }
+
+    const Registration registration{ "Til/LruMap", &benchmarkLruMap };
+}
@@ -0,0 +1,63 @@
+// TEST TOOL ConsoleBench
+// An IStateMachineEngine that does nothing except for counting what it's being given,
+// for benchmarks that want to measure the parser and not what it's dispatching to.
+
+#pragma once
+
+#include "../../terminal/parser/IStateMachineEngine.hpp"
+
+namespace ConsoleBench
+{
+    class NullEngine final : public Microsoft::Console::VirtualTerminal::IStateMachineEngine
+    {
+        using VTID = Microsoft::Console::VirtualTerminal::VTID;
+        using VTParameters = Microsoft::Console::VirtualTerminal::VTParameters;
+
+    public:
+        bool ActionExecute(const wchar_t) noexcept override
+        {
+            ++executed;
+            return true;
+        }
+        bool ActionExecuteFromEscape(const wchar_t) noexcept override { return true; }
+        bool ActionPrint(const wchar_t) noexcept override
+        {
+            ++printed;
+            return true;
+        }
+        bool ActionPrintString(const std::wstring_view string) noexcept override
+        {
+            printed += string.size();
+            return true;
+        }
+        bool ActionPassThroughString(const std::wstring_view, const bool) noexcept override { return true; }
+        bool ActionEscDispatch(const VTID) noexcept override { return true; }
+        bool ActionVt52EscDispatch(const VTID, const VTParameters) noexcept override { return true; }
+        bool ActionCsiDispatch(const VTID, const VTParameters) noexcept override
+        {
+            ++dispatched;
+            return true;
+        }
+        StringHandler ActionDcsDispatch(const VTID, const VTParameters) override
+        {
+            return [this](const std::wstring_view string) noexcept {
+                dataString += string.size();
+                return true;
+            };
+        }
+        bool ActionClear() noexcept override { return true; }
+        bool ActionIgnore() noexcept override { return true; }
+        bool ActionOscDispatch(const wchar_t, const size_t, const std::wstring_view string) noexcept override
+        {
+            dataString += string.size();
+            return true;
+        }
+        bool ActionSs3Dispatch(const wchar_t, const VTParameters) noexcept override { return true; }
+
+        size_t printed = 0;
+        size_t executed = 0;
+        size_t dispatched = 0;
+        // The total length of all DCS and OSC data strings.
+        size_t dataString = 0;
+    };
+}
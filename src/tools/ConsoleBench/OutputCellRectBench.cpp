@@ -0,0 +1,176 @@
+// TEST TOOL ConsoleBench
+// Measures copying rectangles out of and back into a TextBuffer, the way conhost saves and restores
+// the contents below a popup, and filling rectangles the way ScrollConsoleScreenBuffer backfills the area it scrolled.
+// It compares copying one OutputCell at a time (the way OutputCellRect used to work) with the packed OutputCellRect,
+// which stores ROWs and copies them with ROW::CopyTextFrom().
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../buffer/out/OutputCellRect.hpp"
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::Types;
+
+namespace
+{
+    constexpr til::size bufferSize{ 120, 9001 };
+    constexpr til::CoordType viewportHeight = 30;
+    // The command list popup covers most of the viewport.
+    constexpr til::CoordType popupWidth = 80;
+    constexpr til::CoordType popupHeight = 20;
+
+    void fillViewport(TextBuffer& buffer, const std::wstring_view text)
+    {
+        const std::array attributes{
+            TextAttribute{ FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE },
+            TextAttribute{ FOREGROUND_GREEN | FOREGROUND_INTENSITY },
+            TextAttribute{ FOREGROUND_RED | BACKGROUND_BLUE },
+        };
+
+        size_t offset = 0;
+        size_t piece = 0;
+        for (auto y = bufferSize.height - viewportHeight; y < bufferSize.height; ++y)
+        {
+            // Write each row in a few differently colored pieces.
+            for (til::CoordType x = 0; x < bufferSize.width && offset < text.size(); ++piece)
+            {
+                const auto chunk = text.substr(offset, 40);
+                RowWriteState state{
+                    .text = chunk,
+                    .columnBegin = x,
+                    .columnLimit = std::min(x + 40, bufferSize.width),
+                };
+                buffer.Write(y, til::at(attributes, piece % attributes.size()), state);
+                offset += chunk.size() - state.text.size();
+                x = state.columnEnd;
+            }
+        }
+    }
+
+    // Copies the rectangle one OutputCell at a time, which allocates if a cell's text doesn't fit into its small string.
+    std::vector<OutputCell> readPerCell(const TextBuffer& buffer, const Viewport& rect)
+    {
+        std::vector<OutputCell> cells;
+        cells.reserve(rect.Dimensions().area<size_t>());
+
+        for (auto y = rect.Top(); y < rect.BottomExclusive(); ++y)
+        {
+            auto it = buffer.GetCellLineDataAt({ rect.Left(), y });
+            for (auto x = 0; x < rect.Width() && it; ++x, ++it)
+            {
+                cells.emplace_back(*it);
+            }
+        }
+
+        return cells;
+    }
+
+    void writePerCell(TextBuffer& buffer, const std::vector<OutputCell>& cells, const Viewport& rect)
+    {
+        const auto width = gsl::narrow_cast<size_t>(rect.Width());
+        for (auto y = rect.Top(); y < rect.BottomExclusive(); ++y)
+        {
+            const auto offset = gsl::narrow_cast<size_t>(y - rect.Top()) * width;
+            const gsl::span<const OutputCell> row{ cells.data() + offset, width };
+            buffer.WriteLine(OutputCellIterator{ row }, { rect.Left(), y });
+        }
+    }
+
+    OutputCellRect readPacked(const TextBuffer& buffer, const Viewport& rect)
+    {
+        OutputCellRect result{ rect.Height(), rect.Width(), {} };
+
+        for (til::CoordType i = 0; i < rect.Height(); ++i)
+        {
+            const auto& source = buffer.GetRowByOffset(rect.Top() + i);
+            RowCopyTextFromState state{
+                .source = source,
+                .columnBegin = source.DbcsAttrAt(rect.Left()) == DbcsAttribute::Trailing ? 1 : 0,
+                .columnLimit = rect.Width(),
+                .sourceColumnBegin = rect.Left(),
+                .sourceColumnLimit = rect.RightExclusive(),
+            };
+            result.GetRow(i).CopyTextFrom(state);
+        }
+
+        return result;
+    }
+
+    void writePacked(TextBuffer& buffer, const OutputCellRect& data, const til::point origin)
+    {
+        for (til::CoordType i = 0; i < data.Height(); ++i)
+        {
+            const auto y = origin.Y + i;
+            auto& row = buffer.GetRowByOffset(y);
+            RowCopyTextFromState state{
+                .source = data.GetRow(i),
+                .columnBegin = origin.X,
+                .columnLimit = row.size(),
+                .sourceColumnBegin = 0,
+                .sourceColumnLimit = data.Width(),
+            };
+            row.CopyTextFrom(state);
+            buffer.TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, y, state.columnEndDirty, y + 1 }));
+        }
+    }
+
+    void fillPerCell(TextBuffer& buffer, const Viewport& rect, const OutputCellIterator& fill)
+    {
+        for (auto y = rect.Top(); y < rect.BottomExclusive(); ++y)
+        {
+            buffer.WriteLine(fill, { rect.Left(), y }, false, rect.RightInclusive());
+        }
+    }
+
+    void fillPacked(TextBuffer& buffer, const Viewport& rect, const OutputCellIterator& fill)
+    {
+        OutputCellRect fillRow{ 1, rect.Width(), {} };
+        fillRow.GetRow(0).WriteCells(fill, 0, false);
+        for (auto y = rect.Top(); y < rect.BottomExclusive(); ++y)
+        {
+            writePacked(buffer, fillRow, { rect.Left(), y });
+            buffer.GetRowByOffset(y).SetWrapForced(false);
+        }
+    }
+
+    void benchmarkOutputCellRect()
+    {
+        DummyRenderer renderer;
+        const auto viewportTop = bufferSize.height - viewportHeight;
+        const auto popup = Viewport::FromDimensions({ (bufferSize.width - popupWidth) / 2, viewportTop + (viewportHeight - popupHeight) / 2 }, { popupWidth, popupHeight });
+        const auto viewport = Viewport::FromDimensions({ 0, viewportTop }, { bufferSize.width, viewportHeight });
+        const OutputCellIterator fill{ L' ', TextAttribute{ BACKGROUND_BLUE } };
+
+        for (const auto corpus : AllCorpora)
+        {
+            TextBuffer buffer{ bufferSize, TextAttribute{}, 12, false, renderer };
+            fillViewport(buffer, GenerateCorpus(corpus, gsl::narrow_cast<size_t>(bufferSize.width * viewportHeight * 2), false));
+
+            const auto perCell = Measure([&]() {
+                const auto cells = readPerCell(buffer, popup);
+                writePerCell(buffer, cells, popup);
+            });
+            const auto packed = Measure([&]() {
+                const auto data = readPacked(buffer, popup);
+                writePacked(buffer, data, popup.Origin());
+            });
+
+            const auto name = CorpusName(corpus);
+            ReportValue(fmt::format("{} popup save/restore per cell", name), perCell * 1e6, "us");
+            ReportValue(fmt::format("{} popup save/restore packed", name), packed * 1e6, "us");
+            ReportValue(fmt::format("{} popup speedup", name), perCell / packed, "x");
+        }
+
+        TextBuffer buffer{ bufferSize, TextAttribute{}, 12, false, renderer };
+        const auto perCell = Measure([&]() { fillPerCell(buffer, viewport, fill); });
+        const auto packed = Measure([&]() { fillPacked(buffer, viewport, fill); });
+        ReportValue("viewport fill per cell", perCell * 1e6, "us");
+        ReportValue("viewport fill packed", packed * 1e6, "us");
+        ReportValue("viewport fill speedup", perCell / packed, "x");
+    }
+
+    const Registration registration{ "TextBuffer/OutputCellRect", &benchmarkOutputCellRect };
+}
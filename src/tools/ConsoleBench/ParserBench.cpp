@@ -0,0 +1,55 @@
+// TEST TOOL ConsoleBench
+// Measures the throughput of StateMachine::ProcessString, in particular for the ground state,
+// where printable runs of text are found and passed to the engine via ActionPrintString.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+#include "NullEngine.hpp"
+
+#include "../../terminal/parser/stateMachine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::VirtualTerminal;
+
+namespace
+{
+    constexpr size_t corpusLength = 16 * 1024 * 1024;
+
+    // Inserts an SGR sequence every `interval` characters, which is similar to colored compiler output.
+    std::wstring addSgr(const std::wstring_view text, const size_t interval)
+    {
+        std::wstring result;
+        result.reserve(text.size() + text.size() / interval * 12);
+
+        for (size_t i = 0; i < text.size(); i += interval)
+        {
+            result.append(text.substr(i, interval));
+            result.append(i / interval % 2 ? L"\x1b[m" : L"\x1b[1;31m");
+        }
+
+        return result;
+    }
+
+    void benchmark(const std::string_view label, const std::wstring_view text)
+    {
+        StateMachine machine{ std::make_unique<NullEngine>() };
+        const auto duration = Measure([&]() { machine.ProcessString(text); });
+        ReportThroughput(label, text.size() * sizeof(wchar_t), duration);
+        ReportValue(fmt::format("{} per char", label), duration * 1e9 / static_cast<double>(text.size()), "ns");
+    }
+
+    void benchmarkParserGround()
+    {
+        for (const auto corpus : AllCorpora)
+        {
+            // Without line feeds, the entire input is a single printable run.
+            benchmark(fmt::format("{} without line feeds", CorpusName(corpus)), GenerateCorpus(corpus, corpusLength, false));
+            benchmark(fmt::format("{} log", CorpusName(corpus)), GenerateCorpus(corpus, corpusLength));
+        }
+
+        benchmark("ASCII log with SGR every 16 chars", addSgr(GenerateCorpus(Corpus::Ascii, corpusLength), 16));
+        benchmark("ASCII log with SGR every 4 chars", addSgr(GenerateCorpus(Corpus::Ascii, corpusLength), 4));
+    }
+
+    const Registration registration{ "Parser/Ground", &benchmarkParserGround };
+}
@@ -0,0 +1,88 @@
+// TEST TOOL ConsoleBench
+// Measures the throughput of StateMachine::ProcessString for long DCS and OSC data strings,
+// like soft fonts (DECDLD) or clipboard contents (OSC 52), which are passed on to the engine in bulk.
+// For comparison, the same input is also fed through ProcessCharacter() one character at a time,
+// which is how these strings used to be handled.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+#include "NullEngine.hpp"
+
+#include "../../terminal/parser/stateMachine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::VirtualTerminal;
+
+namespace
+{
+    constexpr size_t payloadLength = 4 * 1024 * 1024;
+    // ConPTY passes its output to the parser in fragments about this large.
+    constexpr size_t fragmentSize = 4 * 1024;
+
+    // A DECDLD sequence with sixel data: "?" to "~" encode the pixels, "/" and ";" separate the rows and glyphs.
+    std::wstring generateSoftFont(const size_t length)
+    {
+        std::mt19937_64 rng{ 0x5eed };
+        std::wstring text{ L"\x1bP1;1;1;10;0;2;20;0{ @" };
+        text.reserve(text.size() + length + 2);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            const auto n = rng() % 80;
+            text.push_back(n == 0 ? L';' : n == 1 ? L'/' : static_cast<wchar_t>(L'?' + n % 64));
+        }
+
+        text.append(L"\x1b\\");
+        return text;
+    }
+
+    // An OSC 52 sequence with base64 encoded clipboard contents.
+    std::wstring generateClipboard(const size_t length)
+    {
+        static constexpr std::wstring_view alphabet{ L"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+        std::mt19937_64 rng{ 0x5eed };
+        std::wstring text{ L"\x1b]52;c;" };
+        text.reserve(text.size() + length + 1);
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            text.push_back(alphabet[rng() % alphabet.size()]);
+        }
+
+        text.push_back(L'\a');
+        return text;
+    }
+
+    void benchmark(const std::string_view label, const std::wstring_view text)
+    {
+        StateMachine machine{ std::make_unique<NullEngine>() };
+        const auto bytes = text.size() * sizeof(wchar_t);
+
+        const auto whole = Measure([&]() { machine.ProcessString(text); });
+        const auto fragmented = Measure([&]() {
+            for (size_t i = 0; i < text.size(); i += fragmentSize)
+            {
+                machine.ProcessString(text.substr(i, fragmentSize));
+            }
+        });
+        const auto perChar = Measure([&]() {
+            for (const auto wch : text)
+            {
+                machine.ProcessCharacter(wch);
+            }
+        });
+
+        ReportThroughput(fmt::format("{} bulk", label), bytes, whole);
+        ReportThroughput(fmt::format("{} bulk in 4 KiB fragments", label), bytes, fragmented);
+        ReportThroughput(fmt::format("{} per char", label), bytes, perChar);
+        ReportValue(fmt::format("{} speedup", label), perChar / fragmented, "x");
+    }
+
+    void benchmarkParserDataStrings()
+    {
+        benchmark("DECDLD soft font", generateSoftFont(payloadLength));
+        benchmark("OSC 52 clipboard", generateClipboard(payloadLength));
+    }
+
+    const Registration registration{ "Parser/DataStrings", &benchmarkParserDataStrings };
+}
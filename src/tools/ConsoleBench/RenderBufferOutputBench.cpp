@@ -0,0 +1,140 @@
+// TEST TOOL ConsoleBench
+// Measures how fast the renderer can turn a full screen of colorful text into runs of clusters,
+// which is what Renderer::_PaintBufferOutputHelper() does for every dirty row of every frame.
+// It compares reading the rows cell by cell via TextBufferCellIterator (one OutputCellView per column)
+// with reading them a run at a time via ROW::GetSlice(), which is what the renderer does now.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr til::CoordType screenWidth = 120;
+    constexpr til::CoordType screenHeight = 30;
+    constexpr size_t frames = 10000;
+    // Every this many columns the text changes its color, like the output of a colorful prompt or `ls`.
+    constexpr til::CoordType runLength = 6;
+
+    struct Counts
+    {
+        size_t clusters = 0;
+        size_t runs = 0;
+    };
+
+    // Fills the screen with the lines in `text`, changing the foreground color every few columns.
+    void fill(TextBuffer& buffer, const std::wstring_view text)
+    {
+        size_t beg = 0;
+
+        for (til::CoordType y = 0; y < screenHeight; ++y)
+        {
+            const auto end = std::min(text.find(L'\n', beg), text.size());
+            RowWriteState state;
+            state.text = text.substr(beg, end - beg);
+
+            for (til::CoordType x = 0; x < screenWidth && !state.text.empty(); x = state.columnLimit)
+            {
+                TextAttribute attributes;
+                attributes.SetIndexedForeground(gsl::narrow_cast<BYTE>(x / runLength % 16));
+                state.columnBegin = x;
+                state.columnLimit = std::min(x + runLength, screenWidth);
+                buffer.Write(y, attributes, state);
+            }
+
+            beg = end + 1 < text.size() ? end + 1 : 0;
+        }
+    }
+
+    // Groups the clusters of a row into runs of identical attributes the way the renderer used to.
+    void readCells(const TextBuffer& buffer, const til::CoordType y, std::vector<std::pair<std::wstring_view, til::CoordType>>& clusters, Counts& counts)
+    {
+        auto it = buffer.GetCellLineDataAt({ 0, y });
+        auto color = it->TextAttr();
+
+        while (it)
+        {
+            clusters.clear();
+
+            do
+            {
+                if (color != it->TextAttr())
+                {
+                    color = it->TextAttr();
+                    break;
+                }
+
+                const auto columnCount = std::max<til::CoordType>(it->Columns(), 1);
+                clusters.emplace_back(it->Chars(), columnCount);
+                it += columnCount;
+            } while (it);
+
+            counts.clusters += clusters.size();
+            ++counts.runs;
+        }
+    }
+
+    // Groups the clusters of a row into runs of identical attributes the way the renderer does now.
+    void readSlice(const TextBuffer& buffer, const til::CoordType y, std::vector<std::pair<std::wstring_view, til::CoordType>>& clusters, Counts& counts)
+    {
+        const auto slice = buffer.GetRowByOffset(y).GetSlice(0, screenWidth);
+        auto column = slice.ColumnBegin();
+
+        for (const auto& run : slice.Attributes().runs())
+        {
+            const auto runEnd = column + run.length;
+            clusters.clear();
+
+            while (column < runEnd)
+            {
+                til::CoordType columns = 0;
+                const auto glyph = slice.GlyphAt(column, columns);
+                clusters.emplace_back(glyph, columns);
+                column += columns;
+            }
+
+            counts.clusters += clusters.size();
+            ++counts.runs;
+        }
+    }
+
+    template<typename T>
+    void benchmark(const std::string_view label, const TextBuffer& buffer, T read)
+    {
+        std::vector<std::pair<std::wstring_view, til::CoordType>> clusters;
+        Counts counts;
+
+        const auto duration = Measure([&]() {
+            for (size_t i = 0; i < frames; ++i)
+            {
+                for (til::CoordType y = 0; y < screenHeight; ++y)
+                {
+                    read(buffer, y, clusters, counts);
+                }
+            }
+        });
+
+        ReportValue(fmt::format("{} frames/s", label), frames / duration / 1e3, "k");
+        ReportValue(fmt::format("{} runs per frame", label), static_cast<double>(counts.runs) / frames, "");
+    }
+
+    void benchmarkRenderBufferOutput()
+    {
+        DummyRenderer renderer;
+
+        for (const auto corpus : AllCorpora)
+        {
+            TextBuffer buffer{ { screenWidth, screenHeight }, TextAttribute{}, 12, false, renderer };
+            fill(buffer, GenerateCorpus(corpus, 64 * 1024));
+
+            benchmark(fmt::format("{} per cell", CorpusName(corpus)), buffer, &readCells);
+            benchmark(fmt::format("{} per run", CorpusName(corpus)), buffer, &readSlice);
+        }
+    }
+
+    const Registration registration{ "Render/BufferOutput", &benchmarkRenderBufferOutput };
+}
@@ -0,0 +1,98 @@
+// TEST TOOL ConsoleBench
+// Measures how fast the colors of a frame full of 24-bit color cells are resolved with
+// "always distinguishable colors" enabled. The frame is a heatmap in which every cell has its own
+// foreground/background pair, like the output of a true color test script or a profiler's flame graph.
+// It compares adjusting every cell with ColorFix directly (the way RenderSettings used to work) with the
+// memoized RenderSettings::GetAttributeColors(), called once per cell and once per row.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../renderer/inc/RenderSettings.hpp"
+#include "../../types/inc/ColorFix.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::Render;
+
+namespace
+{
+    constexpr til::CoordType frameWidth = 120;
+    constexpr til::CoordType frameHeight = 30;
+
+    std::vector<TextAttribute> generateHeatmap()
+    {
+        std::vector<TextAttribute> attrs;
+        attrs.reserve(frameWidth * frameHeight);
+
+        for (til::CoordType y = 0; y < frameHeight; ++y)
+        {
+            for (til::CoordType x = 0; x < frameWidth; ++x)
+            {
+                const auto r = gsl::narrow_cast<BYTE>(x * 255 / frameWidth);
+                const auto g = gsl::narrow_cast<BYTE>(y * 255 / frameHeight);
+
+                TextAttribute attr;
+                attr.SetForeground(RGB(r, g, 128));
+                attr.SetBackground(RGB(r, g, 140));
+                attrs.emplace_back(attr);
+            }
+        }
+
+        return attrs;
+    }
+
+    void benchmarkRenderSettings()
+    {
+        if (!Feature_AdjustIndistinguishableText::IsEnabled())
+        {
+            fmt::print("  skipped: Feature_AdjustIndistinguishableText is disabled\n");
+            return;
+        }
+
+        const auto attrs = generateHeatmap();
+        const auto cells = static_cast<double>(attrs.size());
+
+        RenderSettings renderSettings;
+        renderSettings.SetRenderMode(RenderSettings::Mode::AlwaysDistinguishableColors, true);
+
+        std::vector<std::pair<COLORREF, COLORREF>> colors(attrs.size());
+        const auto uncached = Measure([&]() {
+            for (size_t i = 0; i < attrs.size(); ++i)
+            {
+                const auto fg = attrs[i].GetForeground().GetRGB();
+                const auto bg = attrs[i].GetBackground().GetRGB();
+                colors[i] = { ColorFix::GetPerceivableColor(fg, bg), bg };
+            }
+        });
+        const auto perCell = Measure([&]() {
+            for (size_t i = 0; i < attrs.size(); ++i)
+            {
+                colors[i] = renderSettings.GetAttributeColors(attrs[i]);
+            }
+        });
+        const auto perRow = Measure([&]() {
+            for (size_t i = 0; i < attrs.size(); i += frameWidth)
+            {
+                renderSettings.GetAttributeColors(gsl::make_span(attrs).subspan(i, frameWidth), gsl::make_span(colors).subspan(i, frameWidth));
+            }
+        });
+
+        // The first frame after a color scheme change starts with an empty cache.
+        const auto coldFrame = Measure([&]() {
+            renderSettings.MakeAdjustedColorArray();
+            for (size_t i = 0; i < attrs.size(); i += frameWidth)
+            {
+                renderSettings.GetAttributeColors(gsl::make_span(attrs).subspan(i, frameWidth), gsl::make_span(colors).subspan(i, frameWidth));
+            }
+        });
+
+        ReportValue("uncached frame", uncached * 1e3, "ms");
+        ReportValue("cached frame, per cell", perCell * 1e3, "ms");
+        ReportValue("cached frame, per row", perRow * 1e3, "ms");
+        ReportValue("cold frame, per row", coldFrame * 1e3, "ms");
+        ReportValue("cached cells/s", cells / perCell / 1e6, "M");
+        ReportValue("speedup", uncached / perCell, "x");
+    }
+
+    const Registration registration{ "Render/PerceivableColors", &benchmarkRenderSettings };
+}
@@ -0,0 +1,95 @@
+// TEST TOOL ConsoleBench
+// Reports how much memory an idle pane commits: A TextBuffer with a 9001 row history,
+// of which only the first screenful of rows was ever written to. For comparison it also
+// reports the cost of a pane whose rows were all committed, which is what every new
+// TextBuffer used to cost before its backing store got committed lazily, and the cost
+// of a pane whose entire history is filled with shell output, most of which is cold
+// and thus compressed.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include <psapi.h>
+
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr til::size bufferSize{ 120, 9001 };
+    constexpr til::CoordType viewportHeight = 30;
+    constexpr size_t paneCount = 32;
+
+    double privateBytes() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS_EX counters{};
+        counters.cb = sizeof(counters);
+        GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters));
+        return static_cast<double>(counters.PrivateUsage);
+    }
+
+    // Creates paneCount buffers, calls `touch` on each and reports the average memory per pane.
+    template<typename Func>
+    void reportPanes(const std::string_view label, DummyRenderer& renderer, Func&& touch)
+    {
+        std::vector<std::unique_ptr<TextBuffer>> panes;
+        panes.reserve(paneCount);
+
+        size_t backingStore = 0;
+        const auto before = privateBytes();
+
+        for (size_t i = 0; i < paneCount; ++i)
+        {
+            auto& buffer = *panes.emplace_back(std::make_unique<TextBuffer>(bufferSize, TextAttribute{}, 12, false, renderer));
+            touch(buffer);
+            backingStore += buffer.GetCommittedBytes();
+        }
+
+        const auto after = privateBytes();
+        ReportValue(fmt::format("{} backing store", label), static_cast<double>(backingStore) / paneCount / 1024.0, "KiB/pane");
+        ReportValue(fmt::format("{} private bytes", label), (after - before) / paneCount / 1024.0, "KiB/pane");
+    }
+
+    void benchmarkTextBufferMemory()
+    {
+        DummyRenderer renderer;
+        const auto line = GenerateCorpus(Corpus::Ascii, 80, false);
+
+        // A shell printed a screenful of output and now waits for input.
+        reportPanes("idle", renderer, [&](TextBuffer& buffer) {
+            for (til::CoordType y = 0; y < viewportHeight; ++y)
+            {
+                RowWriteState state;
+                state.text = line;
+                state.columnLimit = bufferSize.width;
+                buffer.Write(y, buffer.GetCurrentAttributes(), state);
+            }
+        });
+
+        // Committing rows without moving the cursor keeps them from getting compressed.
+        reportPanes("fully committed", renderer, [&](TextBuffer& buffer) {
+            for (til::CoordType y = 0; y < bufferSize.height; ++y)
+            {
+                buffer.GetRowByOffset(y);
+            }
+        });
+
+        // A shell printed 9001 lines of output, like a build log.
+        reportPanes("full history", renderer, [&](TextBuffer& buffer) {
+            for (til::CoordType y = 0; y < bufferSize.height; ++y)
+            {
+                RowWriteState state;
+                state.text = line;
+                state.columnLimit = bufferSize.width;
+                buffer.GetCursor().SetYPosition(y);
+                buffer.Write(y, buffer.GetCurrentAttributes(), state);
+                // Terminal::Write() does this after every chunk of output.
+                buffer.CompressColdRows();
+            }
+        });
+    }
+
+    const Registration registration{ "TextBuffer/Memory", &benchmarkTextBufferMemory };
+}
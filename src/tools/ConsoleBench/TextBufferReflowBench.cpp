@@ -0,0 +1,81 @@
+// TEST TOOL ConsoleBench
+// Measures how long it takes to reflow a TextBuffer whose entire 32k row history is filled with
+// shell output, the way it happens when a maximized window gets restored and maximized again.
+// TextBuffer::Reflow() copies the rows one run of glyphs and attributes at a time (ROW::CopyTextFrom),
+// so the duration should scale with the number of rows rather than with the number of columns.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr til::CoordType bufferHeight = 32767;
+    constexpr til::CoordType wideWidth = 120;
+    constexpr til::CoordType narrowWidth = 80;
+
+    // Fills every row of the buffer with the lines in `text`, wrapping those that don't fit.
+    void fill(TextBuffer& buffer, const std::wstring_view text)
+    {
+        const auto attributes = buffer.GetCurrentAttributes();
+        const auto width = buffer.GetSize().Width();
+        til::CoordType y = 0;
+
+        for (size_t beg = 0; y < bufferHeight;)
+        {
+            const auto end = std::min(text.find(L'\n', beg), text.size());
+
+            RowWriteState state;
+            state.text = text.substr(beg, end - beg);
+
+            do
+            {
+                state.columnBegin = 0;
+                state.columnLimit = width;
+                buffer.Write(y, attributes, state);
+                buffer.GetRowByOffset(y).SetWrapForced(!state.text.empty());
+                ++y;
+            } while (!state.text.empty() && y < bufferHeight);
+
+            // Start over once we run out of text.
+            beg = end + 1 < text.size() ? end + 1 : 0;
+        }
+
+        buffer.GetCursor().SetPosition({ 0, bufferHeight - 1 });
+    }
+
+    void benchmark(const std::string_view label, DummyRenderer& renderer, TextBuffer& source, const til::CoordType width)
+    {
+        const auto duration = Measure([&]() {
+            TextBuffer target{ { width, bufferHeight }, TextAttribute{}, 12, false, renderer };
+            THROW_IF_FAILED(TextBuffer::Reflow(source, target, std::nullopt, std::nullopt));
+        });
+
+        ReportValue(label, duration * 1e3, "ms");
+        ReportValue(fmt::format("{} rows/s", label), bufferHeight / duration / 1e6, "M");
+    }
+
+    void benchmarkTextBufferReflow()
+    {
+        DummyRenderer renderer;
+
+        for (const auto corpus : AllCorpora)
+        {
+            const auto text = GenerateCorpus(corpus, 4 * 1024 * 1024);
+            TextBuffer wide{ { wideWidth, bufferHeight }, TextAttribute{}, 12, false, renderer };
+            fill(wide, text);
+
+            TextBuffer narrow{ { narrowWidth, bufferHeight }, TextAttribute{}, 12, false, renderer };
+            THROW_IF_FAILED(TextBuffer::Reflow(wide, narrow, std::nullopt, std::nullopt));
+
+            benchmark(fmt::format("{} {} -> {} columns", CorpusName(corpus), wideWidth, narrowWidth), renderer, wide, narrowWidth);
+            benchmark(fmt::format("{} {} -> {} columns", CorpusName(corpus), narrowWidth, wideWidth), renderer, narrow, wideWidth);
+        }
+    }
+
+    const Registration registration{ "TextBuffer/Reflow", &benchmarkTextBufferReflow };
+}
@@ -0,0 +1,94 @@
+// TEST TOOL ConsoleBench
+// Compares finding all instances of a search term in a full TextBuffer cell by cell
+// (the way Search::FindNext() used to work) with the line-based Search::s_FindAll().
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../buffer/out/search.h"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr til::size bufferSize{ 120, 30000 };
+
+    // Finds all instances of an ASCII needle by comparing it against the buffer one cell at a time,
+    // like Search::FindNext() used to do via _FindNeedleInHaystackAt() for each position.
+    size_t findAllPerCell(const TextBuffer& buffer, const std::wstring_view needle, const til::point end)
+    {
+        const auto size = buffer.GetSize();
+        size_t count = 0;
+        til::point pos;
+
+        do
+        {
+            auto bufferPos = pos;
+            auto found = true;
+
+            for (const auto ch : needle)
+            {
+                const auto hay = *buffer.GetTextDataAt(bufferPos);
+                if (hay.size() != 1 || ::towlower(hay.front()) != ::towlower(ch))
+                {
+                    found = false;
+                    break;
+                }
+                size.IncrementInBoundsCircular(bufferPos);
+            }
+
+            count += found;
+            size.IncrementInBoundsCircular(pos);
+        } while (pos <= end && pos != til::point{});
+
+        return count;
+    }
+
+    void benchmarkTextBufferSearch()
+    {
+        DummyRenderer renderer;
+        TextBuffer buffer{ bufferSize, TextAttribute{}, 12, false, renderer };
+
+        const auto text = GenerateCorpus(Corpus::Ascii, bufferSize.area<size_t>(), false);
+        for (til::CoordType y = 0; y < bufferSize.height; ++y)
+        {
+            RowWriteState state;
+            state.text = std::wstring_view{ text }.substr(gsl::narrow_cast<size_t>(y) * bufferSize.width, bufferSize.width);
+            state.columnLimit = bufferSize.width;
+            buffer.GetCursor().SetYPosition(y);
+            buffer.Write(y, buffer.GetCurrentAttributes(), state);
+            buffer.GetRowByOffset(y).SetWrapForced(true);
+        }
+
+        const til::point end{ bufferSize.width - 1, bufferSize.height - 1 };
+        const auto bytes = text.size() * sizeof(wchar_t);
+
+        // A rare search term and a common one, which produces tens of thousands of matches.
+        const std::array<std::pair<std::string_view, std::wstring>, 2> needles{ {
+            { "rare", text.substr(123456, 8) },
+            { "common", text.substr(654321, 1) },
+        } };
+
+        for (const auto& [label, term] : needles)
+        {
+            const std::wstring_view needle{ term };
+            size_t perCellCount = 0;
+            size_t findAllCount = 0;
+
+            const auto perCell = Measure([&]() {
+                perCellCount = findAllPerCell(buffer, needle, end);
+            });
+            const auto findAll = Measure([&]() {
+                findAllCount = Search::s_FindAll(buffer, needle, Search::Sensitivity::CaseInsensitive, Search::Mode::PlainText, end).size();
+            });
+
+            ReportThroughput(fmt::format("{} term per cell", label), bytes, perCell);
+            ReportThroughput(fmt::format("{} term s_FindAll", label), bytes, findAll);
+            ReportValue(fmt::format("{} term speedup", label), perCell / findAll, "x");
+            ReportValue(fmt::format("{} term matches", label), static_cast<double>(findAllCount), fmt::format("(per cell: {})", perCellCount));
+        }
+    }
+
+    const Registration registration{ "TextBuffer/Search", &benchmarkTextBufferSearch };
+}
@@ -0,0 +1,113 @@
+// TEST TOOL ConsoleBench
+// Compares printing text into a TextBuffer one OutputCellIterator at a time
+// (the way Terminal::_WriteBuffer used to work) with the bulk ROW::ReplaceText path.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+#include "../../buffer/out/textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr til::size bufferSize{ 120, 9001 };
+    constexpr size_t corpusLength = 4 * 1024 * 1024;
+
+    // Writes one UTF-16 code unit (or surrogate pair) per TextBuffer::Write() call.
+    void writePerCodeUnit(TextBuffer& buffer, const std::wstring_view text)
+    {
+        auto& cursor = buffer.GetCursor();
+        const auto attributes = buffer.GetCurrentAttributes();
+
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            const auto wch = text[i];
+            if (wch == L'\n')
+            {
+                buffer.NewlineCursor();
+                continue;
+            }
+
+            const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
+            const auto view = text.substr(i, isSurrogate ? 2 : 1);
+            const OutputCellIterator it{ view, attributes };
+            const auto end = buffer.Write(it);
+            const auto inputDistance = end.GetInputDistance(it);
+
+            if (inputDistance > 0)
+            {
+                cursor.IncrementXPosition(end.GetCellDistance(it));
+                i += gsl::narrow_cast<size_t>(inputDistance - 1);
+            }
+            else
+            {
+                // The glyph didn't fit into the remainder of the row. Retry on the next one.
+                buffer.NewlineCursor();
+                i--;
+            }
+        }
+    }
+
+    // Writes as much text per TextBuffer::Write() call as fits into the current row.
+    void writeBulk(TextBuffer& buffer, const std::wstring_view text)
+    {
+        auto& cursor = buffer.GetCursor();
+        const auto attributes = buffer.GetCurrentAttributes();
+
+        for (size_t beg = 0; beg < text.size();)
+        {
+            const auto end = std::min(text.find(L'\n', beg), text.size());
+
+            RowWriteState state;
+            state.text = text.substr(beg, end - beg);
+
+            while (!state.text.empty())
+            {
+                const auto position = cursor.GetPosition();
+                state.columnBegin = position.X;
+                state.columnLimit = buffer.GetLineWidth(position.Y);
+                buffer.Write(position.Y, attributes, state);
+                cursor.SetXPosition(state.columnEnd);
+
+                if (state.columnEnd >= state.columnLimit)
+                {
+                    buffer.GetRowByOffset(position.Y).SetWrapForced(true);
+                    if (!state.text.empty())
+                    {
+                        buffer.NewlineCursor();
+                    }
+                }
+            }
+
+            if (end != text.size())
+            {
+                buffer.NewlineCursor();
+            }
+
+            beg = end + 1;
+        }
+    }
+
+    void benchmarkTextBufferWrite()
+    {
+        DummyRenderer renderer;
+
+        for (const auto corpus : AllCorpora)
+        {
+            const auto text = GenerateCorpus(corpus, corpusLength);
+            const auto bytes = text.size() * sizeof(wchar_t);
+            TextBuffer buffer{ bufferSize, TextAttribute{}, 12, false, renderer };
+
+            const auto perCodeUnit = Measure([&]() { writePerCodeUnit(buffer, text); });
+            const auto bulk = Measure([&]() { writeBulk(buffer, text); });
+
+            ReportThroughput(fmt::format("{} per code unit", CorpusName(corpus)), bytes, perCodeUnit);
+            ReportThroughput(fmt::format("{} bulk", CorpusName(corpus)), bytes, bulk);
+            ReportValue(fmt::format("{} speedup", CorpusName(corpus)), perCodeUnit / bulk, "x");
+        }
+    }
+
+    const Registration registration{ "TextBuffer/Write", &benchmarkTextBufferWrite };
+}
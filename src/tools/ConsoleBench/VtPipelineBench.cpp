@@ -0,0 +1,451 @@
+// TEST TOOL ConsoleBench
+// Measures how fast VT output makes it from the parser into a TextBuffer: StateMachine, OutputStateMachineEngine,
+// AdaptDispatch and finally the TextBuffer of a headless terminal, whose renderer has no engines attached.
+// Every stream is run through 3 stages, each of which includes the previous ones:
+// * parse: StateMachine with an engine that discards everything.
+// * dispatch: The full pipeline, but printable text is discarded before it's written into the TextBuffer.
+// * buffer: The full pipeline.
+// To replay a captured stream (for instance the raw output of a ConPTY session) in addition
+// to the generated ones, point the CONSOLEBENCH_VT_CAPTURE environment variable at it.
+//
+// If the CONSOLEBENCH_VT_BASELINE environment variable points to a file, the ns/char of each stream and stage are
+// compared with it and the benchmark fails if any of them got slower by more than `regressionTolerance`.
+// If the file doesn't exist yet, it's created from the results of this run.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+#include "NullEngine.hpp"
+
+#include "../../renderer/inc/DummyRenderer.hpp"
+#include "../../terminal/adapter/adaptDispatch.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../terminal/parser/stateMachine.hpp"
+
+using namespace ConsoleBench;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+using namespace Microsoft::Console::VirtualTerminal;
+
+namespace
+{
+    constexpr size_t streamLength = 4 * 1024 * 1024;
+    constexpr til::CoordType viewportWidth = 120;
+    constexpr til::CoordType viewportHeight = 30;
+    constexpr til::CoordType historySize = 9001;
+    // A stream and stage regressed if its ns/char exceed the baseline by more than this factor.
+    constexpr double regressionTolerance = 1.2;
+
+    class HeadlessTerminal;
+
+    // The Renderer asks this for the buffer and viewport whenever a part of the buffer gets invalidated.
+    class HeadlessRenderData final : public IRenderData
+    {
+    public:
+        explicit HeadlessRenderData(const HeadlessTerminal& terminal) noexcept :
+            _terminal{ terminal } {}
+
+        Viewport GetViewport() noexcept override;
+        til::point GetTextBufferEndPosition() const noexcept override { return {}; }
+        const TextBuffer& GetTextBuffer() const noexcept override;
+        const FontInfo& GetFontInfo() const noexcept override { FAIL_FAST_HR(E_NOTIMPL); }
+        std::vector<Viewport> GetSelectionRects() noexcept override { return {}; }
+        void LockConsole() noexcept override {}
+        void UnlockConsole() noexcept override {}
+
+        til::point GetCursorPosition() const noexcept override;
+        bool IsCursorVisible() const noexcept override { return false; }
+        bool IsCursorOn() const noexcept override { return false; }
+        ULONG GetCursorHeight() const noexcept override { return 12; }
+        CursorType GetCursorStyle() const noexcept override { return CursorType::Legacy; }
+        ULONG GetCursorPixelWidth() const noexcept override { return 1; }
+        bool IsCursorDoubleWidth() const noexcept override { return false; }
+        const std::vector<RenderOverlay> GetOverlays() const noexcept override { return {}; }
+        const bool IsGridLineDrawingAllowed() noexcept override { return false; }
+        const std::wstring_view GetConsoleTitle() const noexcept override { return {}; }
+        const std::wstring GetHyperlinkUri(uint16_t) const override { return {}; }
+        const std::wstring GetHyperlinkCustomId(uint16_t) const override { return {}; }
+        const std::vector<size_t> GetPatternId(const til::point) const override { return {}; }
+
+    private:
+        const HeadlessTerminal& _terminal;
+    };
+
+    // A terminal without a window: It writes text the way Terminal::_WriteBuffer does
+    // and implements line feeds, including those within the scrolling region.
+    // The alternate screen buffer isn't supported and applications keep drawing into the main one.
+    class HeadlessTerminal final : public ITerminalApi
+    {
+    public:
+        explicit HeadlessTerminal(const bool discardText) :
+            _buffer{ { viewportWidth, viewportHeight + historySize }, TextAttribute{}, 12, true, _renderer },
+            _discardText{ discardText }
+        {
+        }
+
+        Renderer& GetRenderer() noexcept { return _renderer; }
+        RenderSettings& GetRenderSettings() noexcept { return _renderer._renderSettings; }
+        const TextBuffer& GetBuffer() const noexcept { return _buffer; }
+        Viewport GetView() const noexcept { return Viewport::FromDimensions({ 0, _viewportTop }, { viewportWidth, viewportHeight }); }
+        void SetStateMachine(StateMachine& machine) noexcept { _machine = &machine; }
+
+        void PrintString(const std::wstring_view string) override
+        {
+            if (_discardText)
+            {
+                return;
+            }
+
+            auto& cursor = _buffer.GetCursor();
+            const auto attributes = _buffer.GetCurrentAttributes();
+
+            RowWriteState state;
+            state.text = string;
+
+            while (!state.text.empty())
+            {
+                auto position = cursor.GetPosition();
+                state.columnBegin = position.x;
+                state.columnLimit = _buffer.GetLineWidth(position.y);
+                _buffer.Write(position.y, attributes, state);
+                position.x = state.columnEnd;
+
+                if (state.columnEnd >= state.columnLimit)
+                {
+                    _buffer.GetRowByOffset(position.y).SetWrapForced(true);
+                    if (!state.text.empty())
+                    {
+                        _cursorDown({ 0, position.y + 1 });
+                        continue;
+                    }
+                }
+
+                cursor.SetPosition(position);
+            }
+        }
+
+        void ReturnResponse(const std::wstring_view) override {}
+        StateMachine& GetStateMachine() override { return *_machine; }
+        TextBuffer& GetTextBuffer() override { return _buffer; }
+        til::rect GetViewport() const override { return til::rect{ 0, _viewportTop, viewportWidth, _viewportTop + viewportHeight }; }
+        void SetViewportPosition(const til::point position) override { _viewportTop = position.y; }
+        bool IsVtInputEnabled() const override { return false; }
+        void SetTextAttributes(const TextAttribute& attrs) override { _buffer.SetCurrentAttributes(attrs); }
+        void SetAutoWrapMode(const bool) override {}
+        void SetScrollingRegion(const til::inclusive_rect& scrollMargins) override { _margins = scrollMargins; }
+        void WarningBell() override {}
+        bool GetLineFeedMode() const override { return false; }
+
+        void LineFeed(const bool withReturn) override
+        {
+            auto position = _buffer.GetCursor().GetPosition();
+            _buffer.GetRowByOffset(position.y).SetWrapForced(false);
+            _cursorDown({ withReturn ? 0 : position.x, position.y + 1 });
+        }
+
+        void SetWindowTitle(const std::wstring_view) override {}
+        void UseAlternateScreenBuffer() override {}
+        void UseMainScreenBuffer() override {}
+        CursorType GetUserDefaultCursorStyle() const override { return CursorType::Legacy; }
+        void ShowWindow(bool) override {}
+        void SetConsoleOutputCP(const unsigned int) override {}
+        unsigned int GetConsoleOutputCP() const override { return CP_UTF8; }
+        void EnableXtermBracketedPasteMode(const bool) override {}
+        void CopyToClipboard(const std::wstring_view) override {}
+        void SetTaskbarProgress(const DispatchTypes::TaskbarState, const size_t) override {}
+        void SetWorkingDirectory(const std::wstring_view) override {}
+        void PlayMidiNote(const int, const int, const std::chrono::microseconds) override {}
+        bool ResizeWindow(const til::CoordType, const til::CoordType) override { return false; }
+        bool IsConsolePty() const override { return false; }
+        void NotifyAccessibilityChange(const til::rect&) override {}
+        void AddMark(const DispatchTypes::ScrollMark&) override {}
+
+    private:
+        // Moves the cursor to `position`, which is at most 1 row below it. At the bottom margin the
+        // scrolling region is scrolled up instead, and at the bottom of the buffer it gets circled.
+        void _cursorDown(til::point position)
+        {
+            const auto bufferHeight = _buffer.GetSize().Height();
+
+            if (_margins.bottom > _margins.top && position.y - 1 == _viewportTop + _margins.bottom)
+            {
+                const auto top = _viewportTop + _margins.top;
+                const auto bottom = _viewportTop + _margins.bottom;
+                _buffer.ScrollRows(top + 1, bottom - top, -1);
+                _buffer.GetRowByOffset(bottom).Reset(_buffer.GetCurrentAttributes());
+                position.y = bottom;
+            }
+            else if (position.y >= bufferHeight)
+            {
+                _buffer.IncrementCircularBuffer();
+                position.y = bufferHeight - 1;
+            }
+            else if (position.y >= _viewportTop + viewportHeight)
+            {
+                _viewportTop = position.y - viewportHeight + 1;
+            }
+
+            _buffer.GetCursor().SetPosition(position);
+        }
+
+        HeadlessRenderData _renderData{ *this };
+        DummyRenderer _renderer{ &_renderData };
+        TextBuffer _buffer;
+        StateMachine* _machine = nullptr;
+        til::inclusive_rect _margins{};
+        til::CoordType _viewportTop = 0;
+        bool _discardText;
+    };
+
+    Viewport HeadlessRenderData::GetViewport() noexcept
+    {
+        return _terminal.GetView();
+    }
+
+    const TextBuffer& HeadlessRenderData::GetTextBuffer() const noexcept
+    {
+        return _terminal.GetBuffer();
+    }
+
+    til::point HeadlessRenderData::GetCursorPosition() const noexcept
+    {
+        return _terminal.GetBuffer().GetCursor().GetPosition();
+    }
+
+    // Wires up the terminal the same way Terminal::Create() does.
+    struct Pipeline
+    {
+        explicit Pipeline(const bool discardText) :
+            terminal{ discardText },
+            input{ [](std::deque<std::unique_ptr<IInputEvent>>&) {} },
+            machine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<AdaptDispatch>(terminal, terminal.GetRenderer(), terminal.GetRenderSettings(), input)) }
+        {
+            terminal.SetStateMachine(machine);
+        }
+
+        HeadlessTerminal terminal;
+        TerminalInput input;
+        StateMachine machine;
+    };
+
+    enum class Stage
+    {
+        Parse,
+        Dispatch,
+        Buffer,
+    };
+
+    constexpr std::array allStages{ Stage::Parse, Stage::Dispatch, Stage::Buffer };
+
+    std::string_view stageName(const Stage stage) noexcept
+    {
+        switch (stage)
+        {
+        case Stage::Parse:
+            return "parse";
+        case Stage::Dispatch:
+            return "dispatch";
+        case Stage::Buffer:
+            return "buffer";
+        default:
+            return "?";
+        }
+    }
+
+    struct Result
+    {
+        std::string label;
+        double nsPerChar;
+    };
+
+    // The log corpora only contain line feeds, which (without LNM) don't return the cursor to the first column.
+    std::wstring toCrLf(const std::wstring_view text)
+    {
+        std::wstring result;
+        result.reserve(text.size() + text.size() / 64);
+
+        for (const auto ch : text)
+        {
+            if (ch == L'\n')
+            {
+                result.push_back(L'\r');
+            }
+            result.push_back(ch);
+        }
+
+        return result;
+    }
+
+    // Colors every 4 characters with a different 24-bit foreground and background color, like `lolcat` does.
+    std::wstring generateTrueColor()
+    {
+        const auto text = toCrLf(GenerateCorpus(Corpus::Ascii, streamLength / 8));
+        std::mt19937 rng{ 1337 };
+        std::wstring result;
+        result.reserve(streamLength + 64);
+
+        for (size_t i = 0; i < text.size(); i += 4)
+        {
+            fmt::format_to(std::back_inserter(result), FMT_COMPILE(L"\x1b[38;2;{};{};{};48;2;{};{};{}m"), rng() & 0xff, rng() & 0xff, rng() & 0xff, rng() & 0xff, rng() & 0xff, rng() & 0xff);
+            result.append(std::wstring_view{ text }.substr(i, 4));
+        }
+
+        result.append(L"\x1b[m");
+        return result;
+    }
+
+    // Redraws a full screen TUI over and over, like `htop` or a text editor do:
+    // Every row is addressed with CUP, partially colored and erased to its end.
+    std::wstring generateTuiRedraw()
+    {
+        const auto text = GenerateCorpus(Corpus::Ascii, streamLength, false);
+        std::wstring result;
+        result.reserve(streamLength + 1024);
+
+        for (size_t i = 0, frame = 0; result.size() < streamLength; ++frame)
+        {
+            result.append(L"\x1b[?25l\x1b[H");
+            for (til::CoordType y = 1; y <= viewportHeight; ++y, i = (i + 100) % (text.size() - 100))
+            {
+                fmt::format_to(std::back_inserter(result), FMT_COMPILE(L"\x1b[{};1H\x1b[{}m{:>6}\x1b[m "), y, 31 + (frame + y) % 7, frame * y);
+                result.append(std::wstring_view{ text }.substr(i, 80 + (frame + y) % 20));
+                result.append(L"\x1b[K");
+            }
+            result.append(L"\x1b[?25h");
+        }
+
+        return result;
+    }
+
+    // Scrolls a log within a scrolling region, while a header and footer remain fixed,
+    // the way `apt` renders its progress bar or tmux its status line.
+    std::wstring generateScrollingRegion()
+    {
+        const auto text = GenerateCorpus(Corpus::Ascii, streamLength, false);
+        std::wstring result;
+        result.reserve(streamLength + 1024);
+
+        fmt::format_to(std::back_inserter(result), FMT_COMPILE(L"\x1b[2J\x1b[2;{}r\x1b[{};1H"), viewportHeight - 1, viewportHeight - 1);
+
+        for (size_t i = 0, line = 0; result.size() < streamLength; ++line, i = (i + 100) % (text.size() - 100))
+        {
+            result.append(std::wstring_view{ text }.substr(i, 40 + line % 60));
+            result.append(L"\r\n");
+
+            if (line % 10 == 0)
+            {
+                fmt::format_to(std::back_inserter(result), FMT_COMPILE(L"\x1b" L"7\x1b[1;1H\x1b[7mProgress: [{:<50}]\x1b[m\x1b[K\x1b[{};1HLine {}\x1b[K\x1b" L"8"), std::wstring(line / 10 % 50, L'#'), viewportHeight, line);
+            }
+        }
+
+        result.append(L"\x1b[r");
+        return result;
+    }
+
+    double measure(const Stage stage, const std::wstring_view stream)
+    {
+        if (stage == Stage::Parse)
+        {
+            StateMachine machine{ std::make_unique<NullEngine>() };
+            return Measure([&]() { machine.ProcessString(stream); });
+        }
+
+        Pipeline pipeline{ stage == Stage::Dispatch };
+        return Measure([&]() { pipeline.machine.ProcessString(stream); });
+    }
+
+    void benchmark(const std::string_view label, const std::wstring_view stream, std::vector<Result>& results)
+    {
+        for (const auto stage : allStages)
+        {
+            const auto stageLabel = fmt::format("{} {}", label, stageName(stage));
+            const auto duration = measure(stage, stream);
+            const auto nsPerChar = duration * 1e9 / static_cast<double>(stream.size());
+
+            ReportThroughput(stageLabel, stream.size() * sizeof(wchar_t), duration);
+            ReportValue(fmt::format("{} per char", stageLabel), nsPerChar, "ns");
+            results.push_back({ stageLabel, nsPerChar });
+        }
+    }
+
+    // Each line of the baseline file is a result label and its ns/char, separated by a tab.
+    void writeBaseline(const wchar_t* path, const std::vector<Result>& results)
+    {
+        std::string contents;
+        for (const auto& result : results)
+        {
+            fmt::format_to(std::back_inserter(contents), "{}\t{:.3f}\n", result.label, result.nsPerChar);
+        }
+
+        const wil::unique_hfile file{ CreateFileW(path, GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        DWORD written{};
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), contents.data(), gsl::narrow<DWORD>(contents.size()), &written, nullptr));
+        fmt::print("  created the baseline from {} results\n", results.size());
+    }
+
+    void checkBaseline(const wchar_t* path, const std::vector<Result>& results)
+    {
+        const auto contents = LoadFile(path);
+        std::unordered_map<std::string_view, double> baseline;
+
+        for (size_t beg = 0; beg < contents.size();)
+        {
+            const auto end = std::min(contents.find('\n', beg), contents.size());
+            const auto line = std::string_view{ contents }.substr(beg, end - beg);
+            const auto tab = line.find('\t');
+            beg = end + 1;
+
+            if (tab != std::string_view::npos)
+            {
+                // strtod() stops at the "\r" of files that were checked out with CRLF line endings.
+                baseline.emplace(line.substr(0, tab), std::strtod(std::string{ line.substr(tab + 1) }.c_str(), nullptr));
+            }
+        }
+
+        size_t regressions = 0;
+        for (const auto& result : results)
+        {
+            const auto it = baseline.find(result.label);
+            if (it != baseline.end() && result.nsPerChar > it->second * regressionTolerance)
+            {
+                fmt::print("  regression: {} takes {:.2f} ns/char, baseline is {:.2f} ns/char\n", result.label, result.nsPerChar, it->second);
+                ++regressions;
+            }
+        }
+
+        THROW_HR_IF(E_FAIL, regressions != 0);
+    }
+
+    void benchmarkVtPipeline()
+    {
+        std::vector<Result> results;
+
+        benchmark("ASCII flood", toCrLf(GenerateCorpus(Corpus::Ascii, streamLength)), results);
+        benchmark("SGR true color", generateTrueColor(), results);
+        benchmark("TUI redraw", generateTuiRedraw(), results);
+        benchmark("CJK log", toCrLf(GenerateCorpus(Corpus::Cjk, streamLength)), results);
+        benchmark("Emoji log", toCrLf(GenerateCorpus(Corpus::Emoji, streamLength)), results);
+        benchmark("scrolling region", generateScrollingRegion(), results);
+
+        std::array<wchar_t, MAX_PATH> path{};
+        if (GetEnvironmentVariableW(L"CONSOLEBENCH_VT_CAPTURE", path.data(), gsl::narrow_cast<DWORD>(path.size())) != 0)
+        {
+            benchmark("capture", til::u8u16(LoadFile(path.data())), results);
+        }
+
+        if (GetEnvironmentVariableW(L"CONSOLEBENCH_VT_BASELINE", path.data(), gsl::narrow_cast<DWORD>(path.size())) != 0)
+        {
+            if (GetFileAttributesW(path.data()) == INVALID_FILE_ATTRIBUTES)
+            {
+                writeBaseline(path.data(), results);
+            }
+            else
+            {
+                checkBaseline(path.data(), results);
+            }
+        }
+    }
+
+    const Registration registration{ "Vt/Pipeline", &benchmarkVtPipeline };
+}
@@ -0,0 +1,83 @@
+// TEST TOOL ConsoleBench
+// Measures WriteConsoleW through the public API of the console this benchmark runs in, the way legacy
+// applications like build tools and loggers use it: Processed output without VT processing, wrapping at EOL.
+// It writes into an inactive screen buffer, so the numbers reflect WriteCharsLegacy and the TextBuffer,
+// not rendering. Run it in the conhost build you want to measure (for instance with and without a change to _stream.cpp).
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+using namespace ConsoleBench;
+
+namespace
+{
+    constexpr size_t corpusLength = 4 * 1024 * 1024;
+    // The C runtime and most loggers flush their output buffer in pieces about this large.
+    constexpr size_t writeSize = 4 * 1024;
+
+    // Turns the line feeds of the corpus into CRLF pairs, which is what Windows applications print.
+    // If `tabs` is set, each line is additionally indented with a tab, like the nested output of MSBuild.
+    std::wstring toBuildLog(const std::wstring_view text, const bool tabs)
+    {
+        std::wstring log;
+        log.reserve(text.size() + text.size() / 32);
+
+        for (const auto wch : text)
+        {
+            if (wch == L'\n')
+            {
+                log.append(tabs ? L"\r\n\t" : L"\r\n");
+            }
+            else
+            {
+                log.push_back(wch);
+            }
+        }
+
+        return log;
+    }
+
+    void writeAll(const HANDLE output, const std::wstring_view text)
+    {
+        for (size_t i = 0; i < text.size(); i += writeSize)
+        {
+            const auto count = gsl::narrow_cast<DWORD>(std::min(writeSize, text.size() - i));
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteConsoleW(output, text.data() + i, count, &written, nullptr));
+        }
+    }
+
+    void benchmark(const HANDLE output, const std::string_view label, const std::wstring_view text)
+    {
+        const auto duration = Measure([&]() { writeAll(output, text); });
+        ReportThroughput(label, text.size() * sizeof(wchar_t), duration);
+        ReportValue(fmt::format("{} chars/s", label), static_cast<double>(text.size()) / duration / 1e6, "M");
+    }
+
+    void benchmarkWriteConsole()
+    {
+        DWORD mode = 0;
+        if (!GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode))
+        {
+            fmt::print("  skipped: stdout isn't a console\n");
+            return;
+        }
+
+        const wil::unique_hfile output{ CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, CONSOLE_TEXTMODE_BUFFER, nullptr) };
+        THROW_LAST_ERROR_IF(!output || output.get() == INVALID_HANDLE_VALUE);
+        THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(output.get(), ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT));
+
+        const auto ascii = GenerateCorpus(Corpus::Ascii, corpusLength);
+        benchmark(output.get(), "4 MB build log", toBuildLog(ascii, false));
+        benchmark(output.get(), "4 MB indented build log", toBuildLog(ascii, true));
+
+        // These don't take the printable ASCII fast path and show the cost of the per-character path.
+        for (const auto corpus : { Corpus::Cjk, Corpus::Emoji })
+        {
+            const auto text = toBuildLog(GenerateCorpus(corpus, corpusLength), false);
+            benchmark(output.get(), fmt::format("4 MB {} log", CorpusName(corpus)), text);
+        }
+    }
+
+    const Registration registration{ "Output/WriteConsole", &benchmarkWriteConsole };
+}
@@ -0,0 +1,43 @@
+// TEST TOOL ConsoleBench
+// Micro-benchmarks for the console and terminal core (TextBuffer, parser, renderer, ...).
+// Usage: ConsoleBench.exe [filter]
+// Runs all benchmarks whose name contains `filter` (or all of them if none is given).
+// Exits with 1 if a benchmark failed, for instance because it regressed against its baseline.
+
+#include "precomp.h"
+#include "ConsoleBench.hpp"
+
+int main(int argc, char* argv[])
+{
+    const std::string_view filter = argc > 1 ? argv[1] : "";
+    size_t count = 0;
+    size_t failures = 0;
+
+    for (const auto& benchmark : ConsoleBench::GetBenchmarks())
+    {
+        if (benchmark.name.find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        fmt::print("{}\n", benchmark.name);
+        try
+        {
+            benchmark.func();
+        }
+        catch (...)
+        {
+            fmt::print("  failed with {:#010x}\n", static_cast<uint32_t>(wil::ResultFromCaughtException()));
+            ++failures;
+        }
+        ++count;
+    }
+
+    if (!count)
+    {
+        fmt::print("no benchmark matches \"{}\"\n", filter);
+        return 1;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -14,11 +14,6 @@ namespace
         CodepointWidth width;
     };
 
-    static bool operator<(const UnicodeRange& range, const unsigned int searchTerm) noexcept
-    {
-        return range.upperBound < searchTerm;
-    }
-
     // Generated by Generate-CodepointWidthsFromUCD.ps1 -Pack:True -Full:False -NoOverrides:False
     // on 9/14/2022 7:12:26 PM (UTC) from Unicode 15.0.0.
     // 321281 (0x4E701) codepoints covered.
@@ -326,12 +321,144 @@ namespace
         UnicodeRange{ 0xf0000, 0xffffd, CodepointWidth::Ambiguous },
         UnicodeRange{ 0x100000, 0x10fffd, CodepointWidth::Ambiguous },
     };
+
+    // s_wideAndAmbiguousTable is turned into a two-level lookup table at compile time,
+    // so that the width of a codepoint can be looked up in O(1) instead of binary searching it:
+    // * blocks maps each block of 256 codepoints to one of the packed widths blocks below.
+    // * widths contains the widths of the codepoints in a block with 2 bits per codepoint.
+    //   The first 3 are uniformly Narrow, Wide and Ambiguous, so that the block index of a uniform block
+    //   is its CodepointWidth. The others are only generated for blocks that contain more than one width.
+    constexpr unsigned int s_widthBlockShift = 8;
+    constexpr unsigned int s_widthBlockSize = 1u << s_widthBlockShift;
+    constexpr unsigned int s_widthBlockCount = 0x110000 >> s_widthBlockShift;
+    constexpr size_t s_uniformWidthBlockCount = 3;
+
+    // Returns the width that all codepoints in the given block share, or CodepointWidth::Invalid if they differ.
+    // Blocks must be visited in order: range is the index of the first range in
+    // s_wideAndAmbiguousTable that doesn't end before the block and is advanced accordingly.
+    constexpr CodepointWidth uniformBlockWidth(const unsigned int block, size_t& range) noexcept
+    {
+        const auto beg = block << s_widthBlockShift;
+        const auto last = beg + s_widthBlockSize - 1;
+
+        while (range < s_wideAndAmbiguousTable.size() && til::at(s_wideAndAmbiguousTable, range).upperBound < beg)
+        {
+            ++range;
+        }
+
+        if (range == s_wideAndAmbiguousTable.size() || til::at(s_wideAndAmbiguousTable, range).lowerBound > last)
+        {
+            return CodepointWidth::Narrow;
+        }
+
+        const auto& r = til::at(s_wideAndAmbiguousTable, range);
+        return r.lowerBound <= beg && r.upperBound >= last ? r.width : CodepointWidth::Invalid;
+    }
+
+    constexpr size_t countMixedWidthBlocks() noexcept
+    {
+        size_t count = 0;
+        size_t range = 0;
+        for (unsigned int block = 0; block < s_widthBlockCount; ++block)
+        {
+            count += uniformBlockWidth(block, range) == CodepointWidth::Invalid;
+        }
+        return count;
+    }
+
+    constexpr auto s_widthBlockTotal = s_uniformWidthBlockCount + countMixedWidthBlocks();
+    static_assert(s_widthBlockTotal <= 256, "the block indices must fit into a uint8_t");
+
+    struct WidthTable
+    {
+        std::array<uint8_t, s_widthBlockCount> blocks{};
+        std::array<std::array<uint8_t, s_widthBlockSize / 4>, s_widthBlockTotal> widths{};
+    };
+
+    constexpr WidthTable generateWidthTable() noexcept
+    {
+        WidthTable table;
+
+        for (auto& packed : til::at(table.widths, 1))
+        {
+            packed = 0b01'01'01'01;
+        }
+        for (auto& packed : til::at(table.widths, 2))
+        {
+            packed = 0b10'10'10'10;
+        }
+
+        size_t range = 0;
+        auto next = s_uniformWidthBlockCount;
+
+        for (unsigned int block = 0; block < s_widthBlockCount; ++block)
+        {
+            const auto width = uniformBlockWidth(block, range);
+            if (width != CodepointWidth::Invalid)
+            {
+                til::at(table.blocks, block) = static_cast<uint8_t>(width);
+                continue;
+            }
+
+            til::at(table.blocks, block) = static_cast<uint8_t>(next);
+            auto& packed = til::at(table.widths, next++);
+
+            const auto beg = block << s_widthBlockShift;
+            const auto last = beg + s_widthBlockSize - 1;
+
+            // Narrow is 0, so we only need to set the bits of the codepoints in the table.
+            for (auto i = range; i < s_wideAndAmbiguousTable.size() && til::at(s_wideAndAmbiguousTable, i).lowerBound <= last; ++i)
+            {
+                const auto& r = til::at(s_wideAndAmbiguousTable, i);
+                for (auto codepoint = std::max(r.lowerBound, beg), end = std::min(r.upperBound, last); codepoint <= end; ++codepoint)
+                {
+                    const auto offset = codepoint - beg;
+                    til::at(packed, offset / 4) |= static_cast<uint8_t>(static_cast<unsigned int>(r.width) << (offset % 4 * 2));
+                }
+            }
+        }
+
+        return table;
+    }
+
+    constexpr auto s_widthTable = generateWidthTable();
+
+    constexpr CodepointWidth lookupWidth(const unsigned int codepoint) noexcept
+    {
+        if (codepoint >= 0x110000)
+        {
+            return CodepointWidth::Narrow;
+        }
+
+        const auto block = til::at(s_widthTable.blocks, codepoint >> s_widthBlockShift);
+        const auto offset = codepoint & (s_widthBlockSize - 1);
+        const auto packed = til::at(til::at(s_widthTable.widths, block), offset / 4);
+        return static_cast<CodepointWidth>((packed >> (offset % 4 * 2)) & 0b11);
+    }
+
+    // Checks the lookup table against the bounds of every range in s_wideAndAmbiguousTable and the gaps between them.
+    constexpr bool verifyWidthTable() noexcept
+    {
+        unsigned int previousEnd = 0;
+        for (const auto& r : s_wideAndAmbiguousTable)
+        {
+            if ((r.lowerBound > previousEnd && lookupWidth(r.lowerBound - 1) != CodepointWidth::Narrow) ||
+                lookupWidth(r.lowerBound) != r.width ||
+                lookupWidth(r.upperBound) != r.width)
+            {
+                return false;
+            }
+            previousEnd = r.upperBound + 1;
+        }
+        return lookupWidth(previousEnd) == CodepointWidth::Narrow;
+    }
+
+    static_assert(verifyWidthTable());
 }
 
 // Routine Description:
 // - Constructs an instance of the CodepointWidthDetector class
 CodepointWidthDetector::CodepointWidthDetector() noexcept :
-    _fallbackCache{},
     _pfnFallbackMethod{}
 {
 }
@@ -409,7 +536,7 @@ bool CodepointWidthDetector::IsWide(const std::wstring_view glyph) const
 }
 
 // Routine Description:
-// - returns the width type of codepoint by searching the map generated from the unicode spec
+// - returns the width type of codepoint by looking it up in the table generated from the unicode spec
 // Arguments:
 // - glyph - the utf16 encoded codepoint to search for
 // Return Value:
@@ -421,17 +548,7 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view
         return CodepointWidth::Invalid;
     }
 
-    const auto codepoint = _extractCodepoint(glyph);
-    const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
-
-    // For characters that are not _in_ the table, lower_bound will return the nearest item that is.
-    // We must check its bounds to make sure that our hit was a true hit.
-    if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
-    {
-        return it->width;
-    }
-
-    return CodepointWidth::Narrow;
+    return lookupWidth(_extractCodepoint(glyph));
 }
 
 // Routine Description:
@@ -476,25 +593,31 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidthWithCache(const std::wst
 // - Checks the fallback function but caches the results until the font changes
 //   because the lookup function is usually very expensive and will return the same results
 //   for the same inputs.
+// - The cache is a direct-mapped table of atomics, which can be read and updated by any thread
+//   without locking. Each entry stores the codepoint, the font generation it was computed for
+//   and the result, so NotifyFontChanged() invalidates all entries by bumping the generation.
 // Arguments:
 // - glyph - the utf16 encoded codepoint to check width of
 // - true if codepoint is wide or false if it is narrow
 bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyph) const
 {
-    const std::wstring findMe{ glyph };
+    const auto codepoint = _extractCodepoint(glyph);
+    const auto generation = _fontGeneration.load(std::memory_order_relaxed);
 
-    // TODO: Cache needs to be emptied when font changes.
-    const auto it = _fallbackCache.find(findMe);
-    if (it == _fallbackCache.end())
-    {
-        auto result = _pfnFallbackMethod(glyph);
-        _fallbackCache.insert_or_assign(findMe, result);
-        return result;
-    }
-    else
+    // Entry layout: generation in the upper 32 bits, the codepoint in bits 2-22,
+    // the result in bit 1 and bit 0 marks the entry as valid.
+    const auto key = static_cast<uint64_t>(generation) << 32 | static_cast<uint64_t>(codepoint) << 2 | 1;
+    auto& entry = til::at(_fallbackCache, codepoint & (FallbackCacheSize - 1));
+
+    const auto cached = entry.load(std::memory_order_relaxed);
+    if ((cached & ~uint64_t{ 0b10 }) == key)
     {
-        return it->second;
+        return (cached & 0b10) != 0;
     }
+
+    const auto result = _pfnFallbackMethod(glyph);
+    entry.store(key | (result ? 0b10 : 0), std::memory_order_relaxed);
+    return result;
 }
 
 // Routine Description:
@@ -547,5 +670,5 @@ void CodepointWidthDetector::SetFallbackMethod(std::function<bool(const std::wst
 // - <none>
 void CodepointWidthDetector::NotifyFontChanged() const noexcept
 {
-    _fallbackCache.clear();
+    _fontGeneration.fetch_add(1, std::memory_order_relaxed);
 }
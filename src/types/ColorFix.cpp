@@ -204,7 +204,55 @@ void ColorFix::_ToRGB()
 COLORREF ColorFix::GetPerceivableColor(COLORREF fg, COLORREF bg)
 {
     const ColorFix backLab(bg);
-    ColorFix frontLab(fg);
+    return _GetPerceivableColor(ColorFix{ fg }, backLab);
+}
+
+// Method Description:
+// - Same as GetPerceivableColor(), but for an entire list of color pairs, like the attribute runs of a row.
+// - Consecutive pairs tend to share their background color (and often their foreground color as well),
+//   so the Lab conversion of a background is only done once per run of identical backgrounds
+//   and repeated pairs are resolved by reusing the previous result.
+// - Arguments:
+// - foregrounds: the foreground colors, which are replaced with their perceivable counterparts
+// - backgrounds: the background color for each foreground color
+void ColorFix::GetPerceivableColors(gsl::span<COLORREF> foregrounds, gsl::span<const COLORREF> backgrounds)
+{
+    const auto count = std::min(foregrounds.size(), backgrounds.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    ColorFix backLab(til::at(backgrounds, 0));
+    COLORREF prevFg = til::at(foregrounds, 0);
+    COLORREF prevResult = _GetPerceivableColor(ColorFix{ prevFg }, backLab);
+    til::at(foregrounds, 0) = prevResult;
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        const auto fg = til::at(foregrounds, i);
+        const auto bg = til::at(backgrounds, i);
+
+        if (bg != backLab.rgb)
+        {
+            backLab = ColorFix{ bg };
+        }
+        else if (fg == prevFg)
+        {
+            til::at(foregrounds, i) = prevResult;
+            continue;
+        }
+
+        prevFg = fg;
+        prevResult = _GetPerceivableColor(ColorFix{ fg }, backLab);
+        til::at(foregrounds, i) = prevResult;
+    }
+}
+
+// Method Description:
+// - The implementation of GetPerceivableColor() for colors that have already been converted to Lab.
+COLORREF ColorFix::_GetPerceivableColor(ColorFix frontLab, const ColorFix& backLab)
+{
     const auto de1 = _GetDeltaE(frontLab, backLab);
     if (de1 < gMinThreshold)
     {
@@ -14,6 +14,7 @@ Author:
 #pragma once
 
 #include "convert.hpp"
+#include <atomic>
 #include <functional>
 
 static_assert(sizeof(unsigned int) == sizeof(wchar_t) * 2,
@@ -46,6 +47,11 @@ private:
     bool _checkFallbackViaCache(const std::wstring_view glyph) const;
     static unsigned int _extractCodepoint(const std::wstring_view glyph) noexcept;
 
-    mutable std::unordered_map<std::wstring, bool> _fallbackCache;
+    // The number of entries in _fallbackCache. Must be a power of 2. See _checkFallbackViaCache().
+    static constexpr size_t FallbackCacheSize = 256;
+    static_assert((FallbackCacheSize & (FallbackCacheSize - 1)) == 0);
+
+    mutable std::array<std::atomic<uint64_t>, FallbackCacheSize> _fallbackCache{};
+    mutable std::atomic<uint32_t> _fontGeneration{ 0 };
     std::function<bool(std::wstring_view)> _pfnFallbackMethod;
 };
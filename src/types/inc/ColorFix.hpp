@@ -24,6 +24,7 @@ public:
     ColorFix(COLORREF color) noexcept;
 
     static COLORREF GetPerceivableColor(COLORREF fg, COLORREF bg);
+    static void GetPerceivableColors(gsl::span<COLORREF> foregrounds, gsl::span<const COLORREF> backgrounds);
 
 #pragma warning(push)
     // CL will complain about the both nameless and anonymous struct.
@@ -48,6 +49,7 @@ public:
 private:
     static float _GetHPrimeFn(float x, float y) noexcept;
     static float _GetDeltaE(ColorFix x1, ColorFix x2) noexcept;
+    static COLORREF _GetPerceivableColor(ColorFix frontLab, const ColorFix& backLab);
     void _ToLab() noexcept;
     void _ToRGB();
 };